@@ -0,0 +1,117 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  Several threads sort arrays at the same time, with random pivots,
+  so any contention for the pivot generator shows up as lost
+  throughput.
+
+  Usage: bench-contention [THREADS [NMEMB [REPETITIONS]]]
+*/
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <time.h>
+#include "quicksorts/unstable-quicksort.h"
+
+static size_t nmemb = 10000;
+static size_t repetitions = 200;
+
+static inline int
+int_lt (const void *px, const void *py)
+{
+  return (*(const int *) px < *(const int *) py);
+}
+
+static double
+wall_clock (void)
+{
+  struct timespec t;
+  clock_gettime (CLOCK_MONOTONIC, &t);
+  return t.tv_sec + (t.tv_nsec * 1e-9);
+}
+
+static void *
+sort_repeatedly (void *arg)
+{
+  unsigned int seed = (unsigned int) (size_t) arg;
+  int *p = malloc (nmemb * sizeof (int));
+  if (p == NULL)
+    {
+      fprintf (stderr, "out of memory\n");
+      exit (1);
+    }
+
+  for (size_t r = 0; r != repetitions; r += 1)
+    {
+      for (size_t i = 0; i != nmemb; i += 1)
+        p[i] = rand_r (&seed);
+
+      /* A small SMALL_SIZE, so there are many pivots to choose. */
+      UNSTABLE_QUICKSORT_7ARGS
+        (p, nmemb, sizeof (int), int_lt,
+         QUICKSORTS_COMMON__PIVOT_RANDOM,
+         8, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT);
+
+      for (size_t i = 1; i < nmemb; i += 1)
+        if (p[i] < p[i - 1])
+          {
+            fprintf (stderr, "array not sorted\n");
+            exit (1);
+          }
+    }
+
+  free (p);
+  return NULL;
+}
+
+int
+main (int argc, char *argv[])
+{
+  size_t nthreads = 4;
+  if (1 < argc)
+    nthreads = strtoul (argv[1], NULL, 10);
+  if (2 < argc)
+    nmemb = strtoul (argv[2], NULL, 10);
+  if (3 < argc)
+    repetitions = strtoul (argv[3], NULL, 10);
+  if (nthreads == 0)
+    nthreads = 1;
+
+  pthread_t *threads = malloc (nthreads * sizeof (pthread_t));
+  const double t1 = wall_clock ();
+  for (size_t i = 0; i != nthreads; i += 1)
+    if (pthread_create (&threads[i], NULL, sort_repeatedly,
+                        (void *) (i + 1)) != 0)
+      {
+        fprintf (stderr, "pthread_create failed\n");
+        exit (1);
+      }
+  for (size_t i = 0; i != nthreads; i += 1)
+    pthread_join (threads[i], NULL);
+  const double t2 = wall_clock ();
+
+  const double sorts = (double) nthreads * (double) repetitions;
+  printf ("threads:%zu  nmemb:%zu  sorts:%.0f  seconds:%.3f  "
+          "sorts/second:%.1f\n",
+          nthreads, nmemb, sorts, t2 - t1, sorts / (t2 - t1));
+
+  free (threads);
+  return 0;
+}
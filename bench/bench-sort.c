@@ -0,0 +1,650 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  Timings of the sorts over many distributions of keys and sizes of
+  element, with warm-up runs and repetitions. Each case is reported
+  as the median and the 10th and 90th percentiles of the time per
+  element, in nanoseconds, and may be written as CSV or JSON.
+
+  Given a baseline (the CSV of an earlier run), cases whose median
+  has grown by more than the tolerance are flagged, and the exit
+  status is 1.
+
+  Each element starts with a 32-bit unsigned key; the rest of it is
+  payload that must travel with the key.
+
+  Run with --help for the options.
+*/
+
+#include <errno.h>
+#include <getopt.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "quicksorts/unstable-qsort.h"
+#include "quicksorts/stable-qsort.h"
+#include "quicksorts/unstable-quicksort.h"
+
+static inline uint32_t
+key_of (const void *p)
+{
+  uint32_t k;
+  memcpy (&k, p, sizeof k);
+  return k;
+}
+
+static inline bool
+key_lt (const void *p, const void *q)
+{
+  return key_of (p) < key_of (q);
+}
+
+static int
+key_cmp (const void *p, const void *q)
+{
+  const uint32_t x = key_of (p);
+  const uint32_t y = key_of (q);
+  return (x < y) ? -1 : ((y < x) ? 1 : 0);
+}
+
+static double
+wall_clock (void)
+{
+  struct timespec t;
+  clock_gettime (CLOCK_MONOTONIC, &t);
+  return t.tv_sec + (t.tv_nsec * 1e-9);
+}
+
+/*------------------------------------------------------------------*/
+/* Engines.                                                         */
+
+typedef void engine_t (void *base, size_t nmemb, size_t size);
+
+static void
+engine_qsort (void *base, size_t nmemb, size_t size)
+{
+  qsort (base, nmemb, size, key_cmp);
+}
+
+static void
+engine_unstable_qsort (void *base, size_t nmemb, size_t size)
+{
+  unstable_qsort (base, nmemb, size, key_cmp);
+}
+
+static void
+engine_stable_qsort (void *base, size_t nmemb, size_t size)
+{
+  stable_qsort (base, nmemb, size, key_cmp);
+}
+
+static void
+engine_pdqsort (void *base, size_t nmemb, size_t size)
+{
+  UNSTABLE_PDQSORT (base, nmemb, size, key_lt);
+}
+
+#define DEFINE_ENGINE(NAME, PIVOT_SELECTION, SMALL_SIZE, SMALL_SORT)   \
+  static void                                                           \
+  engine_##NAME (void *base, size_t nmemb, size_t size)                 \
+  {                                                                     \
+    UNSTABLE_QUICKSORT_8ARGS                                            \
+      (base, nmemb, size, key_lt, PIVOT_SELECTION, SMALL_SIZE,          \
+       SMALL_SORT, UNSTABLE_QUICKSORT__DEFAULT__PARTITION);             \
+  }
+
+#define DEFINE_ENGINES(PIVOT, PIVOT_SELECTION)                          \
+  DEFINE_ENGINE (PIVOT##_insertion, PIVOT_SELECTION, 80,                \
+                 QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT)        \
+  DEFINE_ENGINE (PIVOT##_shell, PIVOT_SELECTION, 80,                    \
+                 QUICKSORTS__UNSTABLE_QUICKSORT__SHELL_SORT)            \
+  DEFINE_ENGINE (PIVOT##_network, PIVOT_SELECTION, 16,                  \
+                 QUICKSORTS__UNSTABLE_QUICKSORT__NETWORK_SORT)
+
+DEFINE_ENGINES (random, QUICKSORTS_COMMON__PIVOT_RANDOM)
+DEFINE_ENGINES (middle, QUICKSORTS_COMMON__PIVOT_MIDDLE)
+DEFINE_ENGINES (median3, QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE)
+DEFINE_ENGINES (adaptive, QUICKSORTS_COMMON__PIVOT_ADAPTIVE)
+
+#define ENGINES(PIVOT)                                          \
+  { #PIVOT "-insertion", engine_##PIVOT##_insertion },          \
+  { #PIVOT "-shell", engine_##PIVOT##_shell },                  \
+  { #PIVOT "-network", engine_##PIVOT##_network }
+
+static const struct
+{
+  const char *name;
+  engine_t *sort;
+} engines[] = {
+  { "qsort", engine_qsort },
+  { "unstable_qsort", engine_unstable_qsort },
+  { "stable_qsort", engine_stable_qsort },
+  { "pdqsort", engine_pdqsort },
+  ENGINES (random),
+  ENGINES (middle),
+  ENGINES (median3),
+  ENGINES (adaptive)
+};
+
+enum { N_ENGINES = sizeof engines / sizeof engines[0] };
+
+/*------------------------------------------------------------------*/
+/* Distributions of keys.                                           */
+
+static uint32_t
+random_key (void)
+{
+  return (uint32_t) mrand48 ();
+}
+
+/* Zipf-distributed ranks, with exponent 1, over this many values. */
+enum { ZIPF_VALUES = 10000 };
+
+static uint32_t
+zipf_key (const double *cumulative)
+{
+  const double u = drand48 () * cumulative[ZIPF_VALUES - 1];
+  size_t lo = 0;
+  size_t hi = ZIPF_VALUES - 1;
+  while (lo < hi)
+    {
+      const size_t mid = lo + ((hi - lo) / 2);
+      if (cumulative[mid] < u)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+  return (uint32_t) lo;
+}
+
+static void
+make_keys (uint32_t *keys, size_t n, const char *distribution)
+{
+  if (strcmp (distribution, "random") == 0)
+    for (size_t i = 0; i != n; i += 1)
+      keys[i] = random_key ();
+  else if (strcmp (distribution, "sorted") == 0)
+    for (size_t i = 0; i != n; i += 1)
+      keys[i] = (uint32_t) i;
+  else if (strcmp (distribution, "reverse") == 0)
+    for (size_t i = 0; i != n; i += 1)
+      keys[i] = (uint32_t) (n - i);
+  else if (strcmp (distribution, "organ-pipe") == 0)
+    for (size_t i = 0; i != n; i += 1)
+      keys[i] = (uint32_t) ((i < n / 2) ? i : n - i);
+  else if (strcmp (distribution, "sawtooth") == 0)
+    {
+      const size_t tooth = (n / 32) + 1;
+      for (size_t i = 0; i != n; i += 1)
+        keys[i] = (uint32_t) (i % tooth);
+    }
+  else if (strcmp (distribution, "zipf") == 0)
+    {
+      double *cumulative = malloc (ZIPF_VALUES * sizeof (double));
+      double sum = 0;
+      for (size_t i = 0; i != ZIPF_VALUES; i += 1)
+        {
+          sum += 1.0 / (double) (i + 1);
+          cumulative[i] = sum;
+        }
+      for (size_t i = 0; i != n; i += 1)
+        keys[i] = zipf_key (cumulative);
+      free (cumulative);
+    }
+  else if (strcmp (distribution, "few-unique") == 0)
+    for (size_t i = 0; i != n; i += 1)
+      keys[i] = random_key () % 16;
+  else if (strcmp (distribution, "sorted-noise") == 0)
+    {
+      /* Sorted, with one key in a hundred replaced at random. */
+      for (size_t i = 0; i != n; i += 1)
+        keys[i] = (uint32_t) i;
+      for (size_t j = 0; j != n / 100; j += 1)
+        keys[(size_t) lrand48 () % n] = random_key () % (uint32_t) n;
+    }
+  else
+    {
+      fprintf (stderr, "bench-sort: unknown distribution: %s\n",
+               distribution);
+      exit (1);
+    }
+}
+
+static const char *const distributions[] = {
+  "random", "sorted", "reverse", "organ-pipe", "sawtooth", "zipf",
+  "few-unique", "sorted-noise"
+};
+
+enum { N_DISTRIBUTIONS = sizeof distributions / sizeof distributions[0] };
+
+/*------------------------------------------------------------------*/
+/* Results.                                                         */
+
+typedef struct
+{
+  const char *engine;
+  const char *distribution;
+  size_t size;
+  size_t nmemb;
+  double median;
+  double p10;
+  double p90;
+} result_t;
+
+typedef struct
+{
+  char engine[64];
+  char distribution[64];
+  size_t size;
+  size_t nmemb;
+  double median;
+} baseline_t;
+
+static int
+double_cmp (const void *p, const void *q)
+{
+  const double x = *(const double *) p;
+  const double y = *(const double *) q;
+  return (x < y) ? -1 : ((y < x) ? 1 : 0);
+}
+
+/* The value at fraction f of the way through a sorted array, by
+   linear interpolation. */
+static double
+percentile (const double *sorted, size_t n, double f)
+{
+  const double x = f * (double) (n - 1);
+  const size_t i = (size_t) x;
+  if (n - 1 <= i)
+    return sorted[n - 1];
+  return sorted[i] + ((x - (double) i) * (sorted[i + 1] - sorted[i]));
+}
+
+static baseline_t *
+read_baseline (const char *path, size_t *n)
+{
+  FILE *f = fopen (path, "r");
+  if (f == NULL)
+    {
+      perror (path);
+      exit (1);
+    }
+  size_t allocated = 64;
+  baseline_t *b = malloc (allocated * sizeof (baseline_t));
+  *n = 0;
+  char line[512];
+  while (fgets (line, sizeof line, f) != NULL)
+    {
+      if (*n == allocated)
+        {
+          allocated *= 2;
+          b = realloc (b, allocated * sizeof (baseline_t));
+        }
+      baseline_t *e = &b[*n];
+      if (sscanf (line, "%63[^,],%63[^,],%zu,%zu,%lf",
+                  e->engine, e->distribution, &e->size, &e->nmemb,
+                  &e->median) == 5)
+        *n += 1;                /* The header does not scan. */
+    }
+  fclose (f);
+  return b;
+}
+
+static void
+write_csv (const char *path, const result_t *r, size_t n)
+{
+  FILE *f = fopen (path, "w");
+  if (f == NULL)
+    {
+      perror (path);
+      exit (1);
+    }
+  fprintf (f, "engine,distribution,size,nmemb,median_ns,p10_ns,p90_ns\n");
+  for (size_t i = 0; i != n; i += 1)
+    fprintf (f, "%s,%s,%zu,%zu,%.3f,%.3f,%.3f\n", r[i].engine,
+             r[i].distribution, r[i].size, r[i].nmemb, r[i].median,
+             r[i].p10, r[i].p90);
+  fclose (f);
+}
+
+static void
+write_json (const char *path, const result_t *r, size_t n)
+{
+  FILE *f = fopen (path, "w");
+  if (f == NULL)
+    {
+      perror (path);
+      exit (1);
+    }
+  fprintf (f, "[\n");
+  for (size_t i = 0; i != n; i += 1)
+    fprintf (f,
+             "  {\"engine\": \"%s\", \"distribution\": \"%s\", "
+             "\"size\": %zu, \"nmemb\": %zu, \"median_ns\": %.3f, "
+             "\"p10_ns\": %.3f, \"p90_ns\": %.3f}%s\n",
+             r[i].engine, r[i].distribution, r[i].size, r[i].nmemb,
+             r[i].median, r[i].p10, r[i].p90, (i + 1 == n) ? "" : ",");
+  fprintf (f, "]\n");
+  fclose (f);
+}
+
+/*------------------------------------------------------------------*/
+
+static bool
+listed (const char *list, const char *name)
+{
+  if (list == NULL)
+    return true;
+  const size_t len = strlen (name);
+  for (const char *p = list; *p != '\0';)
+    {
+      const char *comma = strchr (p, ',');
+      const size_t n = (comma == NULL) ? strlen (p) : (size_t) (comma - p);
+      if (n == len && strncmp (p, name, len) == 0)
+        return true;
+      p += n + (comma != NULL);
+    }
+  return false;
+}
+
+static void
+usage (FILE *f)
+{
+  fprintf (f,
+           "Usage: bench-sort [OPTION]...\n"
+           "\n"
+           "  -n, --nmemb=N           elements per array"
+           " (default 100000)\n"
+           "  -m, --max-bytes=N       fewer elements, if need be, to"
+           " keep arrays\n"
+           "                          within N bytes (default"
+           " 16777216)\n"
+           "  -s, --sizes=LIST        element sizes in bytes (default\n"
+           "                          4,8,16,64,256,1024,4096)\n"
+           "  -d, --distributions=LIST  (default all):\n"
+           "                          random sorted reverse organ-pipe"
+           " sawtooth\n"
+           "                          zipf few-unique sorted-noise\n"
+           "  -e, --engines=LIST      (default all): qsort"
+           " unstable_qsort\n"
+           "                          stable_qsort pdqsort, and"
+           " PIVOT-SMALL for\n"
+           "                          PIVOT random middle median3"
+           " adaptive and\n"
+           "                          SMALL insertion shell network\n"
+           "  -r, --repetitions=N     timed runs of each case"
+           " (default 11)\n"
+           "  -w, --warm-up=N         untimed runs first (default 2)\n"
+           "      --csv=FILE          write the results as CSV\n"
+           "      --json=FILE         write the results as JSON\n"
+           "  -b, --baseline=FILE     flag cases slower than in this"
+           " CSV\n"
+           "  -t, --tolerance=PERCENT  how much slower is a regression"
+           " (default 10)\n"
+           "  -h, --help              show this help\n");
+}
+
+static void
+invalid_option (const char *option, const char *value)
+{
+  fprintf (stderr, "bench-sort: invalid --%s: %s\n", option, value);
+  usage (stderr);
+  exit (1);
+}
+
+/* Parse a decimal count of at least LEAST, or fail as an invalid
+   OPTION. */
+static size_t
+parse_count (const char *s, const char *option, size_t least)
+{
+  char *end;
+  errno = 0;
+  const unsigned long long n = strtoull (s, &end, 10);
+  if (s[0] < '0' || '9' < s[0] || *end != '\0' || errno != 0
+      || SIZE_MAX < n || n < least)
+    invalid_option (option, s);
+  return (size_t) n;
+}
+
+int
+main (int argc, char *argv[])
+{
+  enum { OPT_CSV = 256, OPT_JSON };
+  static const struct option long_options[] = {
+    { "nmemb", required_argument, NULL, 'n' },
+    { "max-bytes", required_argument, NULL, 'm' },
+    { "sizes", required_argument, NULL, 's' },
+    { "distributions", required_argument, NULL, 'd' },
+    { "engines", required_argument, NULL, 'e' },
+    { "repetitions", required_argument, NULL, 'r' },
+    { "warm-up", required_argument, NULL, 'w' },
+    { "csv", required_argument, NULL, OPT_CSV },
+    { "json", required_argument, NULL, OPT_JSON },
+    { "baseline", required_argument, NULL, 'b' },
+    { "tolerance", required_argument, NULL, 't' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, NULL, 0 }
+  };
+
+  size_t nmemb = 100000;
+  size_t max_bytes = (size_t) 1 << 24;
+  const char *sizes = "4,8,16,64,256,1024,4096";
+  const char *distribution_list = NULL;
+  const char *engine_list = NULL;
+  size_t repetitions = 11;
+  size_t warm_up = 2;
+  const char *csv = NULL;
+  const char *json = NULL;
+  const char *baseline_path = NULL;
+  double tolerance = 10;
+
+  int c;
+  while ((c = getopt_long (argc, argv, "n:m:s:d:e:r:w:b:t:h",
+                           long_options, NULL)) != -1)
+    switch (c)
+      {
+      case 'n':
+        nmemb = parse_count (optarg, "nmemb", 1);
+        break;
+      case 'm':
+        max_bytes = parse_count (optarg, "max-bytes", 1);
+        break;
+      case 's':
+        sizes = optarg;
+        break;
+      case 'd':
+        distribution_list = optarg;
+        break;
+      case 'e':
+        engine_list = optarg;
+        break;
+      case 'r':
+        repetitions = parse_count (optarg, "repetitions", 1);
+        break;
+      case 'w':
+        warm_up = parse_count (optarg, "warm-up", 0);
+        break;
+      case OPT_CSV:
+        csv = optarg;
+        break;
+      case OPT_JSON:
+        json = optarg;
+        break;
+      case 'b':
+        baseline_path = optarg;
+        break;
+      case 't':
+        {
+          char *end;
+          errno = 0;
+          tolerance = strtod (optarg, &end);
+          if (end == optarg || *end != '\0' || errno != 0
+              || !isfinite (tolerance) || tolerance < 0)
+            invalid_option ("tolerance", optarg);
+        }
+        break;
+      case 'h':
+        usage (stdout);
+        return 0;
+      default:
+        usage (stderr);
+        return 1;
+      }
+
+  /* The sizes must be a comma-separated list of numbers. */
+  for (const char *p = sizes; *p != '\0';)
+    {
+      char *end;
+      errno = 0;
+      (void) strtoul (p, &end, 10);
+      if (p[0] < '0' || '9' < p[0] || (*end != ',' && *end != '\0')
+          || errno != 0)
+        invalid_option ("sizes", sizes);
+      p = (*end == ',') ? end + 1 : end;
+    }
+
+  size_t n_baseline = 0;
+  baseline_t *baseline = (baseline_path == NULL) ? NULL :
+    read_baseline (baseline_path, &n_baseline);
+
+  size_t allocated = 64;
+  size_t n_results = 0;
+  result_t *results = malloc (allocated * sizeof (result_t));
+  double *times = malloc (repetitions * sizeof (double));
+  int regressions = 0;
+
+  printf ("%-20s %-13s %5s %8s %10s %10s %10s\n", "engine",
+          "distribution", "size", "nmemb", "median", "p10", "p90");
+
+  for (const char *p = sizes; *p != '\0';)
+    {
+      char *end;
+      size_t size = strtoul (p, &end, 10);
+      p = (*end == ',') ? end + 1 : end;
+      if (size < sizeof (uint32_t))
+        size = sizeof (uint32_t);
+      size_t n = nmemb;
+      if (max_bytes / size < n)
+        n = max_bytes / size;
+      if (n == 0)
+        continue;
+
+      char *pristine = malloc (n * size);
+      char *work = malloc (n * size);
+      uint32_t *keys = malloc (n * sizeof (uint32_t));
+
+      for (size_t d = 0; d != N_DISTRIBUTIONS; d += 1)
+        {
+          if (!listed (distribution_list, distributions[d]))
+            continue;
+          srand48 (12345);
+          make_keys (keys, n, distributions[d]);
+          for (size_t i = 0; i != n; i += 1)
+            {
+              char *elem = pristine + (i * size);
+              memset (elem, (int) (i & 0xFF), size);
+              memcpy (elem, &keys[i], sizeof (uint32_t));
+            }
+
+          for (size_t e = 0; e != N_ENGINES; e += 1)
+            {
+              if (!listed (engine_list, engines[e].name))
+                continue;
+              for (size_t r = 0; r != warm_up + repetitions; r += 1)
+                {
+                  memcpy (work, pristine, n * size);
+                  const double t1 = wall_clock ();
+                  engines[e].sort (work, n, size);
+                  const double t2 = wall_clock ();
+                  if (warm_up <= r)
+                    times[r - warm_up] = (t2 - t1) * 1e9 / (double) n;
+                  if (r == 0)
+                    for (size_t i = 1; i < n; i += 1)
+                      if (key_lt (work + (i * size),
+                                  work + ((i - 1) * size)))
+                        {
+                          fprintf (stderr, "bench-sort: %s did not sort\n",
+                                   engines[e].name);
+                          exit (1);
+                        }
+                }
+              qsort (times, repetitions, sizeof (double), double_cmp);
+
+              if (n_results == allocated)
+                {
+                  allocated *= 2;
+                  results = realloc (results, allocated * sizeof (result_t));
+                }
+              result_t *res = &results[n_results];
+              n_results += 1;
+              res->engine = engines[e].name;
+              res->distribution = distributions[d];
+              res->size = size;
+              res->nmemb = n;
+              res->median = percentile (times, repetitions, 0.5);
+              res->p10 = percentile (times, repetitions, 0.1);
+              res->p90 = percentile (times, repetitions, 0.9);
+
+              printf ("%-20s %-13s %5zu %8zu %10.3f %10.3f %10.3f",
+                      res->engine, res->distribution, res->size,
+                      res->nmemb, res->median, res->p10, res->p90);
+              for (size_t b = 0; b != n_baseline; b += 1)
+                if (strcmp (baseline[b].engine, res->engine) == 0
+                    && strcmp (baseline[b].distribution,
+                               res->distribution) == 0
+                    && baseline[b].size == res->size
+                    && baseline[b].nmemb == res->nmemb)
+                  {
+                    const double change =
+                      100 * (res->median - baseline[b].median)
+                      / baseline[b].median;
+                    printf ("  %+.1f%%", change);
+                    if (tolerance < change)
+                      {
+                        printf (" REGRESSION");
+                        regressions += 1;
+                      }
+                  }
+              printf ("\n");
+              fflush (stdout);
+            }
+        }
+
+      free (pristine);
+      free (work);
+      free (keys);
+    }
+
+  if (csv != NULL)
+    write_csv (csv, results, n_results);
+  if (json != NULL)
+    write_json (json, results, n_results);
+  if (regressions != 0)
+    printf ("%d regression%s of more than %g%%.\n", regressions,
+            (regressions == 1) ? "" : "s", tolerance);
+
+  free (results);
+  free (times);
+  free (baseline);
+  return (regressions == 0) ? 0 : 1;
+}
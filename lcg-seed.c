@@ -18,5 +18,27 @@
 
 #include "quicksorts/internal/quicksorts-common.h"
 
-quicksorts_common__spinlock_t quicksorts_common__seed_lock;
-uint64_t quicksorts_common__seed = UINT64_C (0x1234567891234567);
+atomic_uint_least64_t quicksorts_common__seed =
+  UINT64_C (0x1234567891234567);
+_Thread_local uint64_t quicksorts_common__thread_seed;
+_Thread_local bool quicksorts_common__thread_seeded = false;
+
+void
+quicksorts_common__seed_thread (void)
+{
+  /* Step the global seed by the golden-ratio increment, and scramble
+     the result with the SplitMix64 finalizer (Steele, Lea and Flood,
+     "Fast splittable pseudorandom number generators", OOPSLA 2014).
+     Threads thus start far apart in the LCG sequence, without any
+     lock. */
+  uint64_t z =
+    atomic_fetch_add_explicit (&quicksorts_common__seed,
+                               UINT64_C (0x9e3779b97f4a7c15),
+                               memory_order_relaxed);
+  z = (z ^ (z >> 30)) * UINT64_C (0xbf58476d1ce4e5b9);
+  z = (z ^ (z >> 27)) * UINT64_C (0x94d049bb133111eb);
+  z = z ^ (z >> 31);
+
+  quicksorts_common__thread_seed = z;
+  quicksorts_common__thread_seeded = true;
+}
@@ -0,0 +1,343 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#include <pthread.h>
+#include <sched.h>
+#include <stdatomic.h>
+#include <unistd.h>
+#include "quicksorts/unstable-qsort-parallel.h"
+
+/*------------------------------------------------------------------*/
+/* Task deques.                                                     */
+
+/* A task is a subarray, with what is left of its partitioning
+   budget. */
+typedef struct
+{
+  char *base;
+  size_t nmemb;
+  int depth;
+} task_t;
+
+/* A thread pushes the tasks it makes at the bottom of its own deque,
+   and pops from there too; other threads steal from the top. Every
+   task a thread pushes has a smaller depth than those already in its
+   deque, so the depth limit bounds the deque size. */
+#define DEQUE_SIZE (2 * CHAR_BIT * sizeof (size_t))
+
+typedef struct
+{
+  pthread_mutex_t lock;
+  size_t top;
+  size_t bottom;
+  task_t tasks[DEQUE_SIZE];
+} deque_t;
+
+static void
+deque_push (deque_t *dq, task_t task)
+{
+  pthread_mutex_lock (&dq->lock);
+  assert (dq->bottom - dq->top < DEQUE_SIZE);
+  dq->tasks[dq->bottom % DEQUE_SIZE] = task;
+  dq->bottom += 1;
+  pthread_mutex_unlock (&dq->lock);
+}
+
+static bool
+deque_pop_bottom (deque_t *dq, task_t *task)
+{
+  bool found = false;
+  pthread_mutex_lock (&dq->lock);
+  if (dq->top != dq->bottom)
+    {
+      dq->bottom -= 1;
+      *task = dq->tasks[dq->bottom % DEQUE_SIZE];
+      found = true;
+    }
+  pthread_mutex_unlock (&dq->lock);
+  return found;
+}
+
+static bool
+deque_pop_top (deque_t *dq, task_t *task)
+{
+  bool found = false;
+  pthread_mutex_lock (&dq->lock);
+  if (dq->top != dq->bottom)
+    {
+      *task = dq->tasks[dq->top % DEQUE_SIZE];
+      dq->top += 1;
+      found = true;
+    }
+  pthread_mutex_unlock (&dq->lock);
+  return found;
+}
+
+/*------------------------------------------------------------------*/
+/* The pool.                                                        */
+
+typedef struct
+{
+  const struct quicksorts__unstable_qsort_parallel__sorter *sorter;
+
+  /* How many threads, counting the caller, may work on the job. */
+  size_t nthreads;
+
+  /* Tasks pushed but not yet finished. The job is done when this
+     reaches zero. */
+  atomic_size_t outstanding;
+
+  /* Pool threads working on the job. Guarded by pool_lock. */
+  size_t active;
+} job_t;
+
+static pthread_mutex_t pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t pool_wake = PTHREAD_COND_INITIALIZER;
+static pthread_cond_t pool_idle = PTHREAD_COND_INITIALIZER;
+
+/* All of these are guarded by pool_lock. Deque 0 belongs to the
+   thread that started the job, and deque i + 1 to pool thread i. */
+static size_t threads_wanted = 0;
+static size_t n_workers = 0;
+static size_t n_deques = 0;
+static deque_t **deques = NULL;
+static job_t *current_job = NULL;
+static unsigned long generation = 0;
+
+static void
+run_task (job_t *job, size_t self, task_t task)
+{
+  const struct quicksorts__unstable_qsort_parallel__sorter *sorter =
+    job->sorter;
+
+  while (sorter->threshold <= task.nmemb && task.depth != 0)
+    {
+      size_t n_le;
+      size_t i_ge;
+      sorter->partition (sorter, task.base, task.nmemb, &n_le, &i_ge);
+      task.depth -= 1;
+
+      /* Leave the larger part for any thread that wants it, and go
+         on with the smaller. */
+      task_t other = task;
+      char *p_ge = task.base + (i_ge * sorter->elemsz);
+      const size_t n_ge = task.nmemb - i_ge;
+      if (n_le < n_ge)
+        {
+          other.base = p_ge;
+          other.nmemb = n_ge;
+          task.nmemb = n_le;
+        }
+      else
+        {
+          other.nmemb = n_le;
+          task.base = p_ge;
+          task.nmemb = n_ge;
+        }
+      if (2 <= other.nmemb)
+        {
+          atomic_fetch_add_explicit (&job->outstanding, 1,
+                                     memory_order_relaxed);
+          deque_push (deques[self], other);
+        }
+    }
+
+  if (2 <= task.nmemb)
+    sorter->sort (sorter, task.base, task.nmemb);
+
+  atomic_fetch_sub_explicit (&job->outstanding, 1, memory_order_release);
+}
+
+static void
+work (job_t *job, size_t self)
+{
+  for (;;)
+    {
+      task_t task;
+      bool found = deque_pop_bottom (deques[self], &task);
+      for (size_t k = 1; !found && k != job->nthreads; k += 1)
+        found = deque_pop_top (deques[(self + k) % job->nthreads], &task);
+
+      if (found)
+        run_task (job, self, task);
+      else if (atomic_load_explicit (&job->outstanding,
+                                     memory_order_acquire) == 0)
+        return;
+      else
+        sched_yield ();
+    }
+}
+
+static void *
+worker_main (void *arg)
+{
+  const size_t self = (size_t) (uintptr_t) arg;
+  unsigned long seen = 0;
+
+  pthread_mutex_lock (&pool_lock);
+  for (;;)
+    {
+      while (current_job == NULL || generation == seen)
+        pthread_cond_wait (&pool_wake, &pool_lock);
+      seen = generation;
+      job_t *job = current_job;
+      if (self < job->nthreads)
+        {
+          job->active += 1;
+          pthread_mutex_unlock (&pool_lock);
+          work (job, self);
+          pthread_mutex_lock (&pool_lock);
+          job->active -= 1;
+          if (job->active == 0)
+            pthread_cond_broadcast (&pool_idle);
+        }
+    }
+  return NULL;
+}
+
+static deque_t *
+new_deque (void)
+{
+  deque_t *dq = malloc (sizeof (deque_t));
+  if (dq != NULL)
+    {
+      pthread_mutex_init (&dq->lock, NULL);
+      dq->top = 0;
+      dq->bottom = 0;
+    }
+  return dq;
+}
+
+/* Make sure there are nthreads deques and nthreads - 1 pool threads,
+   or as many as can be had. Returns the number of threads available,
+   counting the caller. Call with pool_lock held and no job running. */
+static size_t
+grow_pool (size_t nthreads)
+{
+  if (n_deques < nthreads)
+    {
+      deque_t **p = realloc (deques, nthreads * sizeof (deque_t *));
+      if (p != NULL)
+        {
+          deques = p;
+          while (n_deques < nthreads
+                 && (deques[n_deques] = new_deque ()) != NULL)
+            n_deques += 1;
+        }
+    }
+  while (n_workers + 1 < nthreads && n_workers + 1 < n_deques)
+    {
+      pthread_t thread;
+      if (pthread_create (&thread, NULL, worker_main,
+                          (void *) (uintptr_t) (n_workers + 1)) != 0)
+        break;
+      pthread_detach (thread);
+      n_workers += 1;
+    }
+  return (n_workers + 1 < nthreads) ? n_workers + 1 : nthreads;
+}
+
+/* How many threads a job should have, counting the caller. Call with
+   pool_lock held. */
+static size_t
+threads_for_job (void)
+{
+  size_t nthreads = threads_wanted;
+  if (nthreads == 0)
+    {
+      const long n = sysconf (_SC_NPROCESSORS_ONLN);
+      nthreads = (n < 1) ? 1 : (size_t) n;
+    }
+  return nthreads;
+}
+
+void
+unstable_qsort_parallel_set_threads (size_t nthreads)
+{
+  pthread_mutex_lock (&pool_lock);
+  threads_wanted = nthreads;
+  pthread_mutex_unlock (&pool_lock);
+}
+
+void
+quicksorts__unstable_qsort_parallel__start_pool (void)
+{
+  pthread_mutex_lock (&pool_lock);
+  if (current_job == NULL)
+    {
+      const size_t nthreads = threads_for_job ();
+      if (2 <= nthreads)
+        (void) grow_pool (nthreads);
+    }
+  pthread_mutex_unlock (&pool_lock);
+}
+
+void
+quicksorts__unstable_qsort_parallel__run
+  (const struct quicksorts__unstable_qsort_parallel__sorter *sorter,
+   void *base, size_t nmemb)
+{
+  size_t nthreads = 1;
+
+  if (2 * sorter->threshold <= nmemb)
+    {
+      pthread_mutex_lock (&pool_lock);
+      if (current_job == NULL)
+        {
+          nthreads = threads_for_job ();
+          if (2 <= nthreads)
+            nthreads = grow_pool (nthreads);
+        }
+      else
+        nthreads = 1;
+      if (nthreads < 2)
+        pthread_mutex_unlock (&pool_lock);
+    }
+
+  if (nthreads < 2)
+    sorter->sort (sorter, base, nmemb);
+  else
+    {
+      /* pool_lock is held. */
+      job_t job;
+      job.sorter = sorter;
+      job.nthreads = nthreads;
+      atomic_init (&job.outstanding, 1);
+      job.active = 0;
+
+      const task_t task = {
+        .base = base,
+        .nmemb = nmemb,
+        .depth = quicksorts_common__depth_limit (nmemb)
+      };
+      deque_push (deques[0], task);
+
+      current_job = &job;
+      generation += 1;
+      pthread_cond_broadcast (&pool_wake);
+      pthread_mutex_unlock (&pool_lock);
+
+      work (&job, 0);
+
+      pthread_mutex_lock (&pool_lock);
+      while (job.active != 0)
+        pthread_cond_wait (&pool_idle, &pool_lock);
+      current_job = NULL;
+      pthread_mutex_unlock (&pool_lock);
+    }
+}
@@ -23,6 +23,7 @@
 #include <limits.h>
 #include <stdatomic.h>
 #include <stdbool.h>
+#include <stddef.h>
 #include <stdint.h>
 #include <stdlib.h>
 #include <string.h>
@@ -38,15 +39,29 @@
 #define quicksorts_common__inline static inline
 #endif
 
+/* For types through which elements of other types are moved. Without
+   it, such moves would break the effective-type rules, so code that
+   needs it does without when QUICKSORTS_COMMON__HAVE_MAY_ALIAS is
+   zero. */
+#if defined __GNUC__
+#define QUICKSORTS_COMMON__MAY_ALIAS __attribute__((__may_alias__))
+#define QUICKSORTS_COMMON__HAVE_MAY_ALIAS 1
+#else
+#define QUICKSORTS_COMMON__MAY_ALIAS
+#define QUICKSORTS_COMMON__HAVE_MAY_ALIAS 0
+#endif
+
 #if defined __GNUC__
 #define QUICKSORTS_COMMON__MEMSET __builtin_memset
 #define QUICKSORTS_COMMON__MEMCPY __builtin_memcpy
 #define QUICKSORTS_COMMON__MEMMOVE __builtin_memmove
+#define QUICKSORTS_COMMON__STRCMP __builtin_strcmp
 #define QUICKSORTS_COMMON__BSWAP64 __builtin_bswap64
 #else
 #define QUICKSORTS_COMMON__MEMSET memset
 #define QUICKSORTS_COMMON__MEMCPY memcpy
 #define QUICKSORTS_COMMON__MEMMOVE memmove
+#define QUICKSORTS_COMMON__STRCMP strcmp
 #define QUICKSORTS_COMMON__BSWAP64(x)               \
   ((((x) & UINT64_C (0x00000000000000FF)) << 56) |  \
    (((x) & UINT64_C (0x000000000000FF00)) << 40) |  \
@@ -58,45 +73,120 @@
    (((x) & UINT64_C (0xFF00000000000000)) >> 56))
 #endif
 
+/* Where the sort macros get their scratch memory. A program may
+   define these before it includes any of the headers, to hand out
+   memory it has set aside; see quicksorts_plan.c. A NULL from
+   QUICKSORTS_COMMON__MALLOC is always survived. */
+#ifndef QUICKSORTS_COMMON__MALLOC
+#define QUICKSORTS_COMMON__MALLOC(SIZE) malloc (SIZE)
+#endif
+#ifndef QUICKSORTS_COMMON__FREE
+#define QUICKSORTS_COMMON__FREE(PTR) free (PTR)
+#endif
+
 /*------------------------------------------------------------------*/
-/* Spinlocks for random number generator seeds.                     */
+/* Statistics hooks. These cost nothing unless QUICKSORTS_STATS is  */
+/* defined nonzero; see <quicksorts/unstable-qsort-stats.h>.        */
+
+#if defined QUICKSORTS_STATS && QUICKSORTS_STATS
 
-typedef struct
+#include <time.h>
+#include <quicksorts/unstable-qsort-stats.h>
+
+/* Where the calling thread’s sort keeps its counts, if anywhere. */
+static _Thread_local struct unstable_qsort_stats
+*quicksorts_common__stats = NULL;
+
+quicksorts_common__inline uint64_t
+quicksorts_common__stats_ns (void)
 {
-  /* Use unsigned integers, so they will wrap around when they
-     overflow. */
-  atomic_size_t active;
-  atomic_size_t available;
-} quicksorts_common__spinlock_t;
+  uint64_t ns = 0;
+  if (quicksorts_common__stats != NULL)
+    {
+      struct timespec t;
+      clock_gettime (CLOCK_MONOTONIC, &t);
+      ns = ((uint64_t) t.tv_sec * UINT64_C (1000000000)) + t.tv_nsec;
+    }
+  return ns;
+}
 
 quicksorts_common__inline void
-quicksorts_common__obtain_spinlock
-(quicksorts_common__spinlock_t *lock)
+quicksorts_common__stats_moved (uint64_t swaps, uint64_t bytes)
 {
-  size_t my_ticket =
-    atomic_fetch_add_explicit (&lock->available, 1,
-                               memory_order_seq_cst);
-  bool done = false;
-  while (!done)
+  if (quicksorts_common__stats != NULL)
     {
-      size_t active_ticket =
-        atomic_load_explicit (&lock->active, memory_order_seq_cst);
-      done = (my_ticket == active_ticket);
-      /* if (!done)                        */
-      /*   optionally_put_a_pause_here (); */
+      quicksorts_common__stats->swaps += swaps;
+      quicksorts_common__stats->bytes_moved += bytes;
     }
-  atomic_thread_fence (memory_order_seq_cst);
 }
 
 quicksorts_common__inline void
-quicksorts_common__release_spinlock
-(quicksorts_common__spinlock_t *lock)
+quicksorts_common__stats_stack_depth (int depth)
 {
-  atomic_thread_fence (memory_order_seq_cst);
-  (void) atomic_fetch_add_explicit (&lock->active, 1,
-                                    memory_order_seq_cst);
+  if (quicksorts_common__stats != NULL
+      && quicksorts_common__stats->max_stack_depth < (uint64_t) depth)
+    quicksorts_common__stats->max_stack_depth = (uint64_t) depth;
+}
+
+quicksorts_common__inline void
+quicksorts_common__stats_partition (size_t n_le, size_t n_ge)
+{
+  if (quicksorts_common__stats != NULL)
+    {
+      const size_t bins = UNSTABLE_QSORT_STATS_IMBALANCE_BINS;
+      const size_t n = n_le + n_ge;
+      const size_t n_min = (n_le < n_ge) ? n_le : n_ge;
+      size_t bin = (n == 0) ? bins : (n_min * (2 * bins)) / n;
+      if (bins <= bin)
+        bin = bins - 1;
+      quicksorts_common__stats->partitions += 1;
+      quicksorts_common__stats->imbalance[bin] += 1;
+    }
+}
+
+quicksorts_common__inline void
+quicksorts_common__stats_heap_sort (void)
+{
+  if (quicksorts_common__stats != NULL)
+    quicksorts_common__stats->heap_sorts += 1;
+}
+
+quicksorts_common__inline void
+quicksorts_common__stats_small_sort (size_t nmemb, uint64_t t0)
+{
+  if (quicksorts_common__stats != NULL)
+    {
+      quicksorts_common__stats->small_sorts += 1;
+      quicksorts_common__stats->small_sort_elements += nmemb;
+      quicksorts_common__stats->small_sort_ns +=
+        quicksorts_common__stats_ns () - t0;
+    }
 }
 
+#define QUICKSORTS_COMMON__STATS_MOVED(SWAPS, BYTES)        \
+  quicksorts_common__stats_moved ((SWAPS), (BYTES))
+#define QUICKSORTS_COMMON__STATS_STACK_DEPTH(DEPTH) \
+  quicksorts_common__stats_stack_depth (DEPTH)
+#define QUICKSORTS_COMMON__STATS_PARTITION(N_LE, N_GE)  \
+  quicksorts_common__stats_partition ((N_LE), (N_GE))
+#define QUICKSORTS_COMMON__STATS_HEAP_SORT()    \
+  quicksorts_common__stats_heap_sort ()
+#define QUICKSORTS_COMMON__STATS_SMALL_SORT_BEGIN(PFX)                  \
+  const uint64_t PFX##stats__t0 = quicksorts_common__stats_ns ()
+#define QUICKSORTS_COMMON__STATS_SMALL_SORT_END(PFX, NMEMB)             \
+  quicksorts_common__stats_small_sort ((NMEMB), PFX##stats__t0)
+
+#else
+
+#define QUICKSORTS_COMMON__STATS_MOVED(SWAPS, BYTES) do { } while (0)
+#define QUICKSORTS_COMMON__STATS_STACK_DEPTH(DEPTH) do { } while (0)
+#define QUICKSORTS_COMMON__STATS_PARTITION(N_LE, N_GE) do { } while (0)
+#define QUICKSORTS_COMMON__STATS_HEAP_SORT() do { } while (0)
+#define QUICKSORTS_COMMON__STATS_SMALL_SORT_BEGIN(PFX) do { } while (0)
+#define QUICKSORTS_COMMON__STATS_SMALL_SORT_END(PFX, NMEMB) do { } while (0)
+
+#endif
+
 /*------------------------------------------------------------------*/
 /* A simple linear congruential generator.                          */
 
@@ -110,34 +200,59 @@ quicksorts_common__release_spinlock
    instruction.) */
 #define QUICKSORTS_COMMON__LCG_C (UINT64_C (1))
 
-extern quicksorts_common__spinlock_t quicksorts_common__seed_lock;
-extern uint64_t quicksorts_common__seed;
+/* Each thread has a generator of its own, so threads sorting at the
+   same time do not contend for it. A thread’s generator is seeded on
+   first use, from a global seed that is advanced atomically. */
+extern atomic_uint_least64_t quicksorts_common__seed;
+extern _Thread_local uint64_t quicksorts_common__thread_seed;
+extern _Thread_local bool quicksorts_common__thread_seeded;
+
+void quicksorts_common__seed_thread (void);
 
+/* Advance the generator, returning its state before the step. Only
+   the high bits of the state are of good quality. */
 quicksorts_common__inline uint64_t
-quicksorts_common__random_uint64 (void)
+quicksorts_common__random_lcg_state (void)
 {
-  quicksorts_common__obtain_spinlock (&quicksorts_common__seed_lock);
+  if (!quicksorts_common__thread_seeded)
+    quicksorts_common__seed_thread ();
 
-  const uint64_t old_seed = quicksorts_common__seed;
+  const uint64_t old_seed = quicksorts_common__thread_seed;
 
   /* The following operation is modulo 2**64, by virtue of standard C
      behavior for uint64_t. */
-  quicksorts_common__seed =
+  quicksorts_common__thread_seed =
     (QUICKSORTS_COMMON__LCG_A * old_seed) + QUICKSORTS_COMMON__LCG_C;
 
-  quicksorts_common__release_spinlock (&quicksorts_common__seed_lock);
+  return old_seed;
+}
 
+quicksorts_common__inline uint64_t
+quicksorts_common__random_uint64 (void)
+{
   /* Reverse the bytes, because least significant bits of LCG output
      tend to be bad. Indeed, the very least significant bit literally
      switches back and forth between 0 and 1. */
-  return QUICKSORTS_COMMON__BSWAP64 (old_seed);
+  return QUICKSORTS_COMMON__BSWAP64 (quicksorts_common__random_lcg_state ());
 }
 
+/* A random number in [0, n), by multiplying and keeping the high
+   half (Lemire), which is cheaper than a division. The bias is
+   negligible for pivot selection. The multiplication takes the LCG
+   state as it is, not byte-reversed, so that the result comes from
+   the state’s high bits, which have the longest periods. */
 quicksorts_common__inline size_t
 quicksorts_common__random_size_t_below (size_t n)
 {
-  const uint64_t v = quicksorts_common__random_uint64 ();
-  return (size_t) (v % (uint64_t) n);
+  const uint64_t v = quicksorts_common__random_lcg_state ();
+#if defined __SIZEOF_INT128__
+  return (size_t) (((unsigned __int128) v * (uint64_t) n) >> 64);
+#else
+  if (n <= UINT32_MAX)
+    return (size_t) (((v >> 32) * (uint64_t) n) >> 32);
+  else
+    return (size_t) (QUICKSORTS_COMMON__BSWAP64 (v) % (uint64_t) n);
+#endif
 }
 
 /*------------------------------------------------------------------*/
@@ -209,36 +324,188 @@ quicksorts_common__random_size_t_below (size_t n)
     }                                                               \
   while (0)
 
+/* The index of the median of the elements at indices I, J and K. */
+#define QUICKSORTS_COMMON__MEDIAN_INDEX(ARR, SIZE, LT, I, J, K, RESULT) \
+  do                                                                    \
+    {                                                                   \
+      const size_t median_index__i = (I);                               \
+      const size_t median_index__j = (J);                               \
+      const size_t median_index__k = (K);                               \
+      const char *p_i = (ARR) + ((SIZE) * median_index__i);             \
+      const char *p_j = (ARR) + ((SIZE) * median_index__j);             \
+      const char *p_k = (ARR) + ((SIZE) * median_index__k);             \
+      const bool j_lt_i =                                               \
+        (bool) LT ((const void *) p_j, (const void *) p_i);             \
+      const bool k_lt_i =                                               \
+        (bool) LT ((const void *) p_k, (const void *) p_i);             \
+      if (j_lt_i != k_lt_i)                                             \
+        RESULT = median_index__i;                                       \
+      else if (j_lt_i != (bool) LT ((const void *) p_j,                 \
+                                    (const void *) p_k))                \
+        RESULT = median_index__j;                                       \
+      else                                                              \
+        RESULT = median_index__k;                                       \
+    }                                                                   \
+  while (0)
+
+/* Adaptive pivot selection: median-of-three for small subarrays,
+   Tukey’s ninther (the median of three medians of three) above
+   NINTHER_SIZE elements, and above SAMPLE_SIZE elements the median of
+   a random sample of about sqrt(nmemb) elements, one from each of
+   that many equal strata. The sample is of indices, so the array is
+   not disturbed; its median is found by Hoare’s FIND, which takes an
+   expected linear number of comparisons. */
+
+#ifndef QUICKSORTS_COMMON__PIVOT_ADAPTIVE__NINTHER_SIZE
+#define QUICKSORTS_COMMON__PIVOT_ADAPTIVE__NINTHER_SIZE 128
+#endif
+
+#ifndef QUICKSORTS_COMMON__PIVOT_ADAPTIVE__SAMPLE_SIZE
+#define QUICKSORTS_COMMON__PIVOT_ADAPTIVE__SAMPLE_SIZE 16384
+#endif
+
+/* The largest sample taken, which must be odd. The sample occupies
+   this many size_t on the stack. */
+#ifndef QUICKSORTS_COMMON__PIVOT_ADAPTIVE__MAX_SAMPLE
+#define QUICKSORTS_COMMON__PIVOT_ADAPTIVE__MAX_SAMPLE 1023
+#endif
+
+/* An odd number near sqrt(nmemb), at most MAX_SAMPLE. */
+quicksorts_common__inline size_t
+quicksorts_common__sample_size (size_t nmemb)
+{
+  size_t k = 1;
+  while (4 * k * k <= nmemb
+         && k < (QUICKSORTS_COMMON__PIVOT_ADAPTIVE__MAX_SAMPLE))
+    k *= 2;
+  /* One Newton step from above brings k within a few percent. */
+  k = (k + (nmemb / k)) / 2;
+  if ((QUICKSORTS_COMMON__PIVOT_ADAPTIVE__MAX_SAMPLE) < k)
+    k = (QUICKSORTS_COMMON__PIVOT_ADAPTIVE__MAX_SAMPLE);
+  return k | 1;
+}
+
+#define QUICKSORTS_COMMON__PIVOT_ADAPTIVE(BASE, NMEMB, SIZE, LT,        \
+                                          RESULT)                       \
+  do                                                                    \
+    {                                                                   \
+      const size_t adaptive__nmemb = (size_t) (NMEMB);                  \
+      if (adaptive__nmemb                                               \
+          < (QUICKSORTS_COMMON__PIVOT_ADAPTIVE__NINTHER_SIZE))          \
+        {                                                               \
+          QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE                      \
+            (BASE, adaptive__nmemb, SIZE, LT, RESULT);                  \
+        }                                                               \
+      else if (adaptive__nmemb                                          \
+               < (QUICKSORTS_COMMON__PIVOT_ADAPTIVE__SAMPLE_SIZE))      \
+        {                                                               \
+          const char *const arr = (void *) (BASE);                      \
+          const size_t elemsz = (size_t) (SIZE);                        \
+          const size_t step = adaptive__nmemb / 8;                      \
+          const size_t i_middle = adaptive__nmemb / 2;                  \
+          const size_t i_last = adaptive__nmemb - 1;                    \
+          size_t i_a;                                                   \
+          size_t i_b;                                                   \
+          size_t i_c;                                                   \
+          QUICKSORTS_COMMON__MEDIAN_INDEX                               \
+            (arr, elemsz, LT, 0, step, 2 * step, i_a);                  \
+          QUICKSORTS_COMMON__MEDIAN_INDEX                               \
+            (arr, elemsz, LT, i_middle - step, i_middle,                \
+             i_middle + step, i_b);                                     \
+          QUICKSORTS_COMMON__MEDIAN_INDEX                               \
+            (arr, elemsz, LT, i_last - (2 * step), i_last - step,       \
+             i_last, i_c);                                              \
+          QUICKSORTS_COMMON__MEDIAN_INDEX                               \
+            (arr, elemsz, LT, i_a, i_b, i_c, RESULT);                   \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          const char *const arr = (void *) (BASE);                      \
+          const size_t elemsz = (size_t) (SIZE);                        \
+          const size_t n_sample =                                       \
+            quicksorts_common__sample_size (adaptive__nmemb);           \
+          const size_t stride = adaptive__nmemb / n_sample;             \
+          size_t sample[QUICKSORTS_COMMON__PIVOT_ADAPTIVE__MAX_SAMPLE]; \
+          for (size_t i = 0; i != n_sample; i += 1)                     \
+            sample[i] = (i * stride)                                    \
+              + quicksorts_common__random_size_t_below (stride);        \
+                                                                        \
+          /* Hoare’s FIND, on the sample, for its median. The      */   \
+          /* indices are signed, because j may step below lo.      */   \
+          const ptrdiff_t target = (ptrdiff_t) (n_sample / 2);          \
+          ptrdiff_t lo = 0;                                             \
+          ptrdiff_t hi = (ptrdiff_t) n_sample - 1;                      \
+          while (lo < hi)                                               \
+            {                                                           \
+              size_t i_pv;                                              \
+              QUICKSORTS_COMMON__MEDIAN_INDEX                           \
+                (arr, elemsz, LT, sample[lo],                           \
+                 sample[lo + ((hi - lo) / 2)], sample[hi], i_pv);       \
+              const char *p_pv = arr + (elemsz * i_pv);                 \
+              ptrdiff_t i = lo;                                         \
+              ptrdiff_t j = hi;                                         \
+              do                                                        \
+                {                                                       \
+                  while (LT ((const void *) (arr + (elemsz * sample[i])), \
+                             (const void *) p_pv))                      \
+                    i += 1;                                             \
+                  while (LT ((const void *) p_pv,                       \
+                             (const void *) (arr + (elemsz * sample[j])))) \
+                    j -= 1;                                             \
+                  if (i <= j)                                           \
+                    {                                                   \
+                      const size_t tmp = sample[i];                     \
+                      sample[i] = sample[j];                            \
+                      sample[j] = tmp;                                  \
+                      i += 1;                                           \
+                      j -= 1;                                           \
+                    }                                                   \
+                }                                                       \
+              while (i <= j);                                           \
+              if (j < target)                                           \
+                lo = i;                                                 \
+              if (target < i)                                           \
+                hi = j;                                                 \
+            }                                                           \
+          RESULT = sample[target];                                      \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
 /*------------------------------------------------------------------*/
 
-/* Swap two elements. */
+/* Swap two elements. Elements larger than the element buffer are
+   swapped in place, a block of words at a time; the compiler can
+   keep each block in vector registers. */
 quicksorts_common__inline void
 quicksorts_common__elem_swap (char *p1, char *p2, size_t elemsz)
 {
-  char elembuf[QUICKSORTS_COMMON__ELEMBUF_SIZE];
-
+  QUICKSORTS_COMMON__STATS_MOVED (1, 2 * elemsz);
   if (elemsz <= (QUICKSORTS_COMMON__ELEMBUF_SIZE))
     {
+      char elembuf[QUICKSORTS_COMMON__ELEMBUF_SIZE];
       QUICKSORTS_COMMON__MEMCPY (elembuf, p1, elemsz);
       QUICKSORTS_COMMON__MEMCPY (p1, p2, elemsz);
       QUICKSORTS_COMMON__MEMCPY (p2, elembuf, elemsz);
     }
   else
     {
-      for (size_t i = 0;
-           i != elemsz;
-           i +=
-             (((elemsz - i) < (QUICKSORTS_COMMON__ELEMBUF_SIZE)) ?
-              (elemsz - i) : (QUICKSORTS_COMMON__ELEMBUF_SIZE)))
+      size_t i = 0;
+      for (; i + (4 * sizeof (uint64_t)) <= elemsz;
+           i += 4 * sizeof (uint64_t))
         {
-          const size_t blocksz =
-            ((elemsz - i) < (QUICKSORTS_COMMON__ELEMBUF_SIZE)) ?
-            (elemsz - i) : (QUICKSORTS_COMMON__ELEMBUF_SIZE);
-          QUICKSORTS_COMMON__MEMCPY (elembuf, p1, blocksz);
-          QUICKSORTS_COMMON__MEMCPY (p1, p2, blocksz);
-          QUICKSORTS_COMMON__MEMCPY (p2, elembuf, blocksz);
-          p1 += blocksz;
-          p2 += blocksz;
+          uint64_t w1[4];
+          uint64_t w2[4];
+          QUICKSORTS_COMMON__MEMCPY (w1, p1 + i, sizeof w1);
+          QUICKSORTS_COMMON__MEMCPY (w2, p2 + i, sizeof w2);
+          QUICKSORTS_COMMON__MEMCPY (p1 + i, w2, sizeof w2);
+          QUICKSORTS_COMMON__MEMCPY (p2 + i, w1, sizeof w1);
+        }
+      for (; i != elemsz; i += 1)
+        {
+          const char c = p1[i];
+          p1[i] = p2[i];
+          p2[i] = c;
         }
     }
 }
@@ -249,6 +516,7 @@ quicksorts_common__elem_swap (char *p1, char *p2, size_t elemsz)
     {                                                       \
       T *PFX##swap__p1 = (T *) (P1);                        \
       T *PFX##swap__p2 = (T *) (P2);                        \
+      QUICKSORTS_COMMON__STATS_MOVED (1, 2 * sizeof (T));   \
       T tmp = *PFX##swap__p1;                               \
       *PFX##swap__p1 = *PFX##swap__p2;                      \
       *PFX##swap__p2 = tmp;                                 \
@@ -271,6 +539,22 @@ quicksorts_common__reverse_prefix (char *arr, size_t pfx_len,
   while (p_left < p_right);
 }
 
+/* Exchange the n1 elements at arr with the n - n1 that follow them,
+   where n1 <= n, by three reversals. */
+quicksorts_common__inline void
+quicksorts_common__rotate (char *arr, size_t n1, size_t n, size_t elemsz)
+{
+  if (n1 != 0 && n1 != n)
+    {
+      if (2 <= n1)
+        quicksorts_common__reverse_prefix (arr, n1, elemsz);
+      if (2 <= n - n1)
+        quicksorts_common__reverse_prefix (arr + (n1 * elemsz), n - n1,
+                                           elemsz);
+      quicksorts_common__reverse_prefix (arr, n, elemsz);
+    }
+}
+
 /* Reverse a prefix of pfx_len >= 2. */
 #define QUICKSORTS_COMMON__REVERSE_PREFIX__TYPED(PFX, T, ARR,   \
                                                  PFX_LEN)       \
@@ -311,32 +595,32 @@ quicksorts_common__reverse_prefix (char *arr, size_t pfx_len,
 
   * https://en.wikipedia.org/w/index.php?title=Binary_search_algorithm&oldid=1062988272#Alternative_procedure
 */
-#define QUICKSORTS_COMMON__INSERTION_POSITION(PFX, LT)              \
-  do                                                                \
-    {                                                               \
-      char *PFX##pj = PFX##arr;                                     \
-      char *PFX##pk = PFX##pi - PFX##elemsz;                        \
-                                                                    \
-      while (PFX##pj != PFX##pk)                                    \
-        {                                                           \
-          /* Ceiling of the midway point: */                        \
-          char *PFX##ph =                                           \
-            PFX##pk - (PFX##elemsz *                                \
-                       (((PFX##pk - PFX##pj) / PFX##elemsz) >> 1)); \
-                                                                    \
-          if (LT ((void *) PFX##pi, (void *) PFX##ph))              \
-            PFX##pk = PFX##ph - PFX##elemsz;                        \
-          else                                                      \
-            PFX##pj = PFX##ph;                                      \
-        }                                                           \
-                                                                    \
-      if (PFX##pj != PFX##arr)                                      \
-        PFX##pos = PFX##pj + PFX##elemsz;                           \
-      else if (LT ((void *) PFX##pi, (void *) PFX##arr))            \
-        PFX##pos = PFX##arr;                                        \
-      else                                                          \
-        PFX##pos = PFX##arr + PFX##elemsz;                          \
-    }                                                               \
+#define QUICKSORTS_COMMON__INSERTION_POSITION(PFX, LT)                  \
+  do                                                                    \
+    {                                                                   \
+      /* Search by index, so that no step divides by elemsz. */        \
+      size_t PFX##j = 0;                                                \
+      size_t PFX##k = PFX##i - 1;                                       \
+                                                                        \
+      while (PFX##j != PFX##k)                                          \
+        {                                                               \
+          /* Ceiling of the midway point: */                            \
+          const size_t PFX##h = PFX##k - ((PFX##k - PFX##j) >> 1);      \
+                                                                        \
+          if (LT ((void *) PFX##pi,                                     \
+                  (void *) (PFX##arr + (PFX##elemsz * PFX##h))))        \
+            PFX##k = PFX##h - 1;                                        \
+          else                                                          \
+            PFX##j = PFX##h;                                            \
+        }                                                               \
+                                                                        \
+      if (PFX##j != 0)                                                  \
+        PFX##pos = PFX##arr + (PFX##elemsz * (PFX##j + 1));             \
+      else if (LT ((void *) PFX##pi, (void *) PFX##arr))                \
+        PFX##pos = PFX##arr;                                            \
+      else                                                              \
+        PFX##pos = PFX##arr + PFX##elemsz;                              \
+    }                                                                   \
   while (0)
 /**/
 #else
@@ -393,6 +677,7 @@ quicksorts_common__subcirculate_right (char *p_left, char *p_right,
 
   if (p_left != p_right)
     {
+      QUICKSORTS_COMMON__STATS_MOVED (0, (p_right - p_left) + elemsz);
       if (elemsz <= (QUICKSORTS_COMMON__ELEMBUF_SIZE))
         {
           QUICKSORTS_COMMON__MEMCPY (elembuf, p_right, elemsz);
@@ -428,15 +713,18 @@ quicksorts_common__subcirculate_right (char *p_left, char *p_right,
                                        size_t elemsz)
 {
   if (p_left != p_right)
-    for (size_t i = 0; i != elemsz; i += 1)
-      {
-        char tmp = *p_right;
-        for (char *p = p_right; p != p_left; p -= elemsz)
-          *p = *(p - elemsz);
-        *p_left = tmp;
-        p_left += 1;
-        p_right += 1;
-      }
+    {
+      QUICKSORTS_COMMON__STATS_MOVED (0, (p_right - p_left) + elemsz);
+      for (size_t i = 0; i != elemsz; i += 1)
+        {
+          char tmp = *p_right;
+          for (char *p = p_right; p != p_left; p -= elemsz)
+            *p = *(p - elemsz);
+          *p_left = tmp;
+          p_left += 1;
+          p_right += 1;
+        }
+    }
 }
 #endif
 
@@ -449,6 +737,9 @@ quicksorts_common__subcirculate_right (char *p_left, char *p_right,
       T *PFX##subcircrt__p_right = (T *) (P_RIGHT);                 \
       if (PFX##subcircrt__p_left != PFX##subcircrt__p_right)        \
         {                                                           \
+          QUICKSORTS_COMMON__STATS_MOVED                            \
+            (0, ((PFX##subcircrt__p_right - PFX##subcircrt__p_left) \
+                 + 1) * sizeof (T));                                \
           T PFX##subcircrt__tmp = *PFX##subcircrt__p_right;         \
           QUICKSORTS_COMMON__MEMMOVE                                \
             (PFX##subcircrt__p_left + 1,                            \
@@ -473,6 +764,8 @@ quicksorts_common__subcirculate_right_with_gap (char *p_left,
   if (p_left != p_right)
     {
       const size_t chargap = elemsz * gap;
+      QUICKSORTS_COMMON__STATS_MOVED
+        (0, (((p_right - p_left) / chargap) + 1) * elemsz);
 
       if (elemsz <= (QUICKSORTS_COMMON__ELEMBUF_SIZE))
         {
@@ -518,6 +811,8 @@ quicksorts_common__subcirculate_right_with_gap (char *p_left,
   if (p_left != p_right)
     {
       const size_t chargap = elemsz * gap;
+      QUICKSORTS_COMMON__STATS_MOVED
+        (0, (((p_right - p_left) / chargap) + 1) * elemsz);
 
       for (size_t i = 0; i != elemsz; i += 1)
         {
@@ -543,6 +838,9 @@ quicksorts_common__subcirculate_right_with_gap (char *p_left,
       T *PFX##subcrtgap__p_right = (T *) (P_RIGHT);                     \
       if (PFX##subcrtgap__p_left != PFX##subcrtgap__p_right)            \
         {                                                               \
+          QUICKSORTS_COMMON__STATS_MOVED                                \
+            (0, (((PFX##subcrtgap__p_right - PFX##subcrtgap__p_left)    \
+                  / PFX##subcrtgap__gap) + 1) * sizeof (T));            \
           T PFX##subcrtgap__tmp = *PFX##subcrtgap__p_right;             \
           for (T *PFX##subcrtgap__p = PFX##subcrtgap__p_right;          \
                PFX##subcrtgap__p != PFX##subcrtgap__p_left;             \
@@ -600,22 +898,572 @@ quicksorts_common__subcirculate_right_with_gap (char *p_left,
     }                                                                   \
   while (0)
 
-#define QUICKSORTS_COMMON__STK_MAKE(PFX)                    \
-  typedef struct {void *p; size_t n;} PFX##stk_entry_t;     \
-  PFX##stk_entry_t PFX##stk[CHAR_BIT * sizeof (size_t)];    \
-  QUICKSORTS_COMMON__MEMSET                                 \
-  (PFX##stk, 0,                                             \
-   CHAR_BIT * sizeof (size_t) * sizeof (PFX##stk_entry_t)); \
+/*------------------------------------------------------------------*/
+/* Sorting networks, for small subarrays.                           */
+
+/*
+  Fixed networks for two to sixteen elements, written out in full so
+  that the indices are constants and, with typed elements, every
+  compare-exchange can become a pair of conditional moves. Those for
+  up to twelve elements have the fewest comparators possible; those
+  for fourteen to sixteen elements are the smallest known, and that
+  for thirteen has one comparator more than the smallest known. Each
+  was checked against every sequence of zeros and ones.
+
+  CX (PFX, T, LT, I, J) compare-exchanges elements I and J, I < J,
+  of PFX##arr.
+*/
+
+#define QUICKSORTS_COMMON__NETWORK_CX(PFX, T, LT, I, J)                 \
+  do                                                                    \
+    {                                                                   \
+      char *PFX##pi = PFX##arr + (PFX##elemsz * (I));                   \
+      char *PFX##pj = PFX##arr + (PFX##elemsz * (J));                   \
+      if (LT ((const void *) PFX##pj, (const void *) PFX##pi))          \
+        quicksorts_common__elem_swap (PFX##pi, PFX##pj, PFX##elemsz);   \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS_COMMON__NETWORK_CX__TYPED(PFX, T, LT, I, J)          \
+  do                                                                    \
+    {                                                                   \
+      T *PFX##pi = PFX##arr + (I);                                      \
+      T *PFX##pj = PFX##arr + (J);                                      \
+      const bool PFX##x = LT (PFX##pj, PFX##pi);                        \
+      T PFX##lo = PFX##x ? *PFX##pj : *PFX##pi;                         \
+      T PFX##hi = PFX##x ? *PFX##pi : *PFX##pj;                         \
+      *PFX##pi = PFX##lo;                                               \
+      *PFX##pj = PFX##hi;                                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS_COMMON__NETWORK_2(CX, PFX, T, LT)                    \
+  CX (PFX, T, LT, 0, 1)
+
+#define QUICKSORTS_COMMON__NETWORK_3(CX, PFX, T, LT)                    \
+  CX (PFX, T, LT, 0, 2); CX (PFX, T, LT, 0, 1); CX (PFX, T, LT, 1, 2)
+
+#define QUICKSORTS_COMMON__NETWORK_4(CX, PFX, T, LT)                    \
+  CX (PFX, T, LT, 0, 2); CX (PFX, T, LT, 1, 3); CX (PFX, T, LT, 0, 1);  \
+  CX (PFX, T, LT, 2, 3); CX (PFX, T, LT, 1, 2)
+
+#define QUICKSORTS_COMMON__NETWORK_5(CX, PFX, T, LT)                    \
+  CX (PFX, T, LT, 0, 3); CX (PFX, T, LT, 1, 4); CX (PFX, T, LT, 0, 2);  \
+  CX (PFX, T, LT, 1, 3); CX (PFX, T, LT, 0, 1); CX (PFX, T, LT, 2, 4);  \
+  CX (PFX, T, LT, 1, 2); CX (PFX, T, LT, 3, 4); CX (PFX, T, LT, 2, 3)
+
+#define QUICKSORTS_COMMON__NETWORK_6(CX, PFX, T, LT)                    \
+  CX (PFX, T, LT, 0, 5); CX (PFX, T, LT, 1, 3); CX (PFX, T, LT, 2, 4);  \
+  CX (PFX, T, LT, 1, 2); CX (PFX, T, LT, 3, 4); CX (PFX, T, LT, 0, 3);  \
+  CX (PFX, T, LT, 2, 5); CX (PFX, T, LT, 0, 1); CX (PFX, T, LT, 2, 3);  \
+  CX (PFX, T, LT, 4, 5); CX (PFX, T, LT, 1, 2); CX (PFX, T, LT, 3, 4)
+
+#define QUICKSORTS_COMMON__NETWORK_7(CX, PFX, T, LT)                    \
+  CX (PFX, T, LT, 0, 6); CX (PFX, T, LT, 2, 3); CX (PFX, T, LT, 4, 5);  \
+  CX (PFX, T, LT, 0, 2); CX (PFX, T, LT, 1, 4); CX (PFX, T, LT, 3, 6);  \
+  CX (PFX, T, LT, 0, 1); CX (PFX, T, LT, 2, 5); CX (PFX, T, LT, 3, 4);  \
+  CX (PFX, T, LT, 1, 2); CX (PFX, T, LT, 4, 6); CX (PFX, T, LT, 2, 3);  \
+  CX (PFX, T, LT, 4, 5); CX (PFX, T, LT, 1, 2); CX (PFX, T, LT, 3, 4);  \
+  CX (PFX, T, LT, 5, 6)
+
+#define QUICKSORTS_COMMON__NETWORK_8(CX, PFX, T, LT)                    \
+  CX (PFX, T, LT, 0, 2); CX (PFX, T, LT, 1, 3); CX (PFX, T, LT, 4, 6);  \
+  CX (PFX, T, LT, 5, 7); CX (PFX, T, LT, 0, 4); CX (PFX, T, LT, 1, 5);  \
+  CX (PFX, T, LT, 2, 6); CX (PFX, T, LT, 3, 7); CX (PFX, T, LT, 0, 1);  \
+  CX (PFX, T, LT, 2, 3); CX (PFX, T, LT, 4, 5); CX (PFX, T, LT, 6, 7);  \
+  CX (PFX, T, LT, 2, 4); CX (PFX, T, LT, 3, 5); CX (PFX, T, LT, 1, 4);  \
+  CX (PFX, T, LT, 3, 6); CX (PFX, T, LT, 1, 2); CX (PFX, T, LT, 3, 4);  \
+  CX (PFX, T, LT, 5, 6)
+
+#define QUICKSORTS_COMMON__NETWORK_9(CX, PFX, T, LT)                    \
+  CX (PFX, T, LT, 0, 3); CX (PFX, T, LT, 1, 7); CX (PFX, T, LT, 2, 5);  \
+  CX (PFX, T, LT, 4, 8); CX (PFX, T, LT, 0, 7); CX (PFX, T, LT, 2, 4);  \
+  CX (PFX, T, LT, 3, 8); CX (PFX, T, LT, 5, 6); CX (PFX, T, LT, 0, 2);  \
+  CX (PFX, T, LT, 1, 3); CX (PFX, T, LT, 4, 5); CX (PFX, T, LT, 7, 8);  \
+  CX (PFX, T, LT, 1, 4); CX (PFX, T, LT, 3, 6); CX (PFX, T, LT, 5, 7);  \
+  CX (PFX, T, LT, 0, 1); CX (PFX, T, LT, 2, 4); CX (PFX, T, LT, 3, 5);  \
+  CX (PFX, T, LT, 6, 8); CX (PFX, T, LT, 2, 3); CX (PFX, T, LT, 4, 5);  \
+  CX (PFX, T, LT, 6, 7); CX (PFX, T, LT, 1, 2); CX (PFX, T, LT, 3, 4);  \
+  CX (PFX, T, LT, 5, 6)
+
+#define QUICKSORTS_COMMON__NETWORK_10(CX, PFX, T, LT)                   \
+  CX (PFX, T, LT, 0, 8); CX (PFX, T, LT, 1, 9); CX (PFX, T, LT, 2, 7);  \
+  CX (PFX, T, LT, 3, 5); CX (PFX, T, LT, 4, 6); CX (PFX, T, LT, 0, 2);  \
+  CX (PFX, T, LT, 1, 4); CX (PFX, T, LT, 5, 8); CX (PFX, T, LT, 7, 9);  \
+  CX (PFX, T, LT, 0, 3); CX (PFX, T, LT, 2, 4); CX (PFX, T, LT, 5, 7);  \
+  CX (PFX, T, LT, 6, 9); CX (PFX, T, LT, 0, 1); CX (PFX, T, LT, 3, 6);  \
+  CX (PFX, T, LT, 8, 9); CX (PFX, T, LT, 1, 5); CX (PFX, T, LT, 2, 3);  \
+  CX (PFX, T, LT, 4, 8); CX (PFX, T, LT, 6, 7); CX (PFX, T, LT, 1, 2);  \
+  CX (PFX, T, LT, 3, 5); CX (PFX, T, LT, 4, 6); CX (PFX, T, LT, 7, 8);  \
+  CX (PFX, T, LT, 2, 3); CX (PFX, T, LT, 4, 5); CX (PFX, T, LT, 6, 7);  \
+  CX (PFX, T, LT, 3, 4); CX (PFX, T, LT, 5, 6)
+
+#define QUICKSORTS_COMMON__NETWORK_11(CX, PFX, T, LT)                   \
+  CX (PFX, T, LT, 0, 9); CX (PFX, T, LT, 1, 6); CX (PFX, T, LT, 2, 4);  \
+  CX (PFX, T, LT, 3, 7); CX (PFX, T, LT, 5, 8); CX (PFX, T, LT, 0, 1);  \
+  CX (PFX, T, LT, 3, 5); CX (PFX, T, LT, 4, 10); CX (PFX, T, LT, 6, 9); \
+  CX (PFX, T, LT, 7, 8); CX (PFX, T, LT, 1, 3); CX (PFX, T, LT, 2, 5);  \
+  CX (PFX, T, LT, 4, 7); CX (PFX, T, LT, 8, 10); CX (PFX, T, LT, 0, 4); \
+  CX (PFX, T, LT, 1, 2); CX (PFX, T, LT, 3, 7); CX (PFX, T, LT, 5, 9);  \
+  CX (PFX, T, LT, 6, 8); CX (PFX, T, LT, 0, 1); CX (PFX, T, LT, 2, 6);  \
+  CX (PFX, T, LT, 4, 5); CX (PFX, T, LT, 7, 8); CX (PFX, T, LT, 9, 10); \
+  CX (PFX, T, LT, 2, 4); CX (PFX, T, LT, 3, 6); CX (PFX, T, LT, 5, 7);  \
+  CX (PFX, T, LT, 8, 9); CX (PFX, T, LT, 1, 2); CX (PFX, T, LT, 3, 4);  \
+  CX (PFX, T, LT, 5, 6); CX (PFX, T, LT, 7, 8); CX (PFX, T, LT, 2, 3);  \
+  CX (PFX, T, LT, 4, 5); CX (PFX, T, LT, 6, 7)
+
+#define QUICKSORTS_COMMON__NETWORK_12(CX, PFX, T, LT)                   \
+  CX (PFX, T, LT, 0, 8); CX (PFX, T, LT, 1, 7); CX (PFX, T, LT, 2, 6);  \
+  CX (PFX, T, LT, 3, 11); CX (PFX, T, LT, 4, 10);                       \
+  CX (PFX, T, LT, 5, 9); CX (PFX, T, LT, 0, 1); CX (PFX, T, LT, 2, 5);  \
+  CX (PFX, T, LT, 3, 4); CX (PFX, T, LT, 6, 9); CX (PFX, T, LT, 7, 8);  \
+  CX (PFX, T, LT, 10, 11); CX (PFX, T, LT, 0, 2);                       \
+  CX (PFX, T, LT, 1, 6); CX (PFX, T, LT, 5, 10);                        \
+  CX (PFX, T, LT, 9, 11); CX (PFX, T, LT, 0, 3); CX (PFX, T, LT, 1, 2); \
+  CX (PFX, T, LT, 4, 6); CX (PFX, T, LT, 5, 7); CX (PFX, T, LT, 8, 11); \
+  CX (PFX, T, LT, 9, 10); CX (PFX, T, LT, 1, 4); CX (PFX, T, LT, 3, 5); \
+  CX (PFX, T, LT, 6, 8); CX (PFX, T, LT, 7, 10); CX (PFX, T, LT, 1, 3); \
+  CX (PFX, T, LT, 2, 5); CX (PFX, T, LT, 6, 9); CX (PFX, T, LT, 8, 10); \
+  CX (PFX, T, LT, 2, 3); CX (PFX, T, LT, 4, 5); CX (PFX, T, LT, 6, 7);  \
+  CX (PFX, T, LT, 8, 9); CX (PFX, T, LT, 4, 6); CX (PFX, T, LT, 5, 7);  \
+  CX (PFX, T, LT, 3, 4); CX (PFX, T, LT, 5, 6); CX (PFX, T, LT, 7, 8)
+
+#define QUICKSORTS_COMMON__NETWORK_13(CX, PFX, T, LT)                   \
+  CX (PFX, T, LT, 0, 11); CX (PFX, T, LT, 1, 7); CX (PFX, T, LT, 2, 4); \
+  CX (PFX, T, LT, 3, 5); CX (PFX, T, LT, 8, 9);                         \
+  CX (PFX, T, LT, 10, 12); CX (PFX, T, LT, 0, 2);                       \
+  CX (PFX, T, LT, 3, 6); CX (PFX, T, LT, 4, 12); CX (PFX, T, LT, 5, 7); \
+  CX (PFX, T, LT, 8, 10); CX (PFX, T, LT, 0, 8); CX (PFX, T, LT, 1, 3); \
+  CX (PFX, T, LT, 2, 5); CX (PFX, T, LT, 4, 9); CX (PFX, T, LT, 6, 11); \
+  CX (PFX, T, LT, 7, 12); CX (PFX, T, LT, 0, 1);                        \
+  CX (PFX, T, LT, 2, 10); CX (PFX, T, LT, 3, 8); CX (PFX, T, LT, 4, 6); \
+  CX (PFX, T, LT, 9, 11); CX (PFX, T, LT, 1, 3); CX (PFX, T, LT, 2, 4); \
+  CX (PFX, T, LT, 5, 10); CX (PFX, T, LT, 6, 8); CX (PFX, T, LT, 7, 9); \
+  CX (PFX, T, LT, 11, 12); CX (PFX, T, LT, 1, 2);                       \
+  CX (PFX, T, LT, 3, 4); CX (PFX, T, LT, 5, 8); CX (PFX, T, LT, 6, 9);  \
+  CX (PFX, T, LT, 7, 10); CX (PFX, T, LT, 2, 3); CX (PFX, T, LT, 4, 7); \
+  CX (PFX, T, LT, 5, 6); CX (PFX, T, LT, 8, 11);                        \
+  CX (PFX, T, LT, 9, 10); CX (PFX, T, LT, 4, 5); CX (PFX, T, LT, 6, 7); \
+  CX (PFX, T, LT, 8, 9); CX (PFX, T, LT, 10, 11);                       \
+  CX (PFX, T, LT, 3, 4); CX (PFX, T, LT, 5, 6); CX (PFX, T, LT, 7, 8);  \
+  CX (PFX, T, LT, 9, 10)
+
+#define QUICKSORTS_COMMON__NETWORK_14(CX, PFX, T, LT)                   \
+  CX (PFX, T, LT, 0, 13); CX (PFX, T, LT, 1, 12);                       \
+  CX (PFX, T, LT, 4, 8); CX (PFX, T, LT, 5, 6); CX (PFX, T, LT, 7, 11); \
+  CX (PFX, T, LT, 9, 10); CX (PFX, T, LT, 0, 5); CX (PFX, T, LT, 1, 7); \
+  CX (PFX, T, LT, 2, 9); CX (PFX, T, LT, 3, 4); CX (PFX, T, LT, 6, 13); \
+  CX (PFX, T, LT, 11, 12); CX (PFX, T, LT, 0, 1);                       \
+  CX (PFX, T, LT, 2, 3); CX (PFX, T, LT, 4, 5); CX (PFX, T, LT, 6, 8);  \
+  CX (PFX, T, LT, 7, 9); CX (PFX, T, LT, 10, 11);                       \
+  CX (PFX, T, LT, 12, 13); CX (PFX, T, LT, 0, 2);                       \
+  CX (PFX, T, LT, 1, 3); CX (PFX, T, LT, 4, 10);                        \
+  CX (PFX, T, LT, 5, 11); CX (PFX, T, LT, 6, 7); CX (PFX, T, LT, 8, 9); \
+  CX (PFX, T, LT, 1, 2); CX (PFX, T, LT, 3, 12); CX (PFX, T, LT, 4, 6); \
+  CX (PFX, T, LT, 5, 7); CX (PFX, T, LT, 8, 10);                        \
+  CX (PFX, T, LT, 9, 11); CX (PFX, T, LT, 1, 4); CX (PFX, T, LT, 2, 6); \
+  CX (PFX, T, LT, 5, 8); CX (PFX, T, LT, 7, 10);                        \
+  CX (PFX, T, LT, 9, 13); CX (PFX, T, LT, 2, 4); CX (PFX, T, LT, 3, 6); \
+  CX (PFX, T, LT, 9, 12); CX (PFX, T, LT, 11, 13);                      \
+  CX (PFX, T, LT, 3, 5); CX (PFX, T, LT, 6, 8); CX (PFX, T, LT, 7, 9);  \
+  CX (PFX, T, LT, 10, 12); CX (PFX, T, LT, 3, 4);                       \
+  CX (PFX, T, LT, 5, 6); CX (PFX, T, LT, 7, 8); CX (PFX, T, LT, 9, 10); \
+  CX (PFX, T, LT, 11, 12); CX (PFX, T, LT, 6, 7);                       \
+  CX (PFX, T, LT, 8, 9)
+
+#define QUICKSORTS_COMMON__NETWORK_15(CX, PFX, T, LT)                   \
+  CX (PFX, T, LT, 0, 13); CX (PFX, T, LT, 1, 12);                       \
+  CX (PFX, T, LT, 3, 14); CX (PFX, T, LT, 4, 8); CX (PFX, T, LT, 5, 6); \
+  CX (PFX, T, LT, 7, 11); CX (PFX, T, LT, 9, 10);                       \
+  CX (PFX, T, LT, 0, 5); CX (PFX, T, LT, 1, 7); CX (PFX, T, LT, 2, 9);  \
+  CX (PFX, T, LT, 3, 4); CX (PFX, T, LT, 6, 13);                        \
+  CX (PFX, T, LT, 8, 14); CX (PFX, T, LT, 11, 12);                      \
+  CX (PFX, T, LT, 0, 1); CX (PFX, T, LT, 2, 3); CX (PFX, T, LT, 4, 5);  \
+  CX (PFX, T, LT, 6, 8); CX (PFX, T, LT, 7, 9);                         \
+  CX (PFX, T, LT, 10, 11); CX (PFX, T, LT, 12, 13);                     \
+  CX (PFX, T, LT, 0, 2); CX (PFX, T, LT, 1, 3); CX (PFX, T, LT, 4, 10); \
+  CX (PFX, T, LT, 5, 11); CX (PFX, T, LT, 6, 7); CX (PFX, T, LT, 8, 9); \
+  CX (PFX, T, LT, 12, 14); CX (PFX, T, LT, 1, 2);                       \
+  CX (PFX, T, LT, 3, 12); CX (PFX, T, LT, 4, 6); CX (PFX, T, LT, 5, 7); \
+  CX (PFX, T, LT, 8, 10); CX (PFX, T, LT, 9, 11);                       \
+  CX (PFX, T, LT, 13, 14); CX (PFX, T, LT, 1, 4);                       \
+  CX (PFX, T, LT, 2, 6); CX (PFX, T, LT, 5, 8); CX (PFX, T, LT, 7, 10); \
+  CX (PFX, T, LT, 9, 13); CX (PFX, T, LT, 11, 14);                      \
+  CX (PFX, T, LT, 2, 4); CX (PFX, T, LT, 3, 6); CX (PFX, T, LT, 9, 12); \
+  CX (PFX, T, LT, 11, 13); CX (PFX, T, LT, 3, 5);                       \
+  CX (PFX, T, LT, 6, 8); CX (PFX, T, LT, 7, 9);                         \
+  CX (PFX, T, LT, 10, 12); CX (PFX, T, LT, 3, 4);                       \
+  CX (PFX, T, LT, 5, 6); CX (PFX, T, LT, 7, 8); CX (PFX, T, LT, 9, 10); \
+  CX (PFX, T, LT, 11, 12); CX (PFX, T, LT, 6, 7);                       \
+  CX (PFX, T, LT, 8, 9)
+
+#define QUICKSORTS_COMMON__NETWORK_16(CX, PFX, T, LT)                   \
+  CX (PFX, T, LT, 0, 13); CX (PFX, T, LT, 1, 12);                       \
+  CX (PFX, T, LT, 2, 15); CX (PFX, T, LT, 3, 14);                       \
+  CX (PFX, T, LT, 4, 8); CX (PFX, T, LT, 5, 6); CX (PFX, T, LT, 7, 11); \
+  CX (PFX, T, LT, 9, 10); CX (PFX, T, LT, 0, 5); CX (PFX, T, LT, 1, 7); \
+  CX (PFX, T, LT, 2, 9); CX (PFX, T, LT, 3, 4); CX (PFX, T, LT, 6, 13); \
+  CX (PFX, T, LT, 8, 14); CX (PFX, T, LT, 10, 15);                      \
+  CX (PFX, T, LT, 11, 12); CX (PFX, T, LT, 0, 1);                       \
+  CX (PFX, T, LT, 2, 3); CX (PFX, T, LT, 4, 5); CX (PFX, T, LT, 6, 8);  \
+  CX (PFX, T, LT, 7, 9); CX (PFX, T, LT, 10, 11);                       \
+  CX (PFX, T, LT, 12, 13); CX (PFX, T, LT, 14, 15);                     \
+  CX (PFX, T, LT, 0, 2); CX (PFX, T, LT, 1, 3); CX (PFX, T, LT, 4, 10); \
+  CX (PFX, T, LT, 5, 11); CX (PFX, T, LT, 6, 7); CX (PFX, T, LT, 8, 9); \
+  CX (PFX, T, LT, 12, 14); CX (PFX, T, LT, 13, 15);                     \
+  CX (PFX, T, LT, 1, 2); CX (PFX, T, LT, 3, 12); CX (PFX, T, LT, 4, 6); \
+  CX (PFX, T, LT, 5, 7); CX (PFX, T, LT, 8, 10);                        \
+  CX (PFX, T, LT, 9, 11); CX (PFX, T, LT, 13, 14);                      \
+  CX (PFX, T, LT, 1, 4); CX (PFX, T, LT, 2, 6); CX (PFX, T, LT, 5, 8);  \
+  CX (PFX, T, LT, 7, 10); CX (PFX, T, LT, 9, 13);                       \
+  CX (PFX, T, LT, 11, 14); CX (PFX, T, LT, 2, 4);                       \
+  CX (PFX, T, LT, 3, 6); CX (PFX, T, LT, 9, 12);                        \
+  CX (PFX, T, LT, 11, 13); CX (PFX, T, LT, 3, 5);                       \
+  CX (PFX, T, LT, 6, 8); CX (PFX, T, LT, 7, 9);                         \
+  CX (PFX, T, LT, 10, 12); CX (PFX, T, LT, 3, 4);                       \
+  CX (PFX, T, LT, 5, 6); CX (PFX, T, LT, 7, 8); CX (PFX, T, LT, 9, 10); \
+  CX (PFX, T, LT, 11, 12); CX (PFX, T, LT, 6, 7);                       \
+  CX (PFX, T, LT, 8, 9)
+
+#define QUICKSORTS_COMMON__NETWORK_SMALL(CX, PFX, T, LT)                \
+  do                                                                    \
+    {                                                                   \
+      switch (PFX##nmemb)                                               \
+        {                                                               \
+        case 2:                                                         \
+          QUICKSORTS_COMMON__NETWORK_2 (CX, PFX, T, LT);                \
+          break;                                                        \
+        case 3:                                                         \
+          QUICKSORTS_COMMON__NETWORK_3 (CX, PFX, T, LT);                \
+          break;                                                        \
+        case 4:                                                         \
+          QUICKSORTS_COMMON__NETWORK_4 (CX, PFX, T, LT);                \
+          break;                                                        \
+        case 5:                                                         \
+          QUICKSORTS_COMMON__NETWORK_5 (CX, PFX, T, LT);                \
+          break;                                                        \
+        case 6:                                                         \
+          QUICKSORTS_COMMON__NETWORK_6 (CX, PFX, T, LT);                \
+          break;                                                        \
+        case 7:                                                         \
+          QUICKSORTS_COMMON__NETWORK_7 (CX, PFX, T, LT);                \
+          break;                                                        \
+        case 8:                                                         \
+          QUICKSORTS_COMMON__NETWORK_8 (CX, PFX, T, LT);                \
+          break;                                                        \
+        case 9:                                                         \
+          QUICKSORTS_COMMON__NETWORK_9 (CX, PFX, T, LT);                \
+          break;                                                        \
+        case 10:                                                        \
+          QUICKSORTS_COMMON__NETWORK_10 (CX, PFX, T, LT);               \
+          break;                                                        \
+        case 11:                                                        \
+          QUICKSORTS_COMMON__NETWORK_11 (CX, PFX, T, LT);               \
+          break;                                                        \
+        case 12:                                                        \
+          QUICKSORTS_COMMON__NETWORK_12 (CX, PFX, T, LT);               \
+          break;                                                        \
+        case 13:                                                        \
+          QUICKSORTS_COMMON__NETWORK_13 (CX, PFX, T, LT);               \
+          break;                                                        \
+        case 14:                                                        \
+          QUICKSORTS_COMMON__NETWORK_14 (CX, PFX, T, LT);               \
+          break;                                                        \
+        case 15:                                                        \
+          QUICKSORTS_COMMON__NETWORK_15 (CX, PFX, T, LT);               \
+          break;                                                        \
+        case 16:                                                        \
+          QUICKSORTS_COMMON__NETWORK_16 (CX, PFX, T, LT);               \
+          break;                                                        \
+        default:                                                        \
+          break;                                                        \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+/*
+  Batcher's merge exchange, as given by Donald E. Knuth, The Art of
+  Computer Programming, Volume 3, 2nd edition, Section 5.2.2,
+  Algorithm M. It is a sorting network for any number of elements:
+  the sequence of compare-exchanges does not depend on the data. In
+  each round, each element i whose bit p equals r is compared with
+  the element d places on. It is used for seventeen elements or
+  more.
+*/
+
+#define QUICKSORTS_COMMON__NETWORK_SORT(PFX, LT)                        \
+  do                                                                    \
+    {                                                                   \
+      if (PFX##nmemb <= 16)                                             \
+        QUICKSORTS_COMMON__NETWORK_SMALL                                \
+          (QUICKSORTS_COMMON__NETWORK_CX, PFX, char, LT);               \
+      else                                                              \
+        {                                                               \
+          size_t PFX##top = 1;                                          \
+          while (PFX##top < PFX##nmemb - PFX##top)                      \
+            PFX##top <<= 1;                                             \
+          for (size_t PFX##p = PFX##top; PFX##p != 0; PFX##p >>= 1)     \
+            {                                                           \
+              size_t PFX##q = PFX##top;                                 \
+              size_t PFX##r = 0;                                        \
+              size_t PFX##d = PFX##p;                                   \
+              for (;;)                                                  \
+                {                                                       \
+                  for (size_t PFX##b = PFX##r;                          \
+                       PFX##b + PFX##d < PFX##nmemb;                    \
+                       PFX##b += 2 * PFX##p)                            \
+                    for (size_t PFX##i = PFX##b;                        \
+                         PFX##i != PFX##b + PFX##p                      \
+                           && PFX##i + PFX##d < PFX##nmemb;             \
+                         PFX##i += 1)                                   \
+                      {                                                 \
+                        char *PFX##pi =                                 \
+                          PFX##arr + (PFX##elemsz * PFX##i);            \
+                        char *PFX##pj =                                 \
+                          PFX##pi + (PFX##elemsz * PFX##d);             \
+                        if (LT ((const void *) PFX##pj,                 \
+                                (const void *) PFX##pi))                \
+                          quicksorts_common__elem_swap                  \
+                            (PFX##pi, PFX##pj, PFX##elemsz);            \
+                      }                                                 \
+                  if (PFX##q == PFX##p)                                 \
+                    break;                                              \
+                  PFX##d = PFX##q - PFX##p;                             \
+                  PFX##q >>= 1;                                         \
+                  PFX##r = PFX##p;                                      \
+                }                                                       \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS_COMMON__NETWORK_SORT__TYPED(PFX, T, LT)              \
+  do                                                                    \
+    {                                                                   \
+      if (PFX##nmemb <= 16)                                             \
+        QUICKSORTS_COMMON__NETWORK_SMALL                                \
+          (QUICKSORTS_COMMON__NETWORK_CX__TYPED, PFX, T, LT);           \
+      else                                                              \
+        {                                                               \
+          size_t PFX##top = 1;                                          \
+          while (PFX##top < PFX##nmemb - PFX##top)                      \
+            PFX##top <<= 1;                                             \
+          for (size_t PFX##p = PFX##top; PFX##p != 0; PFX##p >>= 1)     \
+            {                                                           \
+              size_t PFX##q = PFX##top;                                 \
+              size_t PFX##r = 0;                                        \
+              size_t PFX##d = PFX##p;                                   \
+              for (;;)                                                  \
+                {                                                       \
+                  for (size_t PFX##b = PFX##r;                          \
+                       PFX##b + PFX##d < PFX##nmemb;                    \
+                       PFX##b += 2 * PFX##p)                            \
+                    for (size_t PFX##i = PFX##b;                        \
+                         PFX##i != PFX##b + PFX##p                      \
+                           && PFX##i + PFX##d < PFX##nmemb;             \
+                         PFX##i += 1)                                   \
+                      {                                                 \
+                        T *PFX##pi = ((T *) PFX##arr) + PFX##i;         \
+                        T *PFX##pj = PFX##pi + PFX##d;                  \
+                        /* Written as selections, so the compiler */    \
+                        /* can make the exchange branch-free.     */    \
+                        const bool PFX##x = LT (PFX##pj, PFX##pi);      \
+                        T PFX##lo = PFX##x ? *PFX##pj : *PFX##pi;       \
+                        T PFX##hi = PFX##x ? *PFX##pi : *PFX##pj;       \
+                        *PFX##pi = PFX##lo;                             \
+                        *PFX##pj = PFX##hi;                             \
+                      }                                                 \
+                  if (PFX##q == PFX##p)                                 \
+                    break;                                              \
+                  PFX##d = PFX##q - PFX##p;                             \
+                  PFX##q >>= 1;                                         \
+                  PFX##r = PFX##p;                                      \
+                }                                                       \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+/*------------------------------------------------------------------*/
+/* Heapsort, for when quicksort partitioning has gone on too long.  */
+
+/* A partitioning budget of twice the floor of log2(nmemb), as in
+   David R. Musser, "Introspective sorting and selection algorithms",
+   Software: Practice and Experience, 27(8), 1997, pp. 983-993. */
+quicksorts_common__inline int
+quicksorts_common__depth_limit (size_t nmemb)
+{
+  int lg = 0;
+  while (nmemb >>= 1)
+    lg += 1;
+  return 2 * lg;
+}
+
+/* Sift the element at index ROOT down a max-heap occupying indices
+   0 through END - 1. */
+#define QUICKSORTS_COMMON__SIFT_DOWN(PFX, LT, ROOT, END)                \
+  do                                                                    \
+    {                                                                   \
+      size_t PFX##root = (ROOT);                                        \
+      const size_t PFX##end = (END);                                    \
+      size_t PFX##child = (2 * PFX##root) + 1;                          \
+      while (PFX##child < PFX##end)                                     \
+        {                                                               \
+          char *PFX##p_child = PFX##arr + (PFX##elemsz * PFX##child);   \
+          if (PFX##child + 1 < PFX##end &&                              \
+              LT ((const void *) PFX##p_child,                          \
+                  (const void *) (PFX##p_child + PFX##elemsz)))         \
+            {                                                           \
+              PFX##child += 1;                                          \
+              PFX##p_child += PFX##elemsz;                              \
+            }                                                           \
+          char *PFX##p_root = PFX##arr + (PFX##elemsz * PFX##root);     \
+          if (!(LT ((const void *) PFX##p_root,                         \
+                    (const void *) PFX##p_child)))                      \
+            break;                                                      \
+          quicksorts_common__elem_swap                                  \
+            (PFX##p_root, PFX##p_child, PFX##elemsz);                   \
+          PFX##root = PFX##child;                                       \
+          PFX##child = (2 * PFX##root) + 1;                             \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS_COMMON__SIFT_DOWN__TYPED(PFX, T, LT, ROOT, END)      \
+  do                                                                    \
+    {                                                                   \
+      size_t PFX##root = (ROOT);                                        \
+      const size_t PFX##end = (END);                                    \
+      size_t PFX##child = (2 * PFX##root) + 1;                          \
+      while (PFX##child < PFX##end)                                     \
+        {                                                               \
+          if (PFX##child + 1 < PFX##end &&                              \
+              LT (PFX##arr + PFX##child, PFX##arr + PFX##child + 1))    \
+            PFX##child += 1;                                            \
+          if (!(LT (PFX##arr + PFX##root, PFX##arr + PFX##child)))      \
+            break;                                                      \
+          QUICKSORTS_COMMON__ELEM_SWAP__TYPED                           \
+            (PFX, T, PFX##arr + PFX##root, PFX##arr + PFX##child);      \
+          PFX##root = PFX##child;                                       \
+          PFX##child = (2 * PFX##root) + 1;                             \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS_COMMON__HEAPSORT(PFX, LT)                            \
+  do                                                                    \
+    {                                                                   \
+      if (PFX##nmemb > 1)                                               \
+        {                                                               \
+          for (size_t PFX##i = PFX##nmemb >> 1; PFX##i != 0;            \
+               PFX##i -= 1)                                             \
+            QUICKSORTS_COMMON__SIFT_DOWN                                \
+              (PFX, LT, PFX##i - 1, PFX##nmemb);                        \
+          for (size_t PFX##i = PFX##nmemb - 1; PFX##i != 0;             \
+               PFX##i -= 1)                                             \
+            {                                                           \
+              quicksorts_common__elem_swap                              \
+                (PFX##arr, PFX##arr + (PFX##elemsz * PFX##i),           \
+                 PFX##elemsz);                                          \
+              QUICKSORTS_COMMON__SIFT_DOWN                              \
+                (PFX, LT, 0, PFX##i);                                   \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS_COMMON__HEAPSORT__TYPED(PFX, T, LT)                  \
+  do                                                                    \
+    {                                                                   \
+      if (PFX##nmemb > 1)                                               \
+        {                                                               \
+          for (size_t PFX##i = PFX##nmemb >> 1; PFX##i != 0;            \
+               PFX##i -= 1)                                             \
+            QUICKSORTS_COMMON__SIFT_DOWN__TYPED                         \
+              (PFX, T, LT, PFX##i - 1, PFX##nmemb);                     \
+          for (size_t PFX##i = PFX##nmemb - 1; PFX##i != 0;             \
+               PFX##i -= 1)                                             \
+            {                                                           \
+              QUICKSORTS_COMMON__ELEM_SWAP__TYPED                       \
+                (PFX, T, PFX##arr, PFX##arr + PFX##i);                  \
+              QUICKSORTS_COMMON__SIFT_DOWN__TYPED                       \
+                (PFX, T, LT, 0, PFX##i);                                \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+/*------------------------------------------------------------------*/
+/* Putting elements in the order of a sorted array of pointers.     */
+
+/* The pointer to the element that belongs at index i is stored at
+   ptrs + (i * stride), so the pointers may be members of larger
+   records. Follow each cycle of the permutation from its leader,
+   which is set aside in tmp (elemsz bytes), so that each element is
+   moved only once. The pointers are overwritten, and nothing else in
+   their records. */
+quicksorts_common__inline void
+quicksorts_common__permute_by_strided_pointers (char *base, size_t nmemb,
+                                                size_t elemsz, char *ptrs,
+                                                size_t stride, char *tmp)
+{
+  for (size_t i = 0; i != nmemb; i += 1)
+    {
+      char *p_i = base + (i * elemsz);
+      char **pp_i = (char **) (ptrs + (i * stride));
+      if (*pp_i != p_i)
+        {
+          QUICKSORTS_COMMON__MEMCPY (tmp, p_i, elemsz);
+          char **pp_j = pp_i;
+          char *p_j = p_i;
+          char *p_src = *pp_j;
+          while (p_src != p_i)
+            {
+              QUICKSORTS_COMMON__MEMCPY (p_j, p_src, elemsz);
+              *pp_j = p_j;
+              pp_j = (char **)
+                (ptrs + (((size_t) (p_src - base) / elemsz) * stride));
+              p_j = p_src;
+              p_src = *pp_j;
+            }
+          QUICKSORTS_COMMON__MEMCPY (p_j, tmp, elemsz);
+          *pp_j = p_j;
+        }
+    }
+}
+
+/* ptrs[i] points to the element that belongs at index i. */
+quicksorts_common__inline void
+quicksorts_common__permute_by_pointers (char *base, size_t nmemb,
+                                        size_t elemsz, char **ptrs,
+                                        char *tmp)
+{
+  quicksorts_common__permute_by_strided_pointers
+    (base, nmemb, elemsz, (char *) ptrs, sizeof *ptrs, tmp);
+}
+
+/*------------------------------------------------------------------*/
+/* The stack of subarrays yet to be sorted. Each entry carries the  */
+/* depth budget that remains for its subarray.                      */
+
+#define QUICKSORTS_COMMON__STK_MAKE(PFX)                            \
+  typedef struct {void *p; size_t n; int depth;} PFX##stk_entry_t;  \
+  PFX##stk_entry_t PFX##stk[CHAR_BIT * sizeof (size_t)];            \
+  QUICKSORTS_COMMON__MEMSET                                         \
+  (PFX##stk, 0,                                                     \
+   CHAR_BIT * sizeof (size_t) * sizeof (PFX##stk_entry_t));         \
   int PFX##stk_depth = 0
 
-#define QUICKSORTS_COMMON__STK_PUSH(PFX, P, N)                  \
+#define QUICKSORTS_COMMON__STK_PUSH(PFX, P, N, DEPTH)           \
   do                                                            \
     {                                                           \
       assert (PFX##stk_depth < CHAR_BIT * sizeof (size_t));     \
       PFX##stk_depth += 1;                                      \
+      QUICKSORTS_COMMON__STATS_STACK_DEPTH (PFX##stk_depth);    \
       PFX##stk_entry_t PFX##entry;                              \
       PFX##entry.p = (P);                                       \
       PFX##entry.n = (N);                                       \
+      PFX##entry.depth = (DEPTH);                               \
       PFX##stk[(CHAR_BIT * sizeof (size_t)) - PFX##stk_depth] = \
         PFX##entry;                                             \
     }                                                           \
@@ -629,6 +1477,7 @@ quicksorts_common__subcirculate_right_with_gap (char *p_left,
         PFX##stk[(CHAR_BIT * sizeof (size_t)) - PFX##stk_depth];    \
       PFX##arr = PFX##entry.p;                                      \
       PFX##nmemb = PFX##entry.n;                                    \
+      PFX##depth = PFX##entry.depth;                                \
       PFX##stk_depth -= 1;                                          \
     }                                                               \
   while (0)
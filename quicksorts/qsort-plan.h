@@ -0,0 +1,91 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef QUICKSORTS__QSORT_PLAN_H__HEADER_GUARD__
+#define QUICKSORTS__QSORT_PLAN_H__HEADER_GUARD__
+
+#include <stdlib.h>
+
+/*
+  Plans, for sorting many arrays of the same shape.
+
+  quicksorts_plan_create decides once how arrays of elements of a
+  given size are to be sorted: by which sort, instantiated for which
+  element size, with which small-subarray cutoff. It sets aside the
+  scratch memory that arrays of up to size_hint elements need, and
+  starts the threads of a parallel sort. quicksorts_plan_execute then
+  sorts with no allocation and no choosing. An array longer than the
+  hint is sorted all the same, but may allocate, and so may a
+  parallel plan (see QUICKSORTS_PLAN_PARALLEL).
+
+  A plan owns its scratch memory, so only one thread at a time may
+  execute it. Threads that sort concurrently should each have a plan.
+
+  quicksorts_plan_create returns NULL if elemsz is zero or too small
+  for the key, or if there is no memory for the plan.
+*/
+
+typedef struct quicksorts_plan quicksorts_plan;
+
+/* What the elements are ordered by. With QUICKSORTS_KEY_COMPAR, the
+   comparison function alone gives the order. With the others, each
+   element begins with a key of the given type, which need not be
+   aligned, and the elements are ordered by ascending key; elements
+   whose keys are equal are ordered by the comparison function, if it
+   is not NULL. Negative zero comes before positive, and NaNs go to
+   the ends.
+
+   If the element is nothing but the key, the array is sorted as by
+   unstable_sort_int32 and its kin, which leave NaNs in no particular
+   order, and the comparison function is not called. */
+enum quicksorts_key
+{
+  QUICKSORTS_KEY_COMPAR,
+  QUICKSORTS_KEY_INT32,
+  QUICKSORTS_KEY_UINT32,
+  QUICKSORTS_KEY_INT64,
+  QUICKSORTS_KEY_UINT64,
+  QUICKSORTS_KEY_FLOAT,
+  QUICKSORTS_KEY_DOUBLE
+};
+
+/* Keep equal elements in their original order. */
+#define QUICKSORTS_PLAN_STABLE 0x1U
+
+/* Sort arrays long enough to be worth it on the thread pool of
+   unstable_qsort_r_parallel, whose threads are started when the plan
+   is created. The plan sets aside no scratch memory for them, nor
+   fixes their small-subarray cutoff: each execution sorts as
+   unstable_qsort_r_parallel does, with the library's defaults, and
+   the sorts on the threads allocate their merge buffers and
+   temporaries from malloc. This applies only to unstable sorts with
+   QUICKSORTS_KEY_COMPAR. */
+#define QUICKSORTS_PLAN_PARALLEL 0x2U
+
+quicksorts_plan *quicksorts_plan_create (size_t elemsz,
+                                         enum quicksorts_key key,
+                                         size_t size_hint,
+                                         unsigned int flags);
+void quicksorts_plan_execute (quicksorts_plan *plan,
+                              void *base, size_t nmemb,
+                              int (*compar) (const void *,
+                                             const void *, void *),
+                              void *arg);
+void quicksorts_plan_destroy (quicksorts_plan *plan);
+
+#endif /* QUICKSORTS__QSORT_PLAN_H__HEADER_GUARD__ */
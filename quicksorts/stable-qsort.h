@@ -0,0 +1,33 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef QUICKSORTS__STABLE_QSORT_H__HEADER_GUARD__
+#define QUICKSORTS__STABLE_QSORT_H__HEADER_GUARD__
+
+#include <stdlib.h>
+
+/* Stable sorts with the interfaces of qsort and qsort_r. They
+   allocate a buffer of nmemb + 1 elements. */
+void stable_qsort (void *base, size_t nmemb, size_t size,
+                   int (*compar) (const void *, const void *));
+void stable_qsort_r (void *base, size_t nmemb, size_t size,
+                     int (*compar) (const void *, const void *,
+                                    void *),
+                     void *arg);
+
+#endif /* QUICKSORTS__STABLE_QSORT_H__HEADER_GUARD__ */
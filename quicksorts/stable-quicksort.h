@@ -0,0 +1,606 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef QUICKSORTS__STABLE_QUICKSORT_H__HEADER_GUARD__
+#define QUICKSORTS__STABLE_QUICKSORT_H__HEADER_GUARD__
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <quicksorts/internal/quicksorts-common.h>
+
+/*
+  Stable quicksorts. A scratch buffer of nmemb + 1 elements is
+  allocated for the whole sort. Partitioning is three-way: elements
+  less than the pivot are packed, in order, at the front of the
+  subarray; elements equal to it are collected, in order, at the
+  front of the buffer, and elements greater than it at the back; then
+  both are copied back. Subarrays that exhaust their partitioning
+  budget are finished with a bottom-up merge sort through the same
+  buffer.
+
+  SMALL_SORT must be stable. The insertion sorts below are; the
+  unstable Shell sort, heapsort and sorting networks are not.
+
+  If the buffer cannot be allocated, the array is sorted by insertion
+  sort alone, which is stable but takes quadratic time.
+*/
+
+/* Like the unstable version, but a decreasing prefix is taken only
+   while it is strictly decreasing, so that reversing it cannot
+   reorder equal elements. */
+#define QUICKSORTS__STABLE_QUICKSORT__MAKE_AN_ORDERED_PREFIX(PFX, LT)   \
+  do                                                                    \
+    {                                                                   \
+      PFX##pfx_len = 2;                                                 \
+      char *PFX##p = PFX##arr + (PFX##elemsz * 2);                      \
+                                                                        \
+      if (!(LT ((const void *) (PFX##arr + PFX##elemsz),                \
+                (const void *) PFX##arr)))                              \
+        {                                                               \
+          /* Non-decreasing order. */                                   \
+          while (PFX##pfx_len < PFX##nmemb &&                           \
+                 !(LT ((void *) PFX##p,                                 \
+                       (void *) (PFX##p - PFX##elemsz))))               \
+            {                                                           \
+              PFX##pfx_len += 1;                                        \
+              PFX##p += PFX##elemsz;                                    \
+            }                                                           \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          /* Strictly decreasing order. */                              \
+          while (PFX##pfx_len < PFX##nmemb &&                           \
+                 LT ((void *) PFX##p,                                   \
+                     (void *) (PFX##p - PFX##elemsz)))                  \
+            {                                                           \
+              PFX##pfx_len += 1;                                        \
+              PFX##p += PFX##elemsz;                                    \
+            }                                                           \
+          quicksorts_common__reverse_prefix                             \
+            (PFX##arr, PFX##pfx_len, PFX##elemsz);                      \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__STABLE_QUICKSORT__MAKE_AN_ORDERED_PREFIX__TYPED(PFX, \
+                                                                    T,  \
+                                                                    LT) \
+  do                                                                    \
+    {                                                                   \
+      PFX##pfx_len = 2;                                                 \
+      T *PFX##p = PFX##arr + 2;                                         \
+                                                                        \
+      if (!(LT (PFX##arr + 1, PFX##arr)))                               \
+        {                                                               \
+          /* Non-decreasing order. */                                   \
+          while (PFX##pfx_len < PFX##nmemb &&                           \
+                 !(LT (PFX##p, PFX##p - 1)))                            \
+            {                                                           \
+              PFX##pfx_len += 1;                                        \
+              PFX##p += 1;                                              \
+            }                                                           \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          /* Strictly decreasing order. */                              \
+          while (PFX##pfx_len < PFX##nmemb &&                           \
+                 LT (PFX##p, PFX##p - 1))                               \
+            {                                                           \
+              PFX##pfx_len += 1;                                        \
+              PFX##p += 1;                                              \
+            }                                                           \
+          QUICKSORTS_COMMON__REVERSE_PREFIX__TYPED                      \
+            (PFX, T, PFX##arr, PFX##pfx_len);                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+/* The insertion position is found after any equal elements, so the
+   insertion sort is stable. */
+#define QUICKSORTS__STABLE_QUICKSORT__INSERTION_SORT(PFX, BASE, NMEMB,  \
+                                                     ELEMSZ, LT,        \
+                                                     SMALL_SIZE)        \
+  do                                                                    \
+    {                                                                   \
+      char *PFX##insertion_sort__arr = (void *) (BASE);                 \
+      size_t PFX##insertion_sort__nmemb = (size_t) (NMEMB);             \
+      size_t PFX##insertion_sort__elemsz = (size_t) (ELEMSZ);           \
+      QUICKSORTS_COMMON__INSERTION_SORT                                 \
+        (PFX##insertion_sort__, LT, SMALL_SIZE,                         \
+         QUICKSORTS__STABLE_QUICKSORT__MAKE_AN_ORDERED_PREFIX);         \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__STABLE_QUICKSORT__INSERTION_SORT__TYPED(PFX, T,     \
+                                                            BASE,       \
+                                                            NMEMB, LT,  \
+                                                            SMALL_SIZE) \
+  do                                                                    \
+    {                                                                   \
+      T *PFX##insertion_sort__arr = (T *) (BASE);                       \
+      size_t PFX##insertion_sort__nmemb = (size_t) (NMEMB);             \
+      QUICKSORTS_COMMON__INSERTION_SORT__TYPED                          \
+        (PFX##insertion_sort__, T, LT, SMALL_SIZE,                      \
+         QUICKSORTS__STABLE_QUICKSORT__MAKE_AN_ORDERED_PREFIX__TYPED);  \
+    }                                                                   \
+  while (0)
+
+/* A bottom-up merge sort of PFX##arr, with runs of SMALL_SIZE sorted
+   by SMALL_SORT. Each merge copies the left run into PFX##buf. */
+#define QUICKSORTS__STABLE_QUICKSORT__MERGE_SORT(PFX, LT, SMALL_SIZE,   \
+                                                 SMALL_SORT)            \
+  do                                                                    \
+    {                                                                   \
+      const size_t PFX##run = ((SMALL_SIZE) < 1) ? 1 : (SMALL_SIZE);    \
+      for (size_t PFX##lo = 0; PFX##lo < PFX##nmemb;                    \
+           PFX##lo += PFX##run)                                         \
+        {                                                               \
+          const size_t PFX##n_run =                                     \
+            (PFX##nmemb - PFX##lo < PFX##run) ?                         \
+            PFX##nmemb - PFX##lo : PFX##run;                            \
+          SMALL_SORT (PFX##run__,                                       \
+                      PFX##arr + (PFX##lo * PFX##elemsz),               \
+                      PFX##n_run, PFX##elemsz, LT, (SMALL_SIZE));       \
+        }                                                               \
+      for (size_t PFX##w = PFX##run; PFX##w < PFX##nmemb;               \
+           PFX##w *= 2)                                                 \
+        for (size_t PFX##lo = 0; PFX##lo + PFX##w < PFX##nmemb;         \
+             PFX##lo += 2 * PFX##w)                                     \
+          {                                                             \
+            char *PFX##left = PFX##arr + (PFX##lo * PFX##elemsz);       \
+            char *PFX##mid = PFX##left + (PFX##w * PFX##elemsz);        \
+            const size_t PFX##hi =                                      \
+              (PFX##nmemb - PFX##lo <= 2 * PFX##w) ?                    \
+              PFX##nmemb : PFX##lo + (2 * PFX##w);                      \
+            char *PFX##end = PFX##arr + (PFX##hi * PFX##elemsz);        \
+            /* Skip runs that are already in order. */                  \
+            if (LT ((const void *) PFX##mid,                            \
+                    (const void *) (PFX##mid - PFX##elemsz)))           \
+              {                                                         \
+                const size_t PFX##nbytes = PFX##mid - PFX##left;        \
+                QUICKSORTS_COMMON__MEMCPY (PFX##buf, PFX##left,         \
+                                           PFX##nbytes);                \
+                char *PFX##a = PFX##buf;                                \
+                char *PFX##a_end = PFX##buf + PFX##nbytes;              \
+                char *PFX##b = PFX##mid;                                \
+                char *PFX##out = PFX##left;                             \
+                while (PFX##a != PFX##a_end && PFX##b != PFX##end)      \
+                  {                                                     \
+                    if (LT ((const void *) PFX##b,                      \
+                            (const void *) PFX##a))                     \
+                      {                                                 \
+                        QUICKSORTS_COMMON__MEMCPY                       \
+                          (PFX##out, PFX##b, PFX##elemsz);              \
+                        PFX##b += PFX##elemsz;                          \
+                      }                                                 \
+                    else                                                \
+                      {                                                 \
+                        QUICKSORTS_COMMON__MEMCPY                       \
+                          (PFX##out, PFX##a, PFX##elemsz);              \
+                        PFX##a += PFX##elemsz;                          \
+                      }                                                 \
+                    PFX##out += PFX##elemsz;                            \
+                  }                                                     \
+                QUICKSORTS_COMMON__MEMCPY (PFX##out, PFX##a,            \
+                                           PFX##a_end - PFX##a);        \
+              }                                                         \
+          }                                                             \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__STABLE_QUICKSORT__MERGE_SORT__TYPED(PFX, T, LT,     \
+                                                        SMALL_SIZE,     \
+                                                        SMALL_SORT)     \
+  do                                                                    \
+    {                                                                   \
+      const size_t PFX##run = ((SMALL_SIZE) < 1) ? 1 : (SMALL_SIZE);    \
+      for (size_t PFX##lo = 0; PFX##lo < PFX##nmemb;                    \
+           PFX##lo += PFX##run)                                         \
+        {                                                               \
+          const size_t PFX##n_run =                                     \
+            (PFX##nmemb - PFX##lo < PFX##run) ?                         \
+            PFX##nmemb - PFX##lo : PFX##run;                            \
+          SMALL_SORT (PFX##run__, T, PFX##arr + PFX##lo, PFX##n_run,    \
+                      LT, (SMALL_SIZE));                                \
+        }                                                               \
+      for (size_t PFX##w = PFX##run; PFX##w < PFX##nmemb;               \
+           PFX##w *= 2)                                                 \
+        for (size_t PFX##lo = 0; PFX##lo + PFX##w < PFX##nmemb;         \
+             PFX##lo += 2 * PFX##w)                                     \
+          {                                                             \
+            T *PFX##left = PFX##arr + PFX##lo;                          \
+            T *PFX##mid = PFX##left + PFX##w;                           \
+            T *PFX##end = (PFX##nmemb - PFX##lo <= 2 * PFX##w) ?        \
+              PFX##arr + PFX##nmemb : PFX##mid + PFX##w;                \
+            /* Skip runs that are already in order. */                  \
+            if (LT (PFX##mid, PFX##mid - 1))                            \
+              {                                                         \
+                for (size_t PFX##i = 0; PFX##i != PFX##w; PFX##i += 1)  \
+                  PFX##buf[PFX##i] = PFX##left[PFX##i];                 \
+                T *PFX##a = PFX##buf;                                   \
+                T *PFX##a_end = PFX##buf + PFX##w;                      \
+                T *PFX##b = PFX##mid;                                   \
+                T *PFX##out = PFX##left;                                \
+                while (PFX##a != PFX##a_end && PFX##b != PFX##end)      \
+                  {                                                     \
+                    if (LT (PFX##b, PFX##a))                            \
+                      *PFX##out++ = *PFX##b++;                          \
+                    else                                                \
+                      *PFX##out++ = *PFX##a++;                          \
+                  }                                                     \
+                while (PFX##a != PFX##a_end)                            \
+                  *PFX##out++ = *PFX##a++;                              \
+              }                                                         \
+          }                                                             \
+    }                                                                   \
+  while (0)
+
+/* A stable three-way partition through PFX##buf. The pivot is copied
+   to the end of the buffer first, since its place in the subarray
+   may be overwritten. */
+#define QUICKSORTS__STABLE_QUICKSORT__PARTITION(PFX, LT,                \
+                                                PIVOT_SELECTION)        \
+  do                                                                    \
+    {                                                                   \
+      size_t PFX##i_selected;                                           \
+      PIVOT_SELECTION (PFX##arr, PFX##nmemb, PFX##elemsz, LT,           \
+                       PFX##i_selected);                                \
+      char *PFX##pv = PFX##buf + (PFX##nmemb * PFX##elemsz);            \
+      QUICKSORTS_COMMON__MEMCPY                                         \
+        (PFX##pv, PFX##arr + (PFX##i_selected * PFX##elemsz),           \
+         PFX##elemsz);                                                  \
+                                                                        \
+      char *PFX##p_lt = PFX##arr;                                       \
+      char *PFX##p_eq = PFX##buf;                                       \
+      char *PFX##p_gt = PFX##pv;                                        \
+      char *const PFX##p_end =                                          \
+        PFX##arr + (PFX##nmemb * PFX##elemsz);                          \
+      for (char *PFX##p = PFX##arr; PFX##p != PFX##p_end;               \
+           PFX##p += PFX##elemsz)                                       \
+        {                                                               \
+          if (LT ((const void *) PFX##p, (const void *) PFX##pv))       \
+            {                                                           \
+              if (PFX##p_lt != PFX##p)                                  \
+                QUICKSORTS_COMMON__MEMCPY (PFX##p_lt, PFX##p,           \
+                                           PFX##elemsz);                \
+              PFX##p_lt += PFX##elemsz;                                 \
+            }                                                           \
+          else if (LT ((const void *) PFX##pv, (const void *) PFX##p))  \
+            {                                                           \
+              PFX##p_gt -= PFX##elemsz;                                 \
+              QUICKSORTS_COMMON__MEMCPY (PFX##p_gt, PFX##p,             \
+                                         PFX##elemsz);                  \
+            }                                                           \
+          else                                                          \
+            {                                                           \
+              QUICKSORTS_COMMON__MEMCPY (PFX##p_eq, PFX##p,             \
+                                         PFX##elemsz);                  \
+              PFX##p_eq += PFX##elemsz;                                 \
+            }                                                           \
+        }                                                               \
+                                                                        \
+      const size_t PFX##eq_bytes = PFX##p_eq - PFX##buf;                \
+      QUICKSORTS_COMMON__MEMCPY (PFX##p_lt, PFX##buf, PFX##eq_bytes);   \
+      /* The greater elements were stored back to front. */             \
+      char *PFX##q = PFX##p_lt + PFX##eq_bytes;                         \
+      for (char *PFX##r = PFX##pv; PFX##r != PFX##p_gt;                 \
+           PFX##q += PFX##elemsz)                                       \
+        {                                                               \
+          PFX##r -= PFX##elemsz;                                        \
+          QUICKSORTS_COMMON__MEMCPY (PFX##q, PFX##r, PFX##elemsz);      \
+        }                                                               \
+                                                                        \
+      PFX##p_pivot = PFX##p_lt;                                         \
+      PFX##i_pivot = (PFX##p_lt - PFX##arr) / PFX##elemsz;              \
+      PFX##n_pivot = PFX##eq_bytes / PFX##elemsz;                       \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__STABLE_QUICKSORT__PARTITION__TYPED(PFX, T, LT,      \
+                                                       PIVOT_SELECTION) \
+  do                                                                    \
+    {                                                                   \
+      size_t PFX##i_selected;                                           \
+      PIVOT_SELECTION (PFX##arr, PFX##nmemb, sizeof (T), LT,            \
+                       PFX##i_selected);                                \
+      T *PFX##pv = PFX##buf + PFX##nmemb;                               \
+      *PFX##pv = PFX##arr[PFX##i_selected];                             \
+                                                                        \
+      T *PFX##p_lt = PFX##arr;                                          \
+      T *PFX##p_eq = PFX##buf;                                          \
+      T *PFX##p_gt = PFX##pv;                                           \
+      T *const PFX##p_end = PFX##arr + PFX##nmemb;                      \
+      for (T *PFX##p = PFX##arr; PFX##p != PFX##p_end; PFX##p += 1)     \
+        {                                                               \
+          if (LT (PFX##p, PFX##pv))                                     \
+            *PFX##p_lt++ = *PFX##p;                                     \
+          else if (LT (PFX##pv, PFX##p))                                \
+            *--PFX##p_gt = *PFX##p;                                     \
+          else                                                          \
+            *PFX##p_eq++ = *PFX##p;                                     \
+        }                                                               \
+                                                                        \
+      PFX##p_pivot = PFX##p_lt;                                         \
+      PFX##i_pivot = PFX##p_lt - PFX##arr;                              \
+      PFX##n_pivot = PFX##p_eq - PFX##buf;                              \
+      T *PFX##q = PFX##p_lt;                                            \
+      for (T *PFX##r = PFX##buf; PFX##r != PFX##p_eq; PFX##r += 1)      \
+        *PFX##q++ = *PFX##r;                                            \
+      /* The greater elements were stored back to front. */             \
+      for (T *PFX##r = PFX##pv; PFX##r != PFX##p_gt;)                   \
+        *PFX##q++ = *--PFX##r;                                          \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__STABLE_QUICKSORT__QUICKSORT(PFX, BASE, NMEMB,       \
+                                                ELEMSZ, LT,             \
+                                                PIVOT_SELECTION,        \
+                                                SMALL_SIZE,             \
+                                                SMALL_SORT)             \
+  do                                                                    \
+    {                                                                   \
+      char *PFX##arr = (void *) (BASE);                                 \
+      size_t PFX##nmemb = (size_t) (NMEMB);                             \
+      size_t PFX##elemsz = (size_t) (ELEMSZ);                           \
+                                                                        \
+      char *PFX##buf = NULL;                                            \
+      if (0 < PFX##elemsz && (SMALL_SIZE) < PFX##nmemb                  \
+          && PFX##nmemb < (SIZE_MAX / PFX##elemsz))                     \
+        PFX##buf = QUICKSORTS_COMMON__MALLOC                            \
+          ((PFX##nmemb + 1) * PFX##elemsz);                             \
+                                                                        \
+      if (0 < PFX##elemsz && 2 <= PFX##nmemb                            \
+          && (PFX##nmemb <= (SMALL_SIZE) || PFX##buf == NULL))          \
+        {                                                               \
+          /* Too small to partition, or there is no buffer. */          \
+          if (PFX##nmemb <= (SMALL_SIZE))                               \
+            SMALL_SORT (PFX, PFX##arr, PFX##nmemb, PFX##elemsz,         \
+                        LT, (SMALL_SIZE));                              \
+          else                                                          \
+            QUICKSORTS__STABLE_QUICKSORT__INSERTION_SORT                \
+              (PFX, PFX##arr, PFX##nmemb, PFX##elemsz, LT,              \
+               (SMALL_SIZE));                                           \
+        }                                                               \
+      else if (0 < PFX##elemsz && 2 <= PFX##nmemb)                      \
+        {                                                               \
+          size_t PFX##i_pivot;                                          \
+          size_t PFX##n_pivot;                                          \
+          char *PFX##p_pivot;                                           \
+          int PFX##depth;                                               \
+                                                                        \
+          QUICKSORTS_COMMON__STK_MAKE (PFX);                            \
+          QUICKSORTS_COMMON__STK_PUSH                                   \
+            (PFX, PFX##arr, PFX##nmemb,                                 \
+             quicksorts_common__depth_limit (PFX##nmemb));              \
+          do                                                            \
+            {                                                           \
+              QUICKSORTS_COMMON__STK_POP (PFX);                         \
+              if (PFX##nmemb <= (SMALL_SIZE))                           \
+                {                                                       \
+                  SMALL_SORT (PFX, PFX##arr, PFX##nmemb, PFX##elemsz,   \
+                              LT, (SMALL_SIZE));                        \
+                }                                                       \
+              else if (PFX##depth == 0)                                 \
+                {                                                       \
+                  /* Partitioning has gone on too long. Guarantee */    \
+                  /* O(n log n) by finishing with merge sort.     */    \
+                  QUICKSORTS__STABLE_QUICKSORT__MERGE_SORT              \
+                    (PFX, LT, (SMALL_SIZE), SMALL_SORT);                \
+                }                                                       \
+              else                                                      \
+                {                                                       \
+                  QUICKSORTS__STABLE_QUICKSORT__PARTITION               \
+                    (PFX, LT, PIVOT_SELECTION);                         \
+                                                                        \
+                  /* Push the larger part of the partition first. */    \
+                  /* Otherwise the stack may overflow.            */    \
+                                                                        \
+                  size_t PFX##n_le = PFX##i_pivot;                      \
+                  size_t PFX##n_ge =                                    \
+                    PFX##nmemb - PFX##n_pivot - PFX##i_pivot;           \
+                  char *PFX##p_ge =                                     \
+                    PFX##p_pivot + (PFX##n_pivot * PFX##elemsz);        \
+                  if (PFX##n_le < PFX##n_ge)                            \
+                    {                                                   \
+                      QUICKSORTS_COMMON__STK_PUSH                       \
+                        (PFX, PFX##p_ge, PFX##n_ge, PFX##depth - 1);    \
+                      if (PFX##n_le != 0)                               \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX, PFX##arr, PFX##n_le, PFX##depth - 1);   \
+                    }                                                   \
+                  else                                                  \
+                    {                                                   \
+                      if (PFX##n_le != 0)                               \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX, PFX##arr, PFX##n_le, PFX##depth - 1);   \
+                      if (PFX##n_ge != 0)                               \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX, PFX##p_ge, PFX##n_ge, PFX##depth - 1);  \
+                    }                                                   \
+                }                                                       \
+            }                                                           \
+          while (PFX##stk_depth != 0);                                  \
+        }                                                               \
+                                                                        \
+      QUICKSORTS_COMMON__FREE (PFX##buf);                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__STABLE_QUICKSORT__QUICKSORT__TYPED(PFX, T, BASE,    \
+                                                       NMEMB, LT,       \
+                                                       PIVOT_SELECTION, \
+                                                       SMALL_SIZE,      \
+                                                       SMALL_SORT)      \
+  do                                                                    \
+    {                                                                   \
+      T *PFX##arr = (T *) (BASE);                                       \
+      size_t PFX##nmemb = (size_t) (NMEMB);                             \
+                                                                        \
+      T *PFX##buf = NULL;                                               \
+      if ((SMALL_SIZE) < PFX##nmemb                                     \
+          && PFX##nmemb < (SIZE_MAX / sizeof (T)))                      \
+        PFX##buf = QUICKSORTS_COMMON__MALLOC                            \
+          ((PFX##nmemb + 1) * sizeof (T));                              \
+                                                                        \
+      if (2 <= PFX##nmemb                                               \
+          && (PFX##nmemb <= (SMALL_SIZE) || PFX##buf == NULL))          \
+        {                                                               \
+          /* Too small to partition, or there is no buffer. */          \
+          if (PFX##nmemb <= (SMALL_SIZE))                               \
+            SMALL_SORT (PFX, T, PFX##arr, PFX##nmemb, LT,               \
+                        (SMALL_SIZE));                                  \
+          else                                                          \
+            QUICKSORTS__STABLE_QUICKSORT__INSERTION_SORT__TYPED         \
+              (PFX, T, PFX##arr, PFX##nmemb, LT, (SMALL_SIZE));         \
+        }                                                               \
+      else if (2 <= PFX##nmemb)                                         \
+        {                                                               \
+          size_t PFX##i_pivot;                                          \
+          size_t PFX##n_pivot;                                          \
+          T *PFX##p_pivot;                                              \
+          int PFX##depth;                                               \
+                                                                        \
+          QUICKSORTS_COMMON__STK_MAKE (PFX);                            \
+          QUICKSORTS_COMMON__STK_PUSH                                   \
+            (PFX, PFX##arr, PFX##nmemb,                                 \
+             quicksorts_common__depth_limit (PFX##nmemb));              \
+          do                                                            \
+            {                                                           \
+              QUICKSORTS_COMMON__STK_POP (PFX);                         \
+              if (PFX##nmemb <= (SMALL_SIZE))                           \
+                {                                                       \
+                  SMALL_SORT (PFX, T, PFX##arr, PFX##nmemb, LT,         \
+                              (SMALL_SIZE));                            \
+                }                                                       \
+              else if (PFX##depth == 0)                                 \
+                {                                                       \
+                  /* Partitioning has gone on too long. Guarantee */    \
+                  /* O(n log n) by finishing with merge sort.     */    \
+                  QUICKSORTS__STABLE_QUICKSORT__MERGE_SORT__TYPED       \
+                    (PFX, T, LT, (SMALL_SIZE), SMALL_SORT);             \
+                }                                                       \
+              else                                                      \
+                {                                                       \
+                  QUICKSORTS__STABLE_QUICKSORT__PARTITION__TYPED        \
+                    (PFX, T, LT, PIVOT_SELECTION);                      \
+                                                                        \
+                  /* Push the larger part of the partition first. */    \
+                  /* Otherwise the stack may overflow.            */    \
+                                                                        \
+                  size_t PFX##n_le = PFX##i_pivot;                      \
+                  size_t PFX##n_ge =                                    \
+                    PFX##nmemb - PFX##n_pivot - PFX##i_pivot;           \
+                  T *PFX##p_ge = PFX##p_pivot + PFX##n_pivot;           \
+                  if (PFX##n_le < PFX##n_ge)                            \
+                    {                                                   \
+                      QUICKSORTS_COMMON__STK_PUSH                       \
+                        (PFX, PFX##p_ge, PFX##n_ge, PFX##depth - 1);    \
+                      if (PFX##n_le != 0)                               \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX, PFX##arr, PFX##n_le, PFX##depth - 1);   \
+                    }                                                   \
+                  else                                                  \
+                    {                                                   \
+                      if (PFX##n_le != 0)                               \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX, PFX##arr, PFX##n_le, PFX##depth - 1);   \
+                      if (PFX##n_ge != 0)                               \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX, PFX##p_ge, PFX##n_ge, PFX##depth - 1);  \
+                    }                                                   \
+                }                                                       \
+            }                                                           \
+          while (PFX##stk_depth != 0);                                  \
+        }                                                               \
+                                                                        \
+      QUICKSORTS_COMMON__FREE (PFX##buf);                               \
+    }                                                                   \
+  while (0)
+
+#define STABLE_QUICKSORT_7ARGS(BASE, NMEMB, ELEMSZ, LT,     \
+                               PIVOT_SELECTION, SMALL_SIZE, \
+                               SMALL_SORT)                  \
+  do                                                        \
+    {                                                       \
+      QUICKSORTS__STABLE_QUICKSORT__QUICKSORT               \
+        (quicksorts__stable_quicksort__,                    \
+         (BASE), (NMEMB), (ELEMSZ),                         \
+         LT, PIVOT_SELECTION, (SMALL_SIZE), SMALL_SORT);    \
+    }                                                       \
+  while (0)
+
+#define STABLE_QUICKSORT_TYPED_7ARGS(T, BASE, NMEMB, LT,    \
+                                     PIVOT_SELECTION,       \
+                                     SMALL_SIZE, SMALL_SORT) \
+  do                                                        \
+    {                                                       \
+      QUICKSORTS__STABLE_QUICKSORT__QUICKSORT__TYPED        \
+        (quicksorts__stable_quicksort__typed__, T,          \
+         (BASE), (NMEMB), LT, PIVOT_SELECTION,              \
+         (SMALL_SIZE), SMALL_SORT);                         \
+    }                                                       \
+  while (0)
+
+#ifndef STABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION
+#define STABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION  \
+  QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE
+#endif
+
+#ifndef STABLE_QUICKSORT__DEFAULT__SMALL_SIZE
+#define STABLE_QUICKSORT__DEFAULT__SMALL_SIZE 40
+#endif
+
+#ifndef STABLE_QUICKSORT__DEFAULT__SMALL_SORT
+#define STABLE_QUICKSORT__DEFAULT__SMALL_SORT   \
+  QUICKSORTS__STABLE_QUICKSORT__INSERTION_SORT
+#endif
+
+#ifndef STABLE_QUICKSORT__DEFAULT__SMALL_SORT__TYPED
+#define STABLE_QUICKSORT__DEFAULT__SMALL_SORT__TYPED    \
+  QUICKSORTS__STABLE_QUICKSORT__INSERTION_SORT__TYPED
+#endif
+
+#define STABLE_QUICKSORT_4ARGS(BASE, NMEMB, ELEMSZ, LT)     \
+  do                                                        \
+    {                                                       \
+      QUICKSORTS__STABLE_QUICKSORT__QUICKSORT               \
+        (quicksorts__stable_quicksort__,                    \
+         (BASE), (NMEMB), (ELEMSZ), LT,                     \
+         STABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION,        \
+         (STABLE_QUICKSORT__DEFAULT__SMALL_SIZE),           \
+         STABLE_QUICKSORT__DEFAULT__SMALL_SORT);            \
+    }                                                       \
+  while (0)
+
+#define STABLE_QUICKSORT_TYPED_4ARGS(T, BASE, NMEMB, LT)    \
+  do                                                        \
+    {                                                       \
+      QUICKSORTS__STABLE_QUICKSORT__QUICKSORT__TYPED        \
+        (quicksorts__stable_quicksort__typed__,             \
+         T, (BASE), (NMEMB), LT,                            \
+         STABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION,        \
+         (STABLE_QUICKSORT__DEFAULT__SMALL_SIZE),           \
+         STABLE_QUICKSORT__DEFAULT__SMALL_SORT__TYPED);     \
+    }                                                       \
+  while (0)
+
+#define STABLE_QUICKSORT STABLE_QUICKSORT_4ARGS
+#define STABLE_QUICKSORT_TYPED STABLE_QUICKSORT_TYPED_4ARGS
+
+#endif /* QUICKSORTS__STABLE_QUICKSORT_H__HEADER_GUARD__ */
@@ -0,0 +1,45 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef QUICKSORTS__TUNED_CONFIG_H__HEADER_GUARD__
+#define QUICKSORTS__TUNED_CONFIG_H__HEADER_GUARD__
+
+/*
+  Host-tuned defaults for the unstable quicksorts.
+
+  These are the untuned defaults. ‘make tune’ runs quicksorts-tune,
+  which times the candidates on the build host and writes the fastest
+  into tuned/quicksorts/tuned-config.h in the build directory, found
+  ahead of this one.
+*/
+
+#define QUICKSORTS_TUNED__PIVOT_SELECTION  \
+  QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE
+
+#define QUICKSORTS_TUNED__SMALL_SORT             \
+  QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT
+
+#define QUICKSORTS_TUNED__SMALL_SORT__TYPED             \
+  QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED
+
+#define QUICKSORTS_TUNED__SMALL_SIZE 80
+
+/* The small-subarray size for elements of ELEMSZ bytes. */
+#define QUICKSORTS_TUNED__SMALL_SIZE_BY_ELEMSZ(ELEMSZ) 80
+
+#endif /* QUICKSORTS__TUNED_CONFIG_H__HEADER_GUARD__ */
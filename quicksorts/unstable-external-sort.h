@@ -0,0 +1,78 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef QUICKSORTS__UNSTABLE_EXTERNAL_SORT_H__HEADER_GUARD__
+#define QUICKSORTS__UNSTABLE_EXTERNAL_SORT_H__HEADER_GUARD__
+
+#include <stdio.h>
+#include <stdlib.h>
+
+/*
+  Sorting files of fixed-size records too large for memory.
+
+  The input is read in chunks of half the memory budget, each chunk
+  sorted with unstable_qsort_r and written to a temporary file as a
+  sorted run; the next chunk is read, on a second thread, while the
+  current one is sorted. The runs are then merged, fan_in at a time,
+  through a loser tree, with the memory budget divided among the
+  input and output buffers, so that reads and writes are large and
+  sequential. Input that fits in one chunk is sorted in memory and
+  written out directly.
+
+  The temporary files are unlinked as soon as they are created.
+
+  Both functions return 0 on success. On failure they return -1 and
+  set errno; the output is then incomplete. Input whose length is not
+  a multiple of the record size fails with EINVAL.
+*/
+
+struct unstable_external_sort_config
+{
+  /* Bytes of memory to use for records. Zero means
+     QUICKSORTS__UNSTABLE_EXTERNAL_SORT__MEMORY. */
+  size_t memory;
+
+  /* Where to put the runs. NULL means $TMPDIR, or else /tmp. */
+  const char *tmpdir;
+
+  /* How many runs to merge at a time. Zero means
+     QUICKSORTS__UNSTABLE_EXTERNAL_SORT__FAN_IN. */
+  size_t fan_in;
+};
+
+/* The config may be NULL, for the defaults. */
+int unstable_external_sort (FILE *in, FILE *out, size_t size,
+                            int (*compar) (const void *, const void *),
+                            const struct unstable_external_sort_config
+                            *config);
+int unstable_external_sort_r (FILE *in, FILE *out, size_t size,
+                              int (*compar) (const void *, const void *,
+                                             void *),
+                              void *arg,
+                              const struct unstable_external_sort_config
+                              *config);
+
+#ifndef QUICKSORTS__UNSTABLE_EXTERNAL_SORT__MEMORY
+#define QUICKSORTS__UNSTABLE_EXTERNAL_SORT__MEMORY ((size_t) 1 << 28)
+#endif
+
+#ifndef QUICKSORTS__UNSTABLE_EXTERNAL_SORT__FAN_IN
+#define QUICKSORTS__UNSTABLE_EXTERNAL_SORT__FAN_IN 64
+#endif
+
+#endif /* QUICKSORTS__UNSTABLE_EXTERNAL_SORT_H__HEADER_GUARD__ */
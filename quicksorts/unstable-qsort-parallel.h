@@ -0,0 +1,176 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef QUICKSORTS__UNSTABLE_QSORT_PARALLEL_H__HEADER_GUARD__
+#define QUICKSORTS__UNSTABLE_QSORT_PARALLEL_H__HEADER_GUARD__
+
+#include <stdlib.h>
+#include <quicksorts/unstable-quicksort.h>
+
+/*
+  Multithreaded versions of unstable_qsort and unstable_qsort_r.
+
+  The top levels of partitioning are done as tasks on a persistent
+  pool of POSIX threads, each thread with a deque of its own, from
+  which idle threads steal. Subarrays smaller than the threshold are
+  sorted serially. The calling thread takes part in the sort.
+
+  Only one parallel sort runs at a time; a parallel sort started while
+  another is in progress (from another thread, or from within a
+  comparison function) is done serially on the calling thread.
+*/
+
+void unstable_qsort_parallel (void *base, size_t nmemb, size_t size,
+                              int (*compar) (const void *,
+                                             const void *));
+void unstable_qsort_r_parallel (void *base, size_t nmemb, size_t size,
+                                int (*compar) (const void *,
+                                               const void *, void *),
+                                void *arg);
+
+/* Set how many threads, counting the caller, a parallel sort may
+   use. Zero, the default, means one for each online processor. */
+void unstable_qsort_parallel_set_threads (size_t nthreads);
+
+/* Subarrays with fewer elements than this are not divided further
+   among the threads. */
+#ifndef QUICKSORTS__UNSTABLE_QSORT_PARALLEL__THRESHOLD
+#define QUICKSORTS__UNSTABLE_QSORT_PARALLEL__THRESHOLD 16384
+#endif
+
+/* What the thread pool needs to know about a sort. */
+struct quicksorts__unstable_qsort_parallel__sorter
+{
+  /* Sort a subarray serially. */
+  void (*sort) (const struct quicksorts__unstable_qsort_parallel__sorter *,
+                void *base, size_t nmemb);
+
+  /* Partition a subarray once. Elements [0, *n_le) then belong before
+     the pivot, and elements [*i_ge, nmemb) after it. */
+  void (*partition)
+    (const struct quicksorts__unstable_qsort_parallel__sorter *,
+     void *base, size_t nmemb, size_t *n_le, size_t *i_ge);
+
+  size_t elemsz;
+  size_t threshold;
+  const void *context;
+};
+
+void quicksorts__unstable_qsort_parallel__run
+  (const struct quicksorts__unstable_qsort_parallel__sorter *sorter,
+   void *base, size_t nmemb);
+
+/* Start the pool threads now, rather than at the first sort large
+   enough to want them. */
+void quicksorts__unstable_qsort_parallel__start_pool (void);
+
+#define QUICKSORTS__UNSTABLE_QSORT_PARALLEL__PARTITION(PFX, BASE,      \
+                                                       NMEMB, ELEMSZ,  \
+                                                       LT,             \
+                                                       PIVOT_SELECTION, \
+                                                       PARTITION,      \
+                                                       N_LE, I_GE)     \
+  do                                                                    \
+    {                                                                   \
+      char *PFX##arr = (void *) (BASE);                                 \
+      size_t PFX##nmemb = (size_t) (NMEMB);                             \
+      size_t PFX##elemsz = (size_t) (ELEMSZ);                           \
+      size_t PFX##i_pivot;                                              \
+      size_t PFX##n_pivot;                                              \
+      bool PFX##swapped;                                                \
+      char *PFX##p_pivot;                                               \
+      PARTITION (PFX, LT, PIVOT_SELECTION);                             \
+      (void) PFX##swapped;                                              \
+      (void) PFX##p_pivot;                                              \
+      *(N_LE) = PFX##i_pivot;                                           \
+      *(I_GE) = PFX##i_pivot + PFX##n_pivot;                            \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__UNSTABLE_QSORT_PARALLEL__PARTITION__TYPED(PFX, T,  \
+                                                              BASE,    \
+                                                              NMEMB,   \
+                                                              LT,      \
+                                                              PIVOT_SELECTION, \
+                                                              PARTITION, \
+                                                              N_LE,    \
+                                                              I_GE)    \
+  do                                                                    \
+    {                                                                   \
+      T *PFX##arr = (T *) (BASE);                                       \
+      size_t PFX##nmemb = (size_t) (NMEMB);                             \
+      size_t PFX##i_pivot;                                              \
+      size_t PFX##n_pivot;                                              \
+      bool PFX##swapped;                                                \
+      T *PFX##p_pivot;                                                  \
+      PARTITION (PFX, T, LT, PIVOT_SELECTION);                          \
+      (void) PFX##swapped;                                              \
+      (void) PFX##p_pivot;                                              \
+      *(N_LE) = PFX##i_pivot;                                           \
+      *(I_GE) = PFX##i_pivot + PFX##n_pivot;                            \
+    }                                                                   \
+  while (0)
+
+/*
+  Define a function
+
+      static void NAME (T *base, size_t nmemb);
+
+  that sorts with the thread pool, using the same defaults as
+  UNSTABLE_QUICKSORT_TYPED. A parallel sort needs functions the
+  threads can call, so, unlike the other typed macros, this one goes
+  at file scope.
+*/
+#define UNSTABLE_QUICKSORT_PARALLEL_TYPED_DEFINE(NAME, T, LT)           \
+  static void                                                           \
+  NAME##__sort (const struct quicksorts__unstable_qsort_parallel__sorter \
+                *quicksorts__sorter, void *base, size_t nmemb)          \
+  {                                                                     \
+    (void) quicksorts__sorter;                                          \
+    UNSTABLE_QUICKSORT_TYPED_4ARGS (T, base, nmemb, LT);                \
+  }                                                                     \
+                                                                        \
+  static void                                                           \
+  NAME##__partition (const struct                                       \
+                     quicksorts__unstable_qsort_parallel__sorter        \
+                     *quicksorts__sorter, void *base, size_t nmemb,     \
+                     size_t *n_le, size_t *i_ge)                        \
+  {                                                                     \
+    (void) quicksorts__sorter;                                          \
+    QUICKSORTS__UNSTABLE_QSORT_PARALLEL__PARTITION__TYPED               \
+      (quicksorts__unstable_qsort_parallel__typed__, T, base, nmemb,    \
+       LT, UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION,                \
+       UNSTABLE_QUICKSORT__DEFAULT__PARTITION__TYPED, n_le, i_ge);      \
+  }                                                                     \
+                                                                        \
+  static void                                                           \
+  NAME (T *base, size_t nmemb)                                          \
+  {                                                                     \
+    const struct quicksorts__unstable_qsort_parallel__sorter            \
+      quicksorts__sorter = {                                            \
+      .sort = NAME##__sort,                                             \
+      .partition = NAME##__partition,                                   \
+      .elemsz = sizeof (T),                                             \
+      .threshold = (QUICKSORTS__UNSTABLE_QSORT_PARALLEL__THRESHOLD),    \
+      .context = NULL                                                   \
+    };                                                                  \
+    quicksorts__unstable_qsort_parallel__run                            \
+      (&quicksorts__sorter, base, nmemb);                               \
+  }
+
+#endif /* QUICKSORTS__UNSTABLE_QSORT_PARALLEL_H__HEADER_GUARD__ */
@@ -0,0 +1,75 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef QUICKSORTS__UNSTABLE_QSORT_STATS_H__HEADER_GUARD__
+#define QUICKSORTS__UNSTABLE_QSORT_STATS_H__HEADER_GUARD__
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+  Statistics of one sort: what it compared, what it moved, and how
+  well its pivots divided the subarrays.
+
+  The counts are kept only where QUICKSORTS_STATS is defined nonzero
+  before the first quicksorts header is included. Elsewhere the hooks
+  that keep them expand to nothing. unstable_qsort_stats and
+  unstable_qsort_r_stats are built that way, and are otherwise the
+  same sort as unstable_qsort and unstable_qsort_r, except that they
+  never sort indirectly.
+
+  Code that expands the sort macros itself, in a translation unit
+  with QUICKSORTS_STATS defined, gets the counts by pointing the
+  thread-local quicksorts_common__stats at a zeroed struct for the
+  duration of the sort. It must count its own calls to LT.
+*/
+
+/* Partitions are binned by the fraction of the elements, not counting
+   those equal to the pivot, that went to the smaller side: bin i
+   holds fractions from i / 20 up to (i + 1) / 20, and the last bin
+   holds the perfectly balanced. So bin 0 means a bad pivot, and the
+   last bin a pivot that was (near) the median. */
+#define UNSTABLE_QSORT_STATS_IMBALANCE_BINS 10
+
+struct unstable_qsort_stats
+{
+  uint64_t lt_calls;            /* Calls of the comparison. */
+  uint64_t swaps;               /* Elements swapped, in pairs. */
+  uint64_t bytes_moved;         /* Bytes written into the array. */
+  uint64_t max_stack_depth;     /* Subarrays waiting, at most. */
+  uint64_t partitions;
+  uint64_t heap_sorts;          /* Subarrays that ran out of budget. */
+  uint64_t small_sorts;
+  uint64_t small_sort_elements;
+  uint64_t small_sort_ns;       /* Time spent in small sorts. */
+  uint64_t total_ns;            /* Time spent in the whole sort. */
+  uint64_t imbalance[UNSTABLE_QSORT_STATS_IMBALANCE_BINS];
+};
+
+/* Sort as unstable_qsort and unstable_qsort_r do, filling in *stats,
+   which need not be initialized. */
+void unstable_qsort_stats (void *base, size_t nmemb, size_t size,
+                           int (*compar) (const void *, const void *),
+                           struct unstable_qsort_stats *stats);
+void unstable_qsort_r_stats (void *base, size_t nmemb, size_t size,
+                             int (*compar) (const void *, const void *,
+                                            void *),
+                             void *arg,
+                             struct unstable_qsort_stats *stats);
+
+#endif /* QUICKSORTS__UNSTABLE_QSORT_STATS_H__HEADER_GUARD__ */
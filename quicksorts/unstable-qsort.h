@@ -19,6 +19,7 @@
 #ifndef QUICKSORTS__UNSTABLE_QSORT_H__HEADER_GUARD__
 #define QUICKSORTS__UNSTABLE_QSORT_H__HEADER_GUARD__
 
+#include <stdint.h>
 #include <stdlib.h>
 
 void unstable_qsort (void *base, size_t nmemb, size_t size,
@@ -28,4 +29,51 @@ void unstable_qsort_r (void *base, size_t nmemb, size_t size,
                                       void *),
                        void *arg);
 
+/* Sort an array of pointers to the elements, then move each element
+   into place once. unstable_qsort and unstable_qsort_r do this
+   themselves for elements of at least INDIRECT_SIZE bytes. */
+void unstable_qsort_indirect (void *base, size_t nmemb, size_t size,
+                              int (*compar) (const void *,
+                                             const void *));
+void unstable_qsort_r_indirect (void *base, size_t nmemb, size_t size,
+                                int (*compar) (const void *,
+                                               const void *, void *),
+                                void *arg);
+
+/* Sort by a cached 64-bit key prefix, calling compar only to order
+   elements whose keys are equal. The key must agree with compar: if
+   key (a) < key (b) then compar (a, b) < 0. If compar is NULL, the
+   keys alone give the order. See <quicksorts/unstable-sort-by-key.h>. */
+void unstable_qsort_by_key (void *base, size_t nmemb, size_t size,
+                            uint64_t (*key) (const void *),
+                            int (*compar) (const void *,
+                                           const void *));
+
+/* Move into place k the element that would be there were the array
+   sorted, with none greater before it and none lesser after it. Does
+   nothing if k >= nmemb. See <quicksorts/unstable-select.h>. */
+void unstable_nth_element (void *base, size_t nmemb, size_t size,
+                           size_t k,
+                           int (*compar) (const void *, const void *));
+void unstable_nth_element_r (void *base, size_t nmemb, size_t size,
+                             size_t k,
+                             int (*compar) (const void *, const void *,
+                                            void *),
+                             void *arg);
+
+/* Sort the k least elements into the first k places (the top k),
+   leaving the rest in no particular order. */
+void unstable_partial_sort (void *base, size_t nmemb, size_t size,
+                            size_t k,
+                            int (*compar) (const void *, const void *));
+void unstable_partial_sort_r (void *base, size_t nmemb, size_t size,
+                              size_t k,
+                              int (*compar) (const void *,
+                                             const void *, void *),
+                              void *arg);
+
+#ifndef QUICKSORTS__UNSTABLE_QSORT__INDIRECT_SIZE
+#define QUICKSORTS__UNSTABLE_QSORT__INDIRECT_SIZE 256
+#endif
+
 #endif /* QUICKSORTS__UNSTABLE_QSORT_H__HEADER_GUARD__ */
@@ -22,6 +22,7 @@
 #include <stdlib.h>
 #include <string.h>
 #include <quicksorts/internal/quicksorts-common.h>
+#include <quicksorts/tuned-config.h>
 
 #define QUICKSORTS__UNSTABLE_QUICKSORT__MAKE_AN_ORDERED_PREFIX(PFX, \
                                                                LT)  \
@@ -242,6 +243,63 @@
     }                                                               \
   while (0)
 
+/* A sorting network does a fixed sequence of compare-exchanges, with
+   no data-dependent branching other than inside LT. With typed,
+   cheaply compared elements, it usually beats insertion sort on
+   random subarrays of up to a few dozen elements. It does more
+   comparisons than insertion sort, however, so it is a poor choice
+   when LT is expensive. */
+#define QUICKSORTS__UNSTABLE_QUICKSORT__NETWORK_SORT(PFX, BASE, NMEMB,  \
+                                                     ELEMSZ, LT,        \
+                                                     SMALL_SIZE)        \
+  do                                                                    \
+    {                                                                   \
+      char *PFX##network_sort__arr = (void *) (BASE);                   \
+      size_t PFX##network_sort__nmemb = (size_t) (NMEMB);               \
+      size_t PFX##network_sort__elemsz = (size_t) (ELEMSZ);             \
+      QUICKSORTS_COMMON__NETWORK_SORT (PFX##network_sort__, LT);        \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__UNSTABLE_QUICKSORT__NETWORK_SORT__TYPED(PFX, T,     \
+                                                            BASE,       \
+                                                            NMEMB, LT,  \
+                                                            SMALL_SIZE) \
+  do                                                                    \
+    {                                                                   \
+      T *PFX##network_sort__arr = (T *) (BASE);                         \
+      size_t PFX##network_sort__nmemb = (size_t) (NMEMB);               \
+      QUICKSORTS_COMMON__NETWORK_SORT__TYPED                            \
+        (PFX##network_sort__, T, LT);                                   \
+    }                                                                   \
+  while (0)
+
+/* Heapsort has the same interface as the small-subarray sorts, so it
+   can be used as one, but its real job is to finish subarrays whose
+   partitioning budget has run out. */
+#define QUICKSORTS__UNSTABLE_QUICKSORT__HEAP_SORT(PFX, BASE, NMEMB,     \
+                                                  ELEMSZ, LT,           \
+                                                  SMALL_SIZE)           \
+  do                                                                    \
+    {                                                                   \
+      char *PFX##heap_sort__arr = (void *) (BASE);                      \
+      size_t PFX##heap_sort__nmemb = (size_t) (NMEMB);                  \
+      size_t PFX##heap_sort__elemsz = (size_t) (ELEMSZ);                \
+      QUICKSORTS_COMMON__HEAPSORT (PFX##heap_sort__, LT);               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__UNSTABLE_QUICKSORT__HEAP_SORT__TYPED(PFX, T, BASE,  \
+                                                         NMEMB, LT,     \
+                                                         SMALL_SIZE)    \
+  do                                                                    \
+    {                                                                   \
+      T *PFX##heap_sort__arr = (T *) (BASE);                            \
+      size_t PFX##heap_sort__nmemb = (size_t) (NMEMB);                  \
+      QUICKSORTS_COMMON__HEAPSORT__TYPED (PFX##heap_sort__, T, LT);     \
+    }                                                                   \
+  while (0)
+
 #define QUICKSORTS__UNSTABLE_QUICKSORT__MOVE_RIGHTWARDS(PFX, LT)    \
   do                                                                \
     {                                                               \
@@ -304,6 +362,7 @@
       QUICKSORTS__UNSTABLE_QUICKSORT__MOVE_RIGHTWARDS (PFX, LT);        \
       QUICKSORTS__UNSTABLE_QUICKSORT__MOVE_LEFTWARDS (PFX, LT);         \
                                                                         \
+      PFX##swapped = (PFX##p_left != PFX##p_right);                     \
       while (PFX##p_left != PFX##p_right)                               \
         {                                                               \
           quicksorts_common__elem_swap                                  \
@@ -368,6 +427,7 @@
         }                                                               \
                                                                         \
       PFX##i_pivot = (PFX##p_pivot - PFX##arr) / PFX##elemsz;           \
+      PFX##n_pivot = 1;                                                 \
     }                                                                   \
   while (0)
 
@@ -394,6 +454,7 @@
       QUICKSORTS__UNSTABLE_QUICKSORT__MOVE_LEFTWARDS__TYPED             \
         (PFX, T, LT);                                                   \
                                                                         \
+      PFX##swapped = (PFX##p_left != PFX##p_right);                     \
       while (PFX##p_left != PFX##p_right)                               \
         {                                                               \
           QUICKSORTS_COMMON__ELEM_SWAP__TYPED                           \
@@ -450,194 +511,2205 @@
         }                                                               \
                                                                         \
       PFX##i_pivot = PFX##p_pivot - PFX##arr;                           \
+      PFX##n_pivot = 1;                                                 \
     }                                                                   \
   while (0)
 
-#define QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT(PFX, BASE, NMEMB,     \
-                                                  ELEMSZ, LT,           \
-                                                  PIVOT_SELECTION,      \
-                                                  SMALL_SIZE,           \
-                                                  SMALL_SORT)           \
+/*
+  Three-way partitioning, after Jon L. Bentley and M. Douglas McIlroy,
+  "Engineering a sort function", Software: Practice and Experience,
+  23(11), 1993, pp. 1249-1265.
+
+  Elements equal to the pivot are gathered at both ends during the
+  scan, and then swapped into the middle. The whole block of them is
+  reported back (through i_pivot and n_pivot), and never gets looked
+  at again.
+*/
+#define QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_THREE_WAY(PFX, LT,    \
+                                                            PIVOT_SELECTION)\
   do                                                                    \
     {                                                                   \
-      char *PFX##arr = (void *) (BASE);                                 \
-      size_t PFX##nmemb = (size_t) (NMEMB);                             \
-      size_t PFX##elemsz = (size_t) (ELEMSZ);                           \
+      PIVOT_SELECTION (PFX##arr, PFX##nmemb, PFX##elemsz, LT,           \
+                       PFX##i_pivot);                                   \
                                                                         \
-      if (0 < PFX##elemsz && 2 <= PFX##nmemb)                           \
-        {                                                               \
-          size_t PFX##i_pivot;                                          \
-          char *PFX##p_pivot;                                           \
+      /* Put the pivot at the start. */                                 \
+      quicksorts_common__elem_swap                                      \
+        (PFX##arr, PFX##arr + (PFX##elemsz * PFX##i_pivot),             \
+         PFX##elemsz);                                                  \
+      PFX##p_pivot = PFX##arr;                                          \
                                                                         \
-          QUICKSORTS_COMMON__STK_MAKE (PFX);                            \
-          QUICKSORTS_COMMON__STK_PUSH (PFX, PFX##arr, PFX##nmemb);      \
-          do                                                            \
+      /* Equal elements go to [arr,pa) and (pd,end]. */                 \
+      char *PFX##pa = PFX##arr + PFX##elemsz;                           \
+      char *PFX##pb = PFX##pa;                                          \
+      char *PFX##pc = PFX##arr + ((PFX##nmemb - 1) * PFX##elemsz);      \
+      char *PFX##pd = PFX##pc;                                          \
+      PFX##swapped = false;                                             \
+      for (;;)                                                          \
+        {                                                               \
+          while (PFX##pb <= PFX##pc &&                                  \
+                 !(LT ((const void *) PFX##p_pivot,                     \
+                       (const void *) PFX##pb)))                        \
             {                                                           \
-              QUICKSORTS_COMMON__STK_POP (PFX);                         \
-              if (PFX##nmemb <= (SMALL_SIZE))                           \
+              if (!(LT ((const void *) PFX##pb,                         \
+                        (const void *) PFX##p_pivot)))                  \
                 {                                                       \
-                  SMALL_SORT (PFX, PFX##arr, PFX##nmemb, PFX##elemsz,   \
-                              LT, (SMALL_SIZE));                        \
+                  quicksorts_common__elem_swap                          \
+                    (PFX##pa, PFX##pb, PFX##elemsz);                    \
+                  PFX##pa += PFX##elemsz;                               \
                 }                                                       \
-              else                                                      \
+              PFX##pb += PFX##elemsz;                                   \
+            }                                                           \
+          while (PFX##pb <= PFX##pc &&                                  \
+                 !(LT ((const void *) PFX##pc,                          \
+                       (const void *) PFX##p_pivot)))                   \
+            {                                                           \
+              if (!(LT ((const void *) PFX##p_pivot,                    \
+                        (const void *) PFX##pc)))                       \
                 {                                                       \
-                  QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION             \
-                    (PFX, LT, PIVOT_SELECTION);                         \
-                                                                        \
-                  /* Push the larger part of the partition first. */    \
-                  /* Otherwise the stack may overflow.            */    \
-                                                                        \
-                  size_t PFX##n_le = PFX##i_pivot;                      \
-                  size_t PFX##n_ge = PFX##nmemb - 1 - PFX##i_pivot;     \
-                  if (PFX##n_le < PFX##n_ge)                            \
-                    {                                                   \
-                      QUICKSORTS_COMMON__STK_PUSH                       \
-                        (PFX, PFX##p_pivot + PFX##elemsz, PFX##n_ge);   \
-                      if (PFX##n_le != 0)                               \
-                        QUICKSORTS_COMMON__STK_PUSH                     \
-                          (PFX, PFX##arr, PFX##n_le);                   \
-                    }                                                   \
-                  else                                                  \
-                    {                                                   \
-                      QUICKSORTS_COMMON__STK_PUSH                       \
-                        (PFX, PFX##arr, PFX##n_le);                     \
-                      if (PFX##n_ge != 0)                               \
-                        QUICKSORTS_COMMON__STK_PUSH                     \
-                          (PFX, PFX##p_pivot + PFX##elemsz, PFX##n_ge); \
-                    }                                                   \
+                  quicksorts_common__elem_swap                          \
+                    (PFX##pc, PFX##pd, PFX##elemsz);                    \
+                  PFX##pd -= PFX##elemsz;                               \
                 }                                                       \
+              PFX##pc -= PFX##elemsz;                                   \
             }                                                           \
-          while (PFX##stk_depth != 0);                                  \
+          if (PFX##pc < PFX##pb)                                        \
+            break;                                                      \
+          quicksorts_common__elem_swap                                  \
+            (PFX##pb, PFX##pc, PFX##elemsz);                            \
+          PFX##swapped = true;                                          \
+          PFX##pb += PFX##elemsz;                                       \
+          PFX##pc -= PFX##elemsz;                                       \
         }                                                               \
+                                                                        \
+      /* Swap the equal elements into the middle. The regions do */     \
+      /* not overlap, so elem_swap can move them as single blocks. */   \
+      char *PFX##p_end = PFX##arr + (PFX##nmemb * PFX##elemsz);         \
+      size_t PFX##n_lt = (PFX##pb - PFX##pa) / PFX##elemsz;             \
+      size_t PFX##n_gt = (PFX##pd - PFX##pc) / PFX##elemsz;             \
+      size_t PFX##blocksz = PFX##pa - PFX##arr;                         \
+      if ((size_t) (PFX##pb - PFX##pa) < PFX##blocksz)                  \
+        PFX##blocksz = PFX##pb - PFX##pa;                               \
+      if (PFX##blocksz != 0)                                            \
+        quicksorts_common__elem_swap                                    \
+          (PFX##arr, PFX##pb - PFX##blocksz, PFX##blocksz);             \
+      PFX##blocksz = PFX##pd - PFX##pc;                                 \
+      if ((size_t) (PFX##p_end - PFX##pd) - PFX##elemsz < PFX##blocksz) \
+        PFX##blocksz = (PFX##p_end - PFX##pd) - PFX##elemsz;            \
+      if (PFX##blocksz != 0)                                            \
+        quicksorts_common__elem_swap                                    \
+          (PFX##pb, PFX##p_end - PFX##blocksz, PFX##blocksz);           \
+                                                                        \
+      PFX##i_pivot = PFX##n_lt;                                         \
+      PFX##n_pivot = PFX##nmemb - PFX##n_lt - PFX##n_gt;                \
+      PFX##p_pivot = PFX##arr + (PFX##elemsz * PFX##n_lt);              \
     }                                                                   \
   while (0)
 
-#define QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT__TYPED(PFX, T, BASE, \
-                                                         NMEMB, LT,     \
-                                                         PIVOT_SELECTION, \
-                                                         SMALL_SIZE,    \
-                                                         SMALL_SORT)    \
+#define QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_THREE_WAY__TYPED(PFX, T, \
+                                                                   LT,  \
+                                                                   PIVOT_SELECTION)\
   do                                                                    \
     {                                                                   \
-      T *PFX##arr = (T *) (BASE);                                       \
-      size_t PFX##nmemb = (size_t) (NMEMB);                             \
+      PIVOT_SELECTION (PFX##arr, PFX##nmemb, sizeof (T), LT,            \
+                       PFX##i_pivot);                                   \
                                                                         \
-      if (0 < sizeof (T) && 2 <= PFX##nmemb)                            \
-        {                                                               \
-          size_t PFX##i_pivot;                                          \
-          T *PFX##p_pivot;                                              \
+      /* Put the pivot at the start. */                                 \
+      QUICKSORTS_COMMON__ELEM_SWAP__TYPED                               \
+        (PFX, T, PFX##arr, PFX##arr + PFX##i_pivot);                    \
+      PFX##p_pivot = PFX##arr;                                          \
                                                                         \
-          QUICKSORTS_COMMON__STK_MAKE (PFX);                            \
-          QUICKSORTS_COMMON__STK_PUSH (PFX, PFX##arr, PFX##nmemb);      \
-          do                                                            \
+      /* Equal elements go to [arr,pa) and (pd,end]. */                 \
+      T *PFX##pa = PFX##arr + 1;                                        \
+      T *PFX##pb = PFX##pa;                                             \
+      T *PFX##pc = PFX##arr + (PFX##nmemb - 1);                         \
+      T *PFX##pd = PFX##pc;                                             \
+      PFX##swapped = false;                                             \
+      for (;;)                                                          \
+        {                                                               \
+          while (PFX##pb <= PFX##pc &&                                  \
+                 !(LT (PFX##p_pivot, PFX##pb)))                         \
             {                                                           \
-              QUICKSORTS_COMMON__STK_POP (PFX);                         \
-              if (PFX##nmemb <= (SMALL_SIZE))                           \
+              if (!(LT (PFX##pb, PFX##p_pivot)))                        \
                 {                                                       \
-                  SMALL_SORT (PFX, T, PFX##arr, PFX##nmemb, LT,         \
-                              (SMALL_SIZE));                            \
+                  QUICKSORTS_COMMON__ELEM_SWAP__TYPED                   \
+                    (PFX, T, PFX##pa, PFX##pb);                         \
+                  PFX##pa += 1;                                         \
                 }                                                       \
-              else                                                      \
+              PFX##pb += 1;                                             \
+            }                                                           \
+          while (PFX##pb <= PFX##pc &&                                  \
+                 !(LT (PFX##pc, PFX##p_pivot)))                         \
+            {                                                           \
+              if (!(LT (PFX##p_pivot, PFX##pc)))                        \
                 {                                                       \
-                  QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION__TYPED      \
-                    (PFX, T, LT, PIVOT_SELECTION);                      \
-                                                                        \
-                  /* Push the larger part of the partition first. */    \
-                  /* Otherwise the stack may overflow.            */    \
-                                                                        \
-                  size_t PFX##n_le = PFX##i_pivot;                      \
-                  size_t PFX##n_ge = PFX##nmemb - 1 - PFX##i_pivot;     \
-                  if (PFX##n_le < PFX##n_ge)                            \
-                    {                                                   \
-                      QUICKSORTS_COMMON__STK_PUSH                       \
-                        (PFX, PFX##p_pivot + 1, PFX##n_ge);             \
-                      if (PFX##n_le != 0)                               \
-                        QUICKSORTS_COMMON__STK_PUSH                     \
-                          (PFX, PFX##arr, PFX##n_le);                   \
-                    }                                                   \
-                  else                                                  \
-                    {                                                   \
-                      QUICKSORTS_COMMON__STK_PUSH                       \
-                        (PFX, PFX##arr, PFX##n_le);                     \
-                      if (PFX##n_ge != 0)                               \
-                        QUICKSORTS_COMMON__STK_PUSH                     \
-                          (PFX, PFX##p_pivot + 1, PFX##n_ge);           \
-                    }                                                   \
+                  QUICKSORTS_COMMON__ELEM_SWAP__TYPED                   \
+                    (PFX, T, PFX##pc, PFX##pd);                         \
+                  PFX##pd -= 1;                                         \
                 }                                                       \
+              PFX##pc -= 1;                                             \
             }                                                           \
-          while (PFX##stk_depth != 0);                                  \
+          if (PFX##pc < PFX##pb)                                        \
+            break;                                                      \
+          QUICKSORTS_COMMON__ELEM_SWAP__TYPED                           \
+            (PFX, T, PFX##pb, PFX##pc);                                 \
+          PFX##swapped = true;                                          \
+          PFX##pb += 1;                                                 \
+          PFX##pc -= 1;                                                 \
         }                                                               \
+                                                                        \
+      /* Swap the equal elements into the middle. */                    \
+      size_t PFX##n_lt = PFX##pb - PFX##pa;                             \
+      size_t PFX##n_gt = PFX##pd - PFX##pc;                             \
+      size_t PFX##n_swap =                                              \
+        ((size_t) (PFX##pa - PFX##arr) < PFX##n_lt) ?                   \
+        (size_t) (PFX##pa - PFX##arr) : PFX##n_lt;                      \
+      for (size_t PFX##k = 0; PFX##k != PFX##n_swap; PFX##k += 1)       \
+        QUICKSORTS_COMMON__ELEM_SWAP__TYPED                             \
+          (PFX, T, PFX##arr + PFX##k,                                   \
+           PFX##pb - PFX##n_swap + PFX##k);                             \
+      T *PFX##p_end = PFX##arr + PFX##nmemb;                            \
+      PFX##n_swap =                                                     \
+        (PFX##n_gt < (size_t) (PFX##p_end - PFX##pd - 1)) ?             \
+        PFX##n_gt : (size_t) (PFX##p_end - PFX##pd - 1);                \
+      for (size_t PFX##k = 0; PFX##k != PFX##n_swap; PFX##k += 1)       \
+        QUICKSORTS_COMMON__ELEM_SWAP__TYPED                             \
+          (PFX, T, PFX##pb + PFX##k,                                    \
+           PFX##p_end - PFX##n_swap + PFX##k);                          \
+                                                                        \
+      PFX##i_pivot = PFX##n_lt;                                         \
+      PFX##n_pivot = PFX##nmemb - PFX##n_lt - PFX##n_gt;                \
+      PFX##p_pivot = PFX##arr + PFX##n_lt;                              \
     }                                                                   \
   while (0)
 
-#define UNSTABLE_QUICKSORT_7ARGS(BASE, NMEMB, ELEMSZ, LT,           \
-                                 PIVOT_SELECTION,                   \
-                                 SMALL_SIZE, SMALL_SORT)            \
-  do                                                                \
-    {                                                               \
-      QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT                     \
-        (quicksorts__unstable_quicksort__,                          \
-         (BASE), (NMEMB), (ELEMSZ),                                 \
-         LT, PIVOT_SELECTION, (SMALL_SIZE), SMALL_SORT);            \
-    }                                                               \
-  while (0)
+/* The number of elements examined at a time by block partitioning.
+   Offsets within a block must fit in an unsigned char. */
+#define QUICKSORTS__UNSTABLE_QUICKSORT__BLOCK_SIZE 64
 
-#define UNSTABLE_QUICKSORT_TYPED_7ARGS(T, BASE, NMEMB, LT,      \
-                                       PIVOT_SELECTION,         \
-                                       SMALL_SIZE, SMALL_SORT)  \
-  do                                                            \
-    {                                                           \
-      QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT__TYPED          \
-        (quicksorts__unstable_quicksort__typed__, T,            \
-         (BASE), (NMEMB), LT, PIVOT_SELECTION,                  \
-         (SMALL_SIZE), SMALL_SORT);                             \
-    }                                                           \
+/* Swap PFX##num pairs of elements, taken from the left and right
+   offset buffers. */
+#define QUICKSORTS__UNSTABLE_QUICKSORT__SWAP_OFFSETS__TYPED(PFX, T)     \
+  do                                                                    \
+    {                                                                   \
+      PFX##num = (PFX##num_l < PFX##num_r) ? PFX##num_l : PFX##num_r;   \
+      for (size_t PFX##j = 0; PFX##j != PFX##num; PFX##j += 1)          \
+        QUICKSORTS_COMMON__ELEM_SWAP__TYPED                             \
+          (PFX, T,                                                      \
+           PFX##first + PFX##offsets_l[PFX##start_l + PFX##j],          \
+           PFX##last - PFX##offsets_r[PFX##start_r + PFX##j]);          \
+      PFX##num_l -= PFX##num;                                           \
+      PFX##num_r -= PFX##num;                                           \
+      PFX##start_l += PFX##num;                                         \
+      PFX##start_r += PFX##num;                                         \
+    }                                                                   \
   while (0)
 
-#ifndef UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION
-#define UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION    \
-  QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE
-#endif
+/*
+  Block partitioning, after Stefan Edelkamp and Armin Weiß,
+  "BlockQuicksort: Avoiding Branch Mispredictions in Quicksort", ACM
+  Journal of Experimental Algorithmics, Volume 24, 2019.
+  https://doi.org/10.1145/3274660
 
-#ifndef UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE
-#define UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE 80
-#endif
+  A block of elements at either end is compared against the pivot,
+  and the offsets of misplaced elements are recorded without
+  branching. The recorded elements are then swapped in pairs. Both
+  sides treat elements equal to the pivot as misplaced, as the
+  two-way partition does, so that runs of equal keys still split
+  evenly. The final cleanup follows Orson Peters's pdqsort.
+*/
+#define QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_BLOCK__TYPED(PFX, T,  \
+                                                               LT,      \
+                                                               PIVOT_SELECTION) \
+  do                                                                    \
+    {                                                                   \
+      PIVOT_SELECTION (PFX##arr, PFX##nmemb, sizeof (T), LT,            \
+                       PFX##i_pivot);                                   \
+                                                                        \
+      /* Put the pivot at the start. */                                 \
+      QUICKSORTS_COMMON__ELEM_SWAP__TYPED                               \
+        (PFX, T, PFX##arr, PFX##arr + PFX##i_pivot);                    \
+      PFX##p_pivot = PFX##arr;                                          \
+                                                                        \
+      /* Elements in [arr + 1, first) are known to be no greater */     \
+      /* than the pivot, and those in [last, end) no less.       */     \
+      T *PFX##first = PFX##arr + 1;                                     \
+      T *PFX##last = PFX##arr + PFX##nmemb;                             \
+      while (PFX##first != PFX##last &&                                 \
+             LT (PFX##first, PFX##p_pivot))                             \
+        PFX##first += 1;                                                \
+      while (PFX##first != PFX##last &&                                 \
+             LT (PFX##p_pivot, PFX##last - 1))                          \
+        PFX##last -= 1;                                                 \
+      PFX##swapped = (PFX##first != PFX##last);                         \
+                                                                        \
+      unsigned char                                                     \
+        PFX##offsets_l[QUICKSORTS__UNSTABLE_QUICKSORT__BLOCK_SIZE];     \
+      unsigned char                                                     \
+        PFX##offsets_r[QUICKSORTS__UNSTABLE_QUICKSORT__BLOCK_SIZE];     \
+      size_t PFX##num_l = 0;                                            \
+      size_t PFX##num_r = 0;                                            \
+      size_t PFX##start_l = 0;                                          \
+      size_t PFX##start_r = 0;                                          \
+      size_t PFX##num;                                                  \
+                                                                        \
+      while ((size_t) (PFX##last - PFX##first)                          \
+             > 2 * QUICKSORTS__UNSTABLE_QUICKSORT__BLOCK_SIZE)          \
+        {                                                               \
+          if (PFX##num_l == 0)                                          \
+            {                                                           \
+              PFX##start_l = 0;                                         \
+              for (size_t PFX##i = 0;                                   \
+                   PFX##i != QUICKSORTS__UNSTABLE_QUICKSORT__BLOCK_SIZE; \
+                   PFX##i += 1)                                         \
+                {                                                       \
+                  PFX##offsets_l[PFX##num_l] = (unsigned char) PFX##i;  \
+                  PFX##num_l +=                                         \
+                    !(LT (PFX##first + PFX##i, PFX##p_pivot));          \
+                }                                                       \
+            }                                                           \
+          if (PFX##num_r == 0)                                          \
+            {                                                           \
+              PFX##start_r = 0;                                         \
+              for (size_t PFX##i = 1;                                   \
+                   PFX##i <= QUICKSORTS__UNSTABLE_QUICKSORT__BLOCK_SIZE; \
+                   PFX##i += 1)                                         \
+                {                                                       \
+                  PFX##offsets_r[PFX##num_r] = (unsigned char) PFX##i;  \
+                  PFX##num_r +=                                         \
+                    !(LT (PFX##p_pivot, PFX##last - PFX##i));           \
+                }                                                       \
+            }                                                           \
+          QUICKSORTS__UNSTABLE_QUICKSORT__SWAP_OFFSETS__TYPED (PFX, T); \
+          if (PFX##num_l == 0)                                          \
+            PFX##first += QUICKSORTS__UNSTABLE_QUICKSORT__BLOCK_SIZE;   \
+          if (PFX##num_r == 0)                                          \
+            PFX##last -= QUICKSORTS__UNSTABLE_QUICKSORT__BLOCK_SIZE;    \
+        }                                                               \
+                                                                        \
+      /* The last, possibly short, round. At most one of the */         \
+      /* buffers still holds offsets from a full block.      */         \
+      size_t PFX##unknown = (size_t) (PFX##last - PFX##first);          \
+      if (PFX##num_l != 0 || PFX##num_r != 0)                           \
+        PFX##unknown -= QUICKSORTS__UNSTABLE_QUICKSORT__BLOCK_SIZE;     \
+      size_t PFX##size_l;                                               \
+      size_t PFX##size_r;                                               \
+      if (PFX##num_r != 0)                                              \
+        {                                                               \
+          PFX##size_l = PFX##unknown;                                   \
+          PFX##size_r = QUICKSORTS__UNSTABLE_QUICKSORT__BLOCK_SIZE;     \
+        }                                                               \
+      else if (PFX##num_l != 0)                                         \
+        {                                                               \
+          PFX##size_l = QUICKSORTS__UNSTABLE_QUICKSORT__BLOCK_SIZE;     \
+          PFX##size_r = PFX##unknown;                                   \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          PFX##size_l = PFX##unknown >> 1;                              \
+          PFX##size_r = PFX##unknown - PFX##size_l;                     \
+        }                                                               \
+      if (PFX##unknown != 0 && PFX##num_l == 0)                         \
+        {                                                               \
+          PFX##start_l = 0;                                             \
+          for (size_t PFX##i = 0; PFX##i != PFX##size_l; PFX##i += 1)   \
+            {                                                           \
+              PFX##offsets_l[PFX##num_l] = (unsigned char) PFX##i;      \
+              PFX##num_l += !(LT (PFX##first + PFX##i, PFX##p_pivot));  \
+            }                                                           \
+        }                                                               \
+      if (PFX##unknown != 0 && PFX##num_r == 0)                         \
+        {                                                               \
+          PFX##start_r = 0;                                             \
+          for (size_t PFX##i = 1; PFX##i <= PFX##size_r; PFX##i += 1)   \
+            {                                                           \
+              PFX##offsets_r[PFX##num_r] = (unsigned char) PFX##i;      \
+              PFX##num_r += !(LT (PFX##p_pivot, PFX##last - PFX##i));   \
+            }                                                           \
+        }                                                               \
+      QUICKSORTS__UNSTABLE_QUICKSORT__SWAP_OFFSETS__TYPED (PFX, T);     \
+      if (PFX##num_l == 0)                                              \
+        PFX##first += PFX##size_l;                                      \
+      if (PFX##num_r == 0)                                              \
+        PFX##last -= PFX##size_r;                                       \
+                                                                        \
+      /* Move any misplaced elements that remain to the far end */      \
+      /* of their block.                                        */      \
+      if (PFX##num_l != 0)                                              \
+        {                                                               \
+          while (PFX##num_l != 0)                                       \
+            {                                                           \
+              PFX##num_l -= 1;                                          \
+              PFX##last -= 1;                                           \
+              QUICKSORTS_COMMON__ELEM_SWAP__TYPED                       \
+                (PFX, T,                                                \
+                 PFX##first + PFX##offsets_l[PFX##start_l + PFX##num_l], \
+                 PFX##last);                                            \
+            }                                                           \
+          PFX##first = PFX##last;                                       \
+        }                                                               \
+      if (PFX##num_r != 0)                                              \
+        {                                                               \
+          while (PFX##num_r != 0)                                       \
+            {                                                           \
+              PFX##num_r -= 1;                                          \
+              QUICKSORTS_COMMON__ELEM_SWAP__TYPED                       \
+                (PFX, T,                                                \
+                 PFX##last - PFX##offsets_r[PFX##start_r + PFX##num_r], \
+                 PFX##first);                                           \
+              PFX##first += 1;                                          \
+            }                                                           \
+          PFX##last = PFX##first;                                       \
+        }                                                               \
+                                                                        \
+      /* Put the pivot between the two parts. */                        \
+      PFX##p_pivot = PFX##first - 1;                                    \
+      QUICKSORTS_COMMON__ELEM_SWAP__TYPED                               \
+        (PFX, T, PFX##arr, PFX##p_pivot);                               \
+      PFX##i_pivot = (size_t) (PFX##p_pivot - PFX##arr);                \
+      PFX##n_pivot = 1;                                                 \
+    }                                                                   \
+  while (0)
 
-#ifndef UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT
-#define UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT     \
-  QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT
-#endif
+/*
+  Hole partitioning, for large elements. The pivot is copied out,
+  leaving a hole, and each misplaced element is copied into the hole
+  from the other end, where it leaves a new hole: one copy per element
+  moved, where a swap costs three. The pivot goes into the last hole.
+  Scans from both ends stop at elements equal to the pivot, so arrays
+  with many equal keys still split near the middle; a sampled pivot
+  (PIVOT_ADAPTIVE) keeps the split balanced otherwise.
 
-#ifndef UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT__TYPED
-#define UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT__TYPED  \
-  QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED
+  unstable_qsort and its variants partition with it, and
+  PIVOT_ADAPTIVE, when elements are at least HOLE_PARTITION_SIZE
+  bytes and less than INDIRECT_SIZE (see <quicksorts/unstable-qsort.h>),
+  beyond which they sort pointers instead. The two are equal by
+  default, because sorting pointers measured faster at every size
+  from 256 bytes; see README. Elsewhere it is a PARTITION like the
+  others, to be chosen. The untyped variant holds the pivot
+  in PFX##hole__tmp, which the untyped QUICKSORT, PDQSORT and
+  NTH_ELEMENT drivers declare, null, for the whole sort. The first
+  hole partition fills it from QUICKSORTS_COMMON__MALLOC, and the
+  driver frees it at the end. If there is no memory, the subarray is
+  partitioned as PARTITION does it.
+*/
+
+#ifndef QUICKSORTS__UNSTABLE_QUICKSORT__HOLE_PARTITION_SIZE
+#define QUICKSORTS__UNSTABLE_QUICKSORT__HOLE_PARTITION_SIZE 256
 #endif
 
-#define UNSTABLE_QUICKSORT_4ARGS(BASE, NMEMB, ELEMSZ, LT)   \
-  do                                                        \
-    {                                                       \
-      QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT             \
-        (quicksorts__unstable_quicksort__,                  \
-         (BASE), (NMEMB), (ELEMSZ), LT,                     \
-         UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION,      \
-         (UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE),         \
-         UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT);          \
-    }                                                       \
+#define QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_HOLE(PFX, LT,         \
+                                                       PIVOT_SELECTION) \
+  do                                                                    \
+    {                                                                   \
+      if (PFX##hole__tmp == NULL)                                       \
+        PFX##hole__tmp = QUICKSORTS_COMMON__MALLOC (PFX##elemsz);       \
+      if (PFX##hole__tmp == NULL)                                       \
+        QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION                       \
+          (PFX, LT, PIVOT_SELECTION);                                   \
+      else                                                              \
+        {                                                               \
+          const size_t PFX##hole__es = PFX##elemsz;                     \
+          PIVOT_SELECTION (PFX##arr, PFX##nmemb, PFX##hole__es, LT,     \
+                           PFX##i_pivot);                               \
+                                                                        \
+          /* Take out the pivot, and move the hole to the front. */     \
+          char *PFX##hole__pl = PFX##arr;                               \
+          char *PFX##hole__pr =                                         \
+            PFX##arr + ((PFX##nmemb - 1) * PFX##hole__es);              \
+          char *const PFX##hole__pp =                                   \
+            PFX##arr + (PFX##hole__es * PFX##i_pivot);                  \
+          QUICKSORTS_COMMON__MEMCPY (PFX##hole__tmp, PFX##hole__pp,     \
+                                     PFX##hole__es);                    \
+          QUICKSORTS_COMMON__STATS_MOVED (0, PFX##hole__es);            \
+          PFX##swapped = (PFX##hole__pp != PFX##arr);                   \
+          if (PFX##swapped)                                             \
+            {                                                           \
+              QUICKSORTS_COMMON__MEMCPY (PFX##hole__pp, PFX##arr,       \
+                                         PFX##hole__es);                \
+              QUICKSORTS_COMMON__STATS_MOVED (0, PFX##hole__es);        \
+            }                                                           \
+                                                                        \
+          while (PFX##hole__pl != PFX##hole__pr)                        \
+            {                                                           \
+              /* The hole is at the left. Fill it from the right. */    \
+              while (PFX##hole__pl != PFX##hole__pr                     \
+                     && LT ((const void *) PFX##hole__tmp,              \
+                            (const void *) PFX##hole__pr))              \
+                PFX##hole__pr -= PFX##hole__es;                         \
+              if (PFX##hole__pl != PFX##hole__pr)                       \
+                {                                                       \
+                  QUICKSORTS_COMMON__MEMCPY                             \
+                    (PFX##hole__pl, PFX##hole__pr, PFX##hole__es);      \
+                  QUICKSORTS_COMMON__STATS_MOVED (0, PFX##hole__es);    \
+                  PFX##swapped = true;                                  \
+                  PFX##hole__pl += PFX##hole__es;                       \
+                }                                                       \
+                                                                        \
+              /* The hole is at the right. Fill it from the left. */    \
+              while (PFX##hole__pl != PFX##hole__pr                     \
+                     && LT ((const void *) PFX##hole__pl,               \
+                            (const void *) PFX##hole__tmp))             \
+                PFX##hole__pl += PFX##hole__es;                         \
+              if (PFX##hole__pl != PFX##hole__pr)                       \
+                {                                                       \
+                  QUICKSORTS_COMMON__MEMCPY                             \
+                    (PFX##hole__pr, PFX##hole__pl, PFX##hole__es);      \
+                  QUICKSORTS_COMMON__STATS_MOVED (0, PFX##hole__es);    \
+                  PFX##swapped = true;                                  \
+                  PFX##hole__pr -= PFX##hole__es;                       \
+                }                                                       \
+            }                                                           \
+                                                                        \
+          QUICKSORTS_COMMON__MEMCPY (PFX##hole__pl, PFX##hole__tmp,     \
+                                     PFX##hole__es);                    \
+          QUICKSORTS_COMMON__STATS_MOVED (0, PFX##hole__es);            \
+          PFX##p_pivot = PFX##hole__pl;                                 \
+          PFX##i_pivot =                                                \
+            (size_t) (PFX##p_pivot - PFX##arr) / PFX##hole__es;         \
+          PFX##n_pivot = 1;                                             \
+        }                                                               \
+    }                                                                   \
   while (0)
 
-#define UNSTABLE_QUICKSORT_TYPED_4ARGS(T, BASE, NMEMB, LT)  \
-  do                                                        \
-    {                                                       \
-      QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT__TYPED      \
-        (quicksorts__unstable_quicksort__typed__,           \
-         T, (BASE), (NMEMB), LT,                            \
-         UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION,      \
-         (UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE),         \
-         UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT__TYPED);   \
-    }                                                       \
+#define QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_HOLE__TYPED(PFX, T, LT, \
+                                                              PIVOT_SELECTION) \
+  do                                                                    \
+    {                                                                   \
+      PIVOT_SELECTION (PFX##arr, PFX##nmemb, sizeof (T), LT,            \
+                       PFX##i_pivot);                                   \
+                                                                        \
+      /* Take out the pivot, and move the hole to the front. */         \
+      T *PFX##hole__pl = PFX##arr;                                      \
+      T *PFX##hole__pr = PFX##arr + (PFX##nmemb - 1);                   \
+      T PFX##hole__tmp = PFX##arr[PFX##i_pivot];                        \
+      QUICKSORTS_COMMON__STATS_MOVED (0, sizeof (T));                   \
+      PFX##swapped = (PFX##i_pivot != 0);                               \
+      if (PFX##swapped)                                                 \
+        {                                                               \
+          PFX##arr[PFX##i_pivot] = *PFX##arr;                           \
+          QUICKSORTS_COMMON__STATS_MOVED (0, sizeof (T));               \
+        }                                                               \
+                                                                        \
+      while (PFX##hole__pl != PFX##hole__pr)                            \
+        {                                                               \
+          /* The hole is at the left. Fill it from the right. */        \
+          while (PFX##hole__pl != PFX##hole__pr                         \
+                 && LT (&PFX##hole__tmp, PFX##hole__pr))                \
+            PFX##hole__pr -= 1;                                         \
+          if (PFX##hole__pl != PFX##hole__pr)                           \
+            {                                                           \
+              *PFX##hole__pl = *PFX##hole__pr;                          \
+              QUICKSORTS_COMMON__STATS_MOVED (0, sizeof (T));           \
+              PFX##swapped = true;                                      \
+              PFX##hole__pl += 1;                                       \
+            }                                                           \
+                                                                        \
+          /* The hole is at the right. Fill it from the left. */        \
+          while (PFX##hole__pl != PFX##hole__pr                         \
+                 && LT (PFX##hole__pl, &PFX##hole__tmp))                \
+            PFX##hole__pl += 1;                                         \
+          if (PFX##hole__pl != PFX##hole__pr)                           \
+            {                                                           \
+              *PFX##hole__pr = *PFX##hole__pl;                          \
+              QUICKSORTS_COMMON__STATS_MOVED (0, sizeof (T));           \
+              PFX##swapped = true;                                      \
+              PFX##hole__pr -= 1;                                       \
+            }                                                           \
+        }                                                               \
+                                                                        \
+      *PFX##hole__pl = PFX##hole__tmp;                                  \
+      QUICKSORTS_COMMON__STATS_MOVED (0, sizeof (T));                   \
+      PFX##p_pivot = PFX##hole__pl;                                     \
+      PFX##i_pivot = (size_t) (PFX##p_pivot - PFX##arr);                \
+      PFX##n_pivot = 1;                                                 \
+    }                                                                   \
   while (0)
 
-#define UNSTABLE_QUICKSORT UNSTABLE_QUICKSORT_4ARGS
-#define UNSTABLE_QUICKSORT_TYPED UNSTABLE_QUICKSORT_TYPED_4ARGS
+/*
+  Runs. Before partitioning a large array, the QUICKSORT and PDQSORT
+  drivers scan it for the runs it is made of, up to MAX_RUNS of them,
+  reversing the descending runs as they go. An array that is a single run is
+  already sorted. An array of a few runs, such as sorted batches
+  appended one after another, is merged: adjacent runs pairwise,
+  through a buffer the size of the smaller run of each merge, or of
+  MERGE_BUFFER_SIZE bytes if that is less (runs longer than the
+  buffer are merged a piece at a time; see MERGE_BOUNDED). Anything
+  else, or no memory for the buffer, and the array is partitioned as
+  usual. Giving up costs at most the scan of MAX_RUNS runs, which in
+  random data are only a few elements long.
+*/
+
+#ifndef QUICKSORTS__UNSTABLE_QUICKSORT__MAX_RUNS
+#define QUICKSORTS__UNSTABLE_QUICKSORT__MAX_RUNS 16
+#endif
+
+#ifndef QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_BUFFER_SIZE
+#define QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_BUFFER_SIZE 65536
+#endif
+
+/* Merge the sorted runs of N1 and N - N1 elements that begin at P,
+   where 0 < N1 < N. BUF must hold the smaller of them. The leading
+   elements of the first run that are already in place, and the
+   trailing elements of the second, are found by binary search and
+   left out of the merge. */
+#define QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_PAIR(PFX, LT, P, N1, N,   \
+                                                   BUF)                 \
+  do                                                                    \
+    {                                                                   \
+      const size_t PFX##merge__es = PFX##elemsz;                        \
+      char *PFX##merge__lo = (P);                                       \
+      char *PFX##merge__mid = PFX##merge__lo + ((N1) * PFX##merge__es); \
+      char *PFX##merge__hi = PFX##merge__lo + ((N) * PFX##merge__es);   \
+      char *PFX##merge__buf = (BUF);                                    \
+      if (LT ((const void *) PFX##merge__mid,                           \
+              (const void *) (PFX##merge__mid - PFX##merge__es)))       \
+        {                                                               \
+          /* Skip what precedes the first of the second run. */         \
+          size_t PFX##merge__a = 0;                                     \
+          size_t PFX##merge__b = (N1);                                  \
+          while (PFX##merge__a != PFX##merge__b)                        \
+            {                                                           \
+              const size_t PFX##merge__m =                              \
+                PFX##merge__a + ((PFX##merge__b - PFX##merge__a) / 2);  \
+              if (LT ((const void *) PFX##merge__mid,                   \
+                      (const void *) (PFX##merge__lo                    \
+                                      + (PFX##merge__m                  \
+                                         * PFX##merge__es))))           \
+                PFX##merge__b = PFX##merge__m;                          \
+              else                                                      \
+                PFX##merge__a = PFX##merge__m + 1;                      \
+            }                                                           \
+          PFX##merge__lo += PFX##merge__a * PFX##merge__es;             \
+                                                                        \
+          /* Skip what follows the last of the first run. */            \
+          PFX##merge__a = 0;                                            \
+          PFX##merge__b = (N) - (N1);                                   \
+          while (PFX##merge__a != PFX##merge__b)                        \
+            {                                                           \
+              const size_t PFX##merge__m =                              \
+                PFX##merge__a + ((PFX##merge__b - PFX##merge__a) / 2);  \
+              if (LT ((const void *) (PFX##merge__mid                   \
+                                      + (PFX##merge__m                  \
+                                         * PFX##merge__es)),            \
+                      (const void *) (PFX##merge__mid                   \
+                                      - PFX##merge__es)))               \
+                PFX##merge__a = PFX##merge__m + 1;                      \
+              else                                                      \
+                PFX##merge__b = PFX##merge__m;                          \
+            }                                                           \
+          PFX##merge__hi =                                              \
+            PFX##merge__mid + (PFX##merge__a * PFX##merge__es);         \
+                                                                        \
+          const size_t PFX##merge__n_lo =                               \
+            (size_t) (PFX##merge__mid - PFX##merge__lo);                \
+          const size_t PFX##merge__n_hi =                               \
+            (size_t) (PFX##merge__hi - PFX##merge__mid);                \
+          QUICKSORTS_COMMON__STATS_MOVED                                \
+            (0, PFX##merge__n_lo + PFX##merge__n_hi);                   \
+          if (PFX##merge__n_lo <= PFX##merge__n_hi)                     \
+            {                                                           \
+              /* Merge forwards, from the buffered first run. */        \
+              QUICKSORTS_COMMON__MEMCPY                                 \
+                (PFX##merge__buf, PFX##merge__lo, PFX##merge__n_lo);    \
+              char *PFX##merge__pa = PFX##merge__buf;                   \
+              char *PFX##merge__end_a =                                 \
+                PFX##merge__buf + PFX##merge__n_lo;                     \
+              char *PFX##merge__pb = PFX##merge__mid;                   \
+              char *PFX##merge__out = PFX##merge__lo;                   \
+              while (PFX##merge__pa != PFX##merge__end_a                \
+                     && PFX##merge__pb != PFX##merge__hi)               \
+                {                                                       \
+                  if (LT ((const void *) PFX##merge__pb,                \
+                          (const void *) PFX##merge__pa))               \
+                    {                                                   \
+                      QUICKSORTS_COMMON__MEMCPY                         \
+                        (PFX##merge__out, PFX##merge__pb,               \
+                         PFX##merge__es);                               \
+                      PFX##merge__pb += PFX##merge__es;                 \
+                    }                                                   \
+                  else                                                  \
+                    {                                                   \
+                      QUICKSORTS_COMMON__MEMCPY                         \
+                        (PFX##merge__out, PFX##merge__pa,               \
+                         PFX##merge__es);                               \
+                      PFX##merge__pa += PFX##merge__es;                 \
+                    }                                                   \
+                  PFX##merge__out += PFX##merge__es;                    \
+                }                                                       \
+              QUICKSORTS_COMMON__MEMCPY                                 \
+                (PFX##merge__out, PFX##merge__pa,                       \
+                 (size_t) (PFX##merge__end_a - PFX##merge__pa));        \
+            }                                                           \
+          else                                                          \
+            {                                                           \
+              /* Merge backwards, from the buffered second run. */      \
+              QUICKSORTS_COMMON__MEMCPY                                 \
+                (PFX##merge__buf, PFX##merge__mid, PFX##merge__n_hi);   \
+              char *PFX##merge__pa = PFX##merge__mid;                   \
+              char *PFX##merge__pb =                                    \
+                PFX##merge__buf + PFX##merge__n_hi;                     \
+              char *PFX##merge__out = PFX##merge__hi;                   \
+              while (PFX##merge__pa != PFX##merge__lo                   \
+                     && PFX##merge__pb != PFX##merge__buf)              \
+                {                                                       \
+                  PFX##merge__out -= PFX##merge__es;                    \
+                  if (LT ((const void *) (PFX##merge__pb                \
+                                          - PFX##merge__es),            \
+                          (const void *) (PFX##merge__pa                \
+                                          - PFX##merge__es)))           \
+                    {                                                   \
+                      PFX##merge__pa -= PFX##merge__es;                 \
+                      QUICKSORTS_COMMON__MEMCPY                         \
+                        (PFX##merge__out, PFX##merge__pa,               \
+                         PFX##merge__es);                               \
+                    }                                                   \
+                  else                                                  \
+                    {                                                   \
+                      PFX##merge__pb -= PFX##merge__es;                 \
+                      QUICKSORTS_COMMON__MEMCPY                         \
+                        (PFX##merge__out, PFX##merge__pb,               \
+                         PFX##merge__es);                               \
+                    }                                                   \
+                }                                                       \
+              QUICKSORTS_COMMON__MEMCPY                                 \
+                (PFX##merge__lo, PFX##merge__buf,                       \
+                 (size_t) (PFX##merge__pb - PFX##merge__buf));          \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_PAIR__TYPED(PFX, T, LT,   \
+                                                          P, N1, N,     \
+                                                          BUF)          \
+  do                                                                    \
+    {                                                                   \
+      T *PFX##merge__lo = (P);                                          \
+      T *PFX##merge__mid = PFX##merge__lo + (N1);                       \
+      T *PFX##merge__hi = PFX##merge__lo + (N);                         \
+      T *PFX##merge__buf = (BUF);                                       \
+      if (LT (PFX##merge__mid, PFX##merge__mid - 1))                    \
+        {                                                               \
+          /* Skip what precedes the first of the second run. */         \
+          size_t PFX##merge__a = 0;                                     \
+          size_t PFX##merge__b = (N1);                                  \
+          while (PFX##merge__a != PFX##merge__b)                        \
+            {                                                           \
+              const size_t PFX##merge__m =                              \
+                PFX##merge__a + ((PFX##merge__b - PFX##merge__a) / 2);  \
+              if (LT (PFX##merge__mid, PFX##merge__lo + PFX##merge__m)) \
+                PFX##merge__b = PFX##merge__m;                          \
+              else                                                      \
+                PFX##merge__a = PFX##merge__m + 1;                      \
+            }                                                           \
+          PFX##merge__lo += PFX##merge__a;                              \
+                                                                        \
+          /* Skip what follows the last of the first run. */            \
+          PFX##merge__a = 0;                                            \
+          PFX##merge__b = (N) - (N1);                                   \
+          while (PFX##merge__a != PFX##merge__b)                        \
+            {                                                           \
+              const size_t PFX##merge__m =                              \
+                PFX##merge__a + ((PFX##merge__b - PFX##merge__a) / 2);  \
+              if (LT (PFX##merge__mid + PFX##merge__m,                  \
+                      PFX##merge__mid - 1))                             \
+                PFX##merge__a = PFX##merge__m + 1;                      \
+              else                                                      \
+                PFX##merge__b = PFX##merge__m;                          \
+            }                                                           \
+          PFX##merge__hi = PFX##merge__mid + PFX##merge__a;             \
+                                                                        \
+          const size_t PFX##merge__n_lo =                               \
+            (size_t) (PFX##merge__mid - PFX##merge__lo);                \
+          const size_t PFX##merge__n_hi =                               \
+            (size_t) (PFX##merge__hi - PFX##merge__mid);                \
+          QUICKSORTS_COMMON__STATS_MOVED                                \
+            (0, (PFX##merge__n_lo + PFX##merge__n_hi) * sizeof (T));    \
+          if (PFX##merge__n_lo <= PFX##merge__n_hi)                     \
+            {                                                           \
+              /* Merge forwards, from the buffered first run. */        \
+              QUICKSORTS_COMMON__MEMCPY                                 \
+                (PFX##merge__buf, PFX##merge__lo,                       \
+                 PFX##merge__n_lo * sizeof (T));                        \
+              T *PFX##merge__pa = PFX##merge__buf;                      \
+              T *PFX##merge__end_a =                                    \
+                PFX##merge__buf + PFX##merge__n_lo;                     \
+              T *PFX##merge__pb = PFX##merge__mid;                      \
+              T *PFX##merge__out = PFX##merge__lo;                      \
+              while (PFX##merge__pa != PFX##merge__end_a                \
+                     && PFX##merge__pb != PFX##merge__hi)               \
+                {                                                       \
+                  if (LT (PFX##merge__pb, PFX##merge__pa))              \
+                    *PFX##merge__out++ = *PFX##merge__pb++;             \
+                  else                                                  \
+                    *PFX##merge__out++ = *PFX##merge__pa++;             \
+                }                                                       \
+              while (PFX##merge__pa != PFX##merge__end_a)               \
+                *PFX##merge__out++ = *PFX##merge__pa++;                 \
+            }                                                           \
+          else                                                          \
+            {                                                           \
+              /* Merge backwards, from the buffered second run. */      \
+              QUICKSORTS_COMMON__MEMCPY                                 \
+                (PFX##merge__buf, PFX##merge__mid,                      \
+                 PFX##merge__n_hi * sizeof (T));                        \
+              T *PFX##merge__pa = PFX##merge__mid;                      \
+              T *PFX##merge__pb = PFX##merge__buf + PFX##merge__n_hi;   \
+              T *PFX##merge__out = PFX##merge__hi;                      \
+              while (PFX##merge__pa != PFX##merge__lo                   \
+                     && PFX##merge__pb != PFX##merge__buf)              \
+                {                                                       \
+                  if (LT (PFX##merge__pb - 1, PFX##merge__pa - 1))      \
+                    *--PFX##merge__out = *--PFX##merge__pa;             \
+                  else                                                  \
+                    *--PFX##merge__out = *--PFX##merge__pb;             \
+                }                                                       \
+              while (PFX##merge__pb != PFX##merge__buf)                 \
+                *--PFX##merge__out = *--PFX##merge__pb;                 \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+/* Merge as MERGE_PAIR does, but through a BUF of only BUF_NMEMB >= 1
+   elements. Runs too long for it are first cut, by binary search,
+   into a left and a right part, each taking a piece of either run,
+   such that nothing on the left is greater than anything on the
+   right; rotating the two middle pieces past each other leaves two
+   smaller merges, done the same way. The part with more elements
+   waits on a stack, which therefore never holds more entries than
+   there are bits in a size_t. */
+#define QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_BOUNDED(PFX, LT, P,       \
+                                                      N1, N, BUF,       \
+                                                      BUF_NMEMB)        \
+  do                                                                    \
+    {                                                                   \
+      struct { char *p; size_t n1; size_t n; }                          \
+        PFX##bm__stk[CHAR_BIT * sizeof (size_t)];                       \
+      size_t PFX##bm__depth = 0;                                        \
+      const size_t PFX##bm__es = PFX##elemsz;                           \
+      const size_t PFX##bm__cap = (BUF_NMEMB);                          \
+      char *PFX##bm__p = (P);                                           \
+      size_t PFX##bm__n1 = (N1);                                        \
+      size_t PFX##bm__n = (N);                                          \
+      for (;;)                                                          \
+        {                                                               \
+          const size_t PFX##bm__n2 =                                    \
+            PFX##bm__n - PFX##bm__n1;                                   \
+          char *const PFX##bm__mid =                                    \
+            PFX##bm__p + (PFX##bm__n1 * PFX##bm__es);                   \
+          if (PFX##bm__n1 == 0 || PFX##bm__n2 == 0)                     \
+            {                                                           \
+              /* One run is empty: nothing to merge. */                 \
+            }                                                           \
+          else if (PFX##bm__n1 <= PFX##bm__cap                          \
+                   || PFX##bm__n2 <= PFX##bm__cap)                      \
+            QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_PAIR                  \
+              (PFX, LT, PFX##bm__p, PFX##bm__n1,                        \
+               PFX##bm__n, (BUF));                                      \
+          else                                                          \
+            {                                                           \
+              /* Halve the longer run; find where its middle element */ \
+              /* falls in the other.                                 */ \
+              size_t PFX##bm__c1;                                       \
+              size_t PFX##bm__c2;                                       \
+              size_t PFX##bm__a = 0;                                    \
+              size_t PFX##bm__b;                                        \
+              if (PFX##bm__n2 <= PFX##bm__n1)                           \
+                {                                                       \
+                  PFX##bm__c1 = PFX##bm__n1 / 2;                        \
+                  const char *const PFX##bm__x =                        \
+                    PFX##bm__p + (PFX##bm__c1 * PFX##bm__es);           \
+                  PFX##bm__b = PFX##bm__n2;                             \
+                  while (PFX##bm__a != PFX##bm__b)                      \
+                    {                                                   \
+                      const size_t PFX##bm__m = PFX##bm__a              \
+                        + ((PFX##bm__b - PFX##bm__a) / 2);              \
+                      if (LT ((const void *) (PFX##bm__mid              \
+                                              + (PFX##bm__m             \
+                                                 * PFX##bm__es)),       \
+                              (const void *) PFX##bm__x))               \
+                        PFX##bm__a = PFX##bm__m + 1;                    \
+                      else                                              \
+                        PFX##bm__b = PFX##bm__m;                        \
+                    }                                                   \
+                  PFX##bm__c2 = PFX##bm__a;                             \
+                }                                                       \
+              else                                                      \
+                {                                                       \
+                  PFX##bm__c2 = PFX##bm__n2 / 2;                        \
+                  const char *const PFX##bm__x =                        \
+                    PFX##bm__mid + (PFX##bm__c2 * PFX##bm__es);         \
+                  PFX##bm__b = PFX##bm__n1;                             \
+                  while (PFX##bm__a != PFX##bm__b)                      \
+                    {                                                   \
+                      const size_t PFX##bm__m = PFX##bm__a              \
+                        + ((PFX##bm__b - PFX##bm__a) / 2);              \
+                      if (LT ((const void *) PFX##bm__x,                \
+                              (const void *) (PFX##bm__p                \
+                                              + (PFX##bm__m             \
+                                                 * PFX##bm__es))))      \
+                        PFX##bm__b = PFX##bm__m;                        \
+                      else                                              \
+                        PFX##bm__a = PFX##bm__m + 1;                    \
+                    }                                                   \
+                  PFX##bm__c1 = PFX##bm__a;                             \
+                }                                                       \
+              quicksorts_common__rotate                                 \
+                (PFX##bm__p + (PFX##bm__c1 * PFX##bm__es),              \
+                 PFX##bm__n1 - PFX##bm__c1,                             \
+                 (PFX##bm__n1 - PFX##bm__c1) + PFX##bm__c2,             \
+                 PFX##bm__es);                                          \
+                                                                        \
+              /* Go on with the smaller part; stack the larger. */      \
+              const size_t PFX##bm__n_left =                            \
+                PFX##bm__c1 + PFX##bm__c2;                              \
+              char *PFX##bm__p_right =                                  \
+                PFX##bm__p + (PFX##bm__n_left * PFX##bm__es);           \
+              const size_t PFX##bm__n1_right =                          \
+                PFX##bm__n1 - PFX##bm__c1;                              \
+              const size_t PFX##bm__n_right =                           \
+                PFX##bm__n - PFX##bm__n_left;                           \
+              assert (PFX##bm__depth < CHAR_BIT * sizeof (size_t));     \
+              if (PFX##bm__n_left < PFX##bm__n_right)                   \
+                {                                                       \
+                  PFX##bm__stk[PFX##bm__depth].p =                      \
+                    PFX##bm__p_right;                                   \
+                  PFX##bm__stk[PFX##bm__depth].n1 =                     \
+                    PFX##bm__n1_right;                                  \
+                  PFX##bm__stk[PFX##bm__depth].n =                      \
+                    PFX##bm__n_right;                                   \
+                  PFX##bm__n1 = PFX##bm__c1;                            \
+                  PFX##bm__n = PFX##bm__n_left;                         \
+                }                                                       \
+              else                                                      \
+                {                                                       \
+                  PFX##bm__stk[PFX##bm__depth].p = PFX##bm__p;          \
+                  PFX##bm__stk[PFX##bm__depth].n1 =                     \
+                    PFX##bm__c1;                                        \
+                  PFX##bm__stk[PFX##bm__depth].n =                      \
+                    PFX##bm__n_left;                                    \
+                  PFX##bm__p = PFX##bm__p_right;                        \
+                  PFX##bm__n1 = PFX##bm__n1_right;                      \
+                  PFX##bm__n = PFX##bm__n_right;                        \
+                }                                                       \
+              PFX##bm__depth += 1;                                      \
+              continue;                                                 \
+            }                                                           \
+          if (PFX##bm__depth == 0)                                      \
+            break;                                                      \
+          PFX##bm__depth -= 1;                                          \
+          PFX##bm__p = PFX##bm__stk[PFX##bm__depth].p;                  \
+          PFX##bm__n1 = PFX##bm__stk[PFX##bm__depth].n1;                \
+          PFX##bm__n = PFX##bm__stk[PFX##bm__depth].n;                  \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_BOUNDED__TYPED(PFX, T,    \
+                                                             LT, P, N1, \
+                                                             N, BUF,    \
+                                                             BUF_NMEMB) \
+  do                                                                    \
+    {                                                                   \
+      struct { T *p; size_t n1; size_t n; }                             \
+        PFX##bm__stk[CHAR_BIT * sizeof (size_t)];                       \
+      size_t PFX##bm__depth = 0;                                        \
+      const size_t PFX##bm__cap = (BUF_NMEMB);                          \
+      T *PFX##bm__p = (P);                                              \
+      size_t PFX##bm__n1 = (N1);                                        \
+      size_t PFX##bm__n = (N);                                          \
+      for (;;)                                                          \
+        {                                                               \
+          const size_t PFX##bm__n2 = PFX##bm__n - PFX##bm__n1;          \
+          T *const PFX##bm__mid = PFX##bm__p + PFX##bm__n1;             \
+          if (PFX##bm__n1 == 0 || PFX##bm__n2 == 0)                     \
+            {                                                           \
+              /* One run is empty: nothing to merge. */                 \
+            }                                                           \
+          else if (PFX##bm__n1 <= PFX##bm__cap                          \
+                   || PFX##bm__n2 <= PFX##bm__cap)                      \
+            QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_PAIR__TYPED           \
+              (PFX, T, LT, PFX##bm__p, PFX##bm__n1, PFX##bm__n, (BUF)); \
+          else                                                          \
+            {                                                           \
+              /* Halve the longer run; find where its middle element */ \
+              /* falls in the other.                                 */ \
+              size_t PFX##bm__c1;                                       \
+              size_t PFX##bm__c2;                                       \
+              size_t PFX##bm__a = 0;                                    \
+              size_t PFX##bm__b;                                        \
+              if (PFX##bm__n2 <= PFX##bm__n1)                           \
+                {                                                       \
+                  PFX##bm__c1 = PFX##bm__n1 / 2;                        \
+                  T *const PFX##bm__x = PFX##bm__p + PFX##bm__c1;       \
+                  PFX##bm__b = PFX##bm__n2;                             \
+                  while (PFX##bm__a != PFX##bm__b)                      \
+                    {                                                   \
+                      const size_t PFX##bm__m =                         \
+                        PFX##bm__a + ((PFX##bm__b - PFX##bm__a) / 2);   \
+                      if (LT (PFX##bm__mid + PFX##bm__m, PFX##bm__x))   \
+                        PFX##bm__a = PFX##bm__m + 1;                    \
+                      else                                              \
+                        PFX##bm__b = PFX##bm__m;                        \
+                    }                                                   \
+                  PFX##bm__c2 = PFX##bm__a;                             \
+                }                                                       \
+              else                                                      \
+                {                                                       \
+                  PFX##bm__c2 = PFX##bm__n2 / 2;                        \
+                  T *const PFX##bm__x = PFX##bm__mid + PFX##bm__c2;     \
+                  PFX##bm__b = PFX##bm__n1;                             \
+                  while (PFX##bm__a != PFX##bm__b)                      \
+                    {                                                   \
+                      const size_t PFX##bm__m =                         \
+                        PFX##bm__a + ((PFX##bm__b - PFX##bm__a) / 2);   \
+                      if (LT (PFX##bm__x, PFX##bm__p + PFX##bm__m))     \
+                        PFX##bm__b = PFX##bm__m;                        \
+                      else                                              \
+                        PFX##bm__a = PFX##bm__m + 1;                    \
+                    }                                                   \
+                  PFX##bm__c1 = PFX##bm__a;                             \
+                }                                                       \
+              quicksorts_common__rotate                                 \
+                ((char *) (PFX##bm__p + PFX##bm__c1),                   \
+                 PFX##bm__n1 - PFX##bm__c1,                             \
+                 (PFX##bm__n1 - PFX##bm__c1) + PFX##bm__c2,             \
+                 sizeof (T));                                           \
+                                                                        \
+              /* Go on with the smaller part; stack the larger. */      \
+              const size_t PFX##bm__n_left = PFX##bm__c1 + PFX##bm__c2; \
+              T *PFX##bm__p_right = PFX##bm__p + PFX##bm__n_left;       \
+              const size_t PFX##bm__n1_right =                          \
+                PFX##bm__n1 - PFX##bm__c1;                              \
+              const size_t PFX##bm__n_right =                           \
+                PFX##bm__n - PFX##bm__n_left;                           \
+              assert (PFX##bm__depth < CHAR_BIT * sizeof (size_t));     \
+              if (PFX##bm__n_left < PFX##bm__n_right)                   \
+                {                                                       \
+                  PFX##bm__stk[PFX##bm__depth].p = PFX##bm__p_right;    \
+                  PFX##bm__stk[PFX##bm__depth].n1 = PFX##bm__n1_right;  \
+                  PFX##bm__stk[PFX##bm__depth].n = PFX##bm__n_right;    \
+                  PFX##bm__n1 = PFX##bm__c1;                            \
+                  PFX##bm__n = PFX##bm__n_left;                         \
+                }                                                       \
+              else                                                      \
+                {                                                       \
+                  PFX##bm__stk[PFX##bm__depth].p = PFX##bm__p;          \
+                  PFX##bm__stk[PFX##bm__depth].n1 = PFX##bm__c1;        \
+                  PFX##bm__stk[PFX##bm__depth].n = PFX##bm__n_left;     \
+                  PFX##bm__p = PFX##bm__p_right;                        \
+                  PFX##bm__n1 = PFX##bm__n1_right;                      \
+                  PFX##bm__n = PFX##bm__n_right;                        \
+                }                                                       \
+              PFX##bm__depth += 1;                                      \
+              continue;                                                 \
+            }                                                           \
+          if (PFX##bm__depth == 0)                                      \
+            break;                                                      \
+          PFX##bm__depth -= 1;                                          \
+          PFX##bm__p = PFX##bm__stk[PFX##bm__depth].p;                  \
+          PFX##bm__n1 = PFX##bm__stk[PFX##bm__depth].n1;                \
+          PFX##bm__n = PFX##bm__stk[PFX##bm__depth].n;                  \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+/* Scan PFX##arr for its runs, and set SORTED true if it was one run
+   or has been merged from a few. */
+#define QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_RUNS(PFX, LT, SORTED)     \
+  do                                                                    \
+    {                                                                   \
+      size_t PFX##runs__end[QUICKSORTS__UNSTABLE_QUICKSORT__MAX_RUNS];  \
+      size_t PFX##runs__k = 0;                                          \
+      bool PFX##runs__few = true;                                       \
+      char *PFX##runs__p = PFX##arr;                                    \
+      char *const PFX##runs__stop =                                     \
+        PFX##arr + (PFX##nmemb * PFX##elemsz);                          \
+      (SORTED) = false;                                                 \
+      do                                                                \
+        {                                                               \
+          char *const PFX##runs__start = PFX##runs__p;                  \
+          PFX##runs__p += PFX##elemsz;                                  \
+          if (PFX##runs__p != PFX##runs__stop                           \
+              && LT ((const void *) PFX##runs__p,                       \
+                     (const void *) (PFX##runs__p - PFX##elemsz)))      \
+            {                                                           \
+              /* Decreasing order. This sorts unstably. */              \
+              do                                                        \
+                PFX##runs__p += PFX##elemsz;                            \
+              while (PFX##runs__p != PFX##runs__stop                    \
+                     && !(LT ((const void *) (PFX##runs__p              \
+                                              - PFX##elemsz),           \
+                              (const void *) PFX##runs__p)));           \
+              quicksorts_common__reverse_prefix                         \
+                (PFX##runs__start,                                      \
+                 (size_t) (PFX##runs__p - PFX##runs__start)             \
+                 / PFX##elemsz, PFX##elemsz);                           \
+            }                                                           \
+          else                                                          \
+            while (PFX##runs__p != PFX##runs__stop                      \
+                   && !(LT ((const void *) PFX##runs__p,                \
+                            (const void *) (PFX##runs__p                \
+                                            - PFX##elemsz))))           \
+              PFX##runs__p += PFX##elemsz;                              \
+          if (PFX##runs__k == QUICKSORTS__UNSTABLE_QUICKSORT__MAX_RUNS) \
+            PFX##runs__few = false;                                     \
+          else                                                          \
+            {                                                           \
+              PFX##runs__end[PFX##runs__k] =                            \
+                (size_t) (PFX##runs__p - PFX##arr) / PFX##elemsz;       \
+              PFX##runs__k += 1;                                        \
+            }                                                           \
+        }                                                               \
+      while (PFX##runs__few && PFX##runs__p != PFX##runs__stop);        \
+                                                                        \
+      if (PFX##runs__few && PFX##runs__k == 1)                          \
+        (SORTED) = true;                                                \
+      else if (PFX##runs__few)                                          \
+        {                                                               \
+          /* Merge bottom up. The first pass only finds how big a */    \
+          /* buffer the second will need.                         */    \
+          size_t PFX##runs__need = 0;                                   \
+          const size_t PFX##runs__cap =                                 \
+            ((QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_BUFFER_SIZE)        \
+             / PFX##elemsz);                                            \
+          for (int PFX##runs__pass = 0; PFX##runs__pass != 2;           \
+               PFX##runs__pass += 1)                                    \
+            {                                                           \
+              char *PFX##runs__buf = NULL;                              \
+              if (PFX##runs__pass == 1)                                 \
+                {                                                       \
+                  if (PFX##runs__cap < PFX##runs__need)                 \
+                    PFX##runs__need =                                   \
+                      (PFX##runs__cap == 0) ? 1 : PFX##runs__cap;       \
+                  PFX##runs__buf =                                      \
+                    QUICKSORTS_COMMON__MALLOC                           \
+                      (PFX##runs__need * PFX##elemsz);                  \
+                  if (PFX##runs__buf == NULL)                           \
+                    break;                                              \
+                }                                                       \
+              for (size_t PFX##runs__w = 1;                             \
+                   PFX##runs__w < PFX##runs__k;                         \
+                   PFX##runs__w *= 2)                                   \
+                for (size_t PFX##runs__j = 0;                           \
+                     PFX##runs__j + PFX##runs__w < PFX##runs__k;        \
+                     PFX##runs__j += 2 * PFX##runs__w)                  \
+                  {                                                     \
+                    const size_t PFX##runs__i_lo =                      \
+                      (PFX##runs__j == 0) ?                             \
+                      0 : PFX##runs__end[PFX##runs__j - 1];             \
+                    const size_t PFX##runs__i_mid =                     \
+                      PFX##runs__end[PFX##runs__j + PFX##runs__w - 1];  \
+                    const size_t PFX##runs__i_hi =                      \
+                      PFX##runs__end                                    \
+                      [((PFX##runs__j + (2 * PFX##runs__w)              \
+                         < PFX##runs__k) ?                              \
+                        PFX##runs__j + (2 * PFX##runs__w) :             \
+                        PFX##runs__k) - 1];                             \
+                    if (PFX##runs__pass == 0)                           \
+                      {                                                 \
+                        size_t PFX##runs__m =                           \
+                          PFX##runs__i_mid - PFX##runs__i_lo;           \
+                        if (PFX##runs__i_hi - PFX##runs__i_mid          \
+                            < PFX##runs__m)                             \
+                          PFX##runs__m =                                \
+                            PFX##runs__i_hi - PFX##runs__i_mid;         \
+                        if (PFX##runs__need < PFX##runs__m)             \
+                          PFX##runs__need = PFX##runs__m;               \
+                      }                                                 \
+                    else                                                \
+                      QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_BOUNDED     \
+                        (PFX, LT,                                       \
+                         PFX##arr + (PFX##runs__i_lo * PFX##elemsz),    \
+                         PFX##runs__i_mid - PFX##runs__i_lo,            \
+                         PFX##runs__i_hi - PFX##runs__i_lo,             \
+                         PFX##runs__buf, PFX##runs__need);              \
+                  }                                                     \
+              if (PFX##runs__pass == 1)                                 \
+                {                                                       \
+                  QUICKSORTS_COMMON__FREE (PFX##runs__buf);             \
+                  (SORTED) = true;                                      \
+                }                                                       \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_RUNS__TYPED(PFX, T, LT,   \
+                                                          SORTED)       \
+  do                                                                    \
+    {                                                                   \
+      size_t PFX##runs__end[QUICKSORTS__UNSTABLE_QUICKSORT__MAX_RUNS];  \
+      size_t PFX##runs__k = 0;                                          \
+      bool PFX##runs__few = true;                                       \
+      T *PFX##runs__p = PFX##arr;                                       \
+      T *const PFX##runs__stop = PFX##arr + PFX##nmemb;                 \
+      (SORTED) = false;                                                 \
+      do                                                                \
+        {                                                               \
+          T *const PFX##runs__start = PFX##runs__p;                     \
+          PFX##runs__p += 1;                                            \
+          if (PFX##runs__p != PFX##runs__stop                           \
+              && LT (PFX##runs__p, PFX##runs__p - 1))                   \
+            {                                                           \
+              /* Decreasing order. This sorts unstably. */              \
+              do                                                        \
+                PFX##runs__p += 1;                                      \
+              while (PFX##runs__p != PFX##runs__stop                    \
+                     && !(LT (PFX##runs__p - 1, PFX##runs__p)));        \
+              QUICKSORTS_COMMON__REVERSE_PREFIX__TYPED                  \
+                (PFX##runs__, T, PFX##runs__start,                      \
+                 PFX##runs__p - PFX##runs__start);                      \
+            }                                                           \
+          else                                                          \
+            while (PFX##runs__p != PFX##runs__stop                      \
+                   && !(LT (PFX##runs__p, PFX##runs__p - 1)))           \
+              PFX##runs__p += 1;                                        \
+          if (PFX##runs__k == QUICKSORTS__UNSTABLE_QUICKSORT__MAX_RUNS) \
+            PFX##runs__few = false;                                     \
+          else                                                          \
+            {                                                           \
+              PFX##runs__end[PFX##runs__k] =                            \
+                (size_t) (PFX##runs__p - PFX##arr);                     \
+              PFX##runs__k += 1;                                        \
+            }                                                           \
+        }                                                               \
+      while (PFX##runs__few && PFX##runs__p != PFX##runs__stop);        \
+                                                                        \
+      if (PFX##runs__few && PFX##runs__k == 1)                          \
+        (SORTED) = true;                                                \
+      else if (PFX##runs__few)                                          \
+        {                                                               \
+          /* Merge bottom up. The first pass only finds how big a */    \
+          /* buffer the second will need.                         */    \
+          size_t PFX##runs__need = 0;                                   \
+          const size_t PFX##runs__cap =                                 \
+            ((QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_BUFFER_SIZE)        \
+             / sizeof (T));                                             \
+          for (int PFX##runs__pass = 0; PFX##runs__pass != 2;           \
+               PFX##runs__pass += 1)                                    \
+            {                                                           \
+              T *PFX##runs__buf = NULL;                                 \
+              if (PFX##runs__pass == 1)                                 \
+                {                                                       \
+                  if (PFX##runs__cap < PFX##runs__need)                 \
+                    PFX##runs__need =                                   \
+                      (PFX##runs__cap == 0) ? 1 : PFX##runs__cap;       \
+                  PFX##runs__buf =                                      \
+                    QUICKSORTS_COMMON__MALLOC                           \
+                      (PFX##runs__need * sizeof (T));                   \
+                  if (PFX##runs__buf == NULL)                           \
+                    break;                                              \
+                }                                                       \
+              for (size_t PFX##runs__w = 1;                             \
+                   PFX##runs__w < PFX##runs__k;                         \
+                   PFX##runs__w *= 2)                                   \
+                for (size_t PFX##runs__j = 0;                           \
+                     PFX##runs__j + PFX##runs__w < PFX##runs__k;        \
+                     PFX##runs__j += 2 * PFX##runs__w)                  \
+                  {                                                     \
+                    const size_t PFX##runs__i_lo =                      \
+                      (PFX##runs__j == 0) ?                             \
+                      0 : PFX##runs__end[PFX##runs__j - 1];             \
+                    const size_t PFX##runs__i_mid =                     \
+                      PFX##runs__end[PFX##runs__j + PFX##runs__w - 1];  \
+                    const size_t PFX##runs__i_hi =                      \
+                      PFX##runs__end                                    \
+                      [((PFX##runs__j + (2 * PFX##runs__w)              \
+                         < PFX##runs__k) ?                              \
+                        PFX##runs__j + (2 * PFX##runs__w) :             \
+                        PFX##runs__k) - 1];                             \
+                    if (PFX##runs__pass == 0)                           \
+                      {                                                 \
+                        size_t PFX##runs__m =                           \
+                          PFX##runs__i_mid - PFX##runs__i_lo;           \
+                        if (PFX##runs__i_hi - PFX##runs__i_mid          \
+                            < PFX##runs__m)                             \
+                          PFX##runs__m =                                \
+                            PFX##runs__i_hi - PFX##runs__i_mid;         \
+                        if (PFX##runs__need < PFX##runs__m)             \
+                          PFX##runs__need = PFX##runs__m;               \
+                      }                                                 \
+                    else                                                \
+                      QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_BOUNDED__TYPED \
+                        (PFX, T, LT, PFX##arr + PFX##runs__i_lo,        \
+                         PFX##runs__i_mid - PFX##runs__i_lo,            \
+                         PFX##runs__i_hi - PFX##runs__i_lo,             \
+                         PFX##runs__buf, PFX##runs__need);              \
+                  }                                                     \
+              if (PFX##runs__pass == 1)                                 \
+                {                                                       \
+                  QUICKSORTS_COMMON__FREE (PFX##runs__buf);             \
+                  (SORTED) = true;                                      \
+                }                                                       \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+/*
+  A PARTITION macro leaves the pivot (or, for three-way partitioning,
+  the block of elements equal to it) in its final position, sets
+  PFX##i_pivot and PFX##p_pivot to the start of that block and
+  PFX##n_pivot to its length. Everything before the block is less
+  than or equal to the pivot, and everything after it is greater
+  than or equal. PFX##swapped is set false if the subarray turned out
+  to be partitioned already, and true otherwise.
+*/
+#define QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT(PFX, BASE, NMEMB,     \
+                                                  ELEMSZ, LT,           \
+                                                  PIVOT_SELECTION,      \
+                                                  SMALL_SIZE,           \
+                                                  SMALL_SORT,           \
+                                                  PARTITION)            \
+  do                                                                    \
+    {                                                                   \
+      char *PFX##arr = (void *) (BASE);                                 \
+      size_t PFX##nmemb = (size_t) (NMEMB);                             \
+      size_t PFX##elemsz = (size_t) (ELEMSZ);                           \
+                                                                        \
+      if (0 < PFX##elemsz && 2 <= PFX##nmemb                            \
+          && PFX##nmemb <= (SMALL_SIZE))                                \
+        {                                                               \
+          /* A tiny array needs no partitioning, and so no stack. */    \
+          QUICKSORTS_COMMON__STATS_SMALL_SORT_BEGIN (PFX);              \
+          SMALL_SORT (PFX, PFX##arr, PFX##nmemb, PFX##elemsz, LT,       \
+                      (SMALL_SIZE));                                    \
+          QUICKSORTS_COMMON__STATS_SMALL_SORT_END (PFX, PFX##nmemb);    \
+        }                                                               \
+      else if (0 < PFX##elemsz && 2 <= PFX##nmemb)                      \
+        {                                                               \
+          size_t PFX##i_pivot;                                          \
+          size_t PFX##n_pivot;                                          \
+          bool PFX##swapped;                                            \
+          char *PFX##p_pivot;                                           \
+          char *PFX##hole__tmp = NULL;                                  \
+          int PFX##depth;                                               \
+          bool PFX##sorted;                                             \
+                                                                        \
+          QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_RUNS                    \
+            (PFX, LT, PFX##sorted);                                     \
+          QUICKSORTS_COMMON__STK_MAKE (PFX);                            \
+          if (!PFX##sorted)                                             \
+            QUICKSORTS_COMMON__STK_PUSH                                 \
+              (PFX, PFX##arr, PFX##nmemb,                               \
+               quicksorts_common__depth_limit (PFX##nmemb));            \
+          while (PFX##stk_depth != 0)                                   \
+            {                                                           \
+              QUICKSORTS_COMMON__STK_POP (PFX);                         \
+              if (PFX##nmemb <= (SMALL_SIZE))                           \
+                {                                                       \
+                  QUICKSORTS_COMMON__STATS_SMALL_SORT_BEGIN (PFX);      \
+                  SMALL_SORT (PFX, PFX##arr, PFX##nmemb, PFX##elemsz,   \
+                              LT, (SMALL_SIZE));                        \
+                  QUICKSORTS_COMMON__STATS_SMALL_SORT_END               \
+                    (PFX, PFX##nmemb);                                  \
+                }                                                       \
+              else if (PFX##depth == 0)                                 \
+                {                                                       \
+                  /* Partitioning has gone on too long. Guarantee */    \
+                  /* O(n log n) by finishing with heapsort.       */    \
+                  QUICKSORTS_COMMON__STATS_HEAP_SORT ();                \
+                  QUICKSORTS__UNSTABLE_QUICKSORT__HEAP_SORT             \
+                    (PFX, PFX##arr, PFX##nmemb, PFX##elemsz, LT,        \
+                     (SMALL_SIZE));                                     \
+                }                                                       \
+              else                                                      \
+                {                                                       \
+                  PARTITION (PFX, LT, PIVOT_SELECTION);                 \
+                  (void) PFX##swapped;                                  \
+                                                                        \
+                  /* Push the larger part of the partition first. */    \
+                  /* Otherwise the stack may overflow.            */    \
+                                                                        \
+                  size_t PFX##n_le = PFX##i_pivot;                      \
+                  size_t PFX##n_ge =                                    \
+                    PFX##nmemb - PFX##n_pivot - PFX##i_pivot;           \
+                  QUICKSORTS_COMMON__STATS_PARTITION                    \
+                    (PFX##n_le, PFX##n_ge);                             \
+                  if (PFX##n_le < PFX##n_ge)                            \
+                    {                                                   \
+                      QUICKSORTS_COMMON__STK_PUSH                       \
+                        (PFX,                                           \
+                         PFX##p_pivot + (PFX##n_pivot * PFX##elemsz),   \
+                         PFX##n_ge, PFX##depth - 1);                    \
+                      if (PFX##n_le != 0)                               \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX, PFX##arr, PFX##n_le, PFX##depth - 1);   \
+                    }                                                   \
+                  else                                                  \
+                    {                                                   \
+                      QUICKSORTS_COMMON__STK_PUSH                       \
+                        (PFX, PFX##arr, PFX##n_le, PFX##depth - 1);     \
+                      if (PFX##n_ge != 0)                               \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX,                                         \
+                           PFX##p_pivot + (PFX##n_pivot * PFX##elemsz), \
+                           PFX##n_ge, PFX##depth - 1);                  \
+                    }                                                   \
+                }                                                       \
+            }                                                           \
+          if (PFX##hole__tmp != NULL)                                   \
+            QUICKSORTS_COMMON__FREE (PFX##hole__tmp);                   \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT__TYPED(PFX, T, BASE, \
+                                                         NMEMB, LT,     \
+                                                         PIVOT_SELECTION, \
+                                                         SMALL_SIZE,    \
+                                                         SMALL_SORT,    \
+                                                         PARTITION)     \
+  do                                                                    \
+    {                                                                   \
+      T *PFX##arr = (T *) (BASE);                                       \
+      size_t PFX##nmemb = (size_t) (NMEMB);                             \
+                                                                        \
+      if (0 < sizeof (T) && 2 <= PFX##nmemb                             \
+          && PFX##nmemb <= (SMALL_SIZE))                                \
+        {                                                               \
+          /* A tiny array needs no partitioning, and so no stack. */    \
+          QUICKSORTS_COMMON__STATS_SMALL_SORT_BEGIN (PFX);              \
+          SMALL_SORT (PFX, T, PFX##arr, PFX##nmemb, LT, (SMALL_SIZE));  \
+          QUICKSORTS_COMMON__STATS_SMALL_SORT_END (PFX, PFX##nmemb);    \
+        }                                                               \
+      else if (0 < sizeof (T) && 2 <= PFX##nmemb)                       \
+        {                                                               \
+          size_t PFX##i_pivot;                                          \
+          size_t PFX##n_pivot;                                          \
+          bool PFX##swapped;                                            \
+          T *PFX##p_pivot;                                              \
+          int PFX##depth;                                               \
+          bool PFX##sorted;                                             \
+                                                                        \
+          QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_RUNS__TYPED             \
+            (PFX, T, LT, PFX##sorted);                                  \
+          QUICKSORTS_COMMON__STK_MAKE (PFX);                            \
+          if (!PFX##sorted)                                             \
+            QUICKSORTS_COMMON__STK_PUSH                                 \
+              (PFX, PFX##arr, PFX##nmemb,                               \
+               quicksorts_common__depth_limit (PFX##nmemb));            \
+          while (PFX##stk_depth != 0)                                   \
+            {                                                           \
+              QUICKSORTS_COMMON__STK_POP (PFX);                         \
+              if (PFX##nmemb <= (SMALL_SIZE))                           \
+                {                                                       \
+                  QUICKSORTS_COMMON__STATS_SMALL_SORT_BEGIN (PFX);      \
+                  SMALL_SORT (PFX, T, PFX##arr, PFX##nmemb, LT,         \
+                              (SMALL_SIZE));                            \
+                  QUICKSORTS_COMMON__STATS_SMALL_SORT_END               \
+                    (PFX, PFX##nmemb);                                  \
+                }                                                       \
+              else if (PFX##depth == 0)                                 \
+                {                                                       \
+                  /* Partitioning has gone on too long. Guarantee */    \
+                  /* O(n log n) by finishing with heapsort.       */    \
+                  QUICKSORTS_COMMON__STATS_HEAP_SORT ();                \
+                  QUICKSORTS__UNSTABLE_QUICKSORT__HEAP_SORT__TYPED      \
+                    (PFX, T, PFX##arr, PFX##nmemb, LT, (SMALL_SIZE));   \
+                }                                                       \
+              else                                                      \
+                {                                                       \
+                  PARTITION (PFX, T, LT, PIVOT_SELECTION);              \
+                  (void) PFX##swapped;                                  \
+                                                                        \
+                  /* Push the larger part of the partition first. */    \
+                  /* Otherwise the stack may overflow.            */    \
+                                                                        \
+                  size_t PFX##n_le = PFX##i_pivot;                      \
+                  size_t PFX##n_ge =                                    \
+                    PFX##nmemb - PFX##n_pivot - PFX##i_pivot;           \
+                  QUICKSORTS_COMMON__STATS_PARTITION                    \
+                    (PFX##n_le, PFX##n_ge);                             \
+                  if (PFX##n_le < PFX##n_ge)                            \
+                    {                                                   \
+                      QUICKSORTS_COMMON__STK_PUSH                       \
+                        (PFX, PFX##p_pivot + PFX##n_pivot, PFX##n_ge,   \
+                         PFX##depth - 1);                               \
+                      if (PFX##n_le != 0)                               \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX, PFX##arr, PFX##n_le, PFX##depth - 1);   \
+                    }                                                   \
+                  else                                                  \
+                    {                                                   \
+                      QUICKSORTS_COMMON__STK_PUSH                       \
+                        (PFX, PFX##arr, PFX##n_le, PFX##depth - 1);     \
+                      if (PFX##n_ge != 0)                               \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX, PFX##p_pivot + PFX##n_pivot, PFX##n_ge, \
+                           PFX##depth - 1);                             \
+                    }                                                   \
+                }                                                       \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+/*
+  A QUICKSORT for element sizes known only at run time, such as
+  unstable_qsort needs.
+
+  Arrays of 4, 8, 16, 24, 32 or 64-byte elements, aligned for words of
+  their size class, are sorted by typed instantiations of the driver,
+  which move elements as words and do their index arithmetic with the
+  element size known at compile time. The word types are declared
+  may_alias, since they are only stand-ins for the caller's element
+  type; where the compiler has no such attribute, every array goes to
+  the byte-oriented driver, as do arrays of other sizes. SMALL_SORT
+  and PARTITION are given by the names of untyped macros that have
+  __TYPED counterparts.
+*/
+
+typedef struct
+{
+  uint32_t w[1];
+} QUICKSORTS_COMMON__MAY_ALIAS quicksorts__unstable_quicksort__words4_t;
+
+typedef struct
+{
+  uint64_t w[1];
+} QUICKSORTS_COMMON__MAY_ALIAS quicksorts__unstable_quicksort__words8_t;
+
+typedef struct
+{
+  uint64_t w[2];
+} QUICKSORTS_COMMON__MAY_ALIAS quicksorts__unstable_quicksort__words16_t;
+
+typedef struct
+{
+  uint64_t w[3];
+} QUICKSORTS_COMMON__MAY_ALIAS quicksorts__unstable_quicksort__words24_t;
+
+typedef struct
+{
+  uint64_t w[4];
+} QUICKSORTS_COMMON__MAY_ALIAS quicksorts__unstable_quicksort__words32_t;
+
+typedef struct
+{
+  uint64_t w[8];
+} QUICKSORTS_COMMON__MAY_ALIAS quicksorts__unstable_quicksort__words64_t;
+
+#define QUICKSORTS__UNSTABLE_QUICKSORT__TYPED_NAME(NAME)    \
+  QUICKSORTS__UNSTABLE_QUICKSORT__TYPED_NAME_ (NAME)
+#define QUICKSORTS__UNSTABLE_QUICKSORT__TYPED_NAME_(NAME) NAME##__TYPED
+
+#define QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT_BY_SIZE(PFX, BASE,    \
+                                                          NMEMB,        \
+                                                          ELEMSZ, LT,   \
+                                                          PIVOT_SELECTION, \
+                                                          SMALL_SIZE,   \
+                                                          SMALL_SORT,   \
+                                                          PARTITION)    \
+  do                                                                    \
+    {                                                                   \
+      char *PFX##by_size__base = (void *) (BASE);                       \
+      const size_t PFX##by_size__nmemb = (size_t) (NMEMB);              \
+      const size_t PFX##by_size__elemsz = (size_t) (ELEMSZ);            \
+      const size_t PFX##by_size__align =                                \
+        (PFX##by_size__elemsz == 4) ?                                   \
+        _Alignof (uint32_t) : _Alignof (uint64_t);                      \
+      const size_t PFX##by_size__class =                                \
+        ((QUICKSORTS_COMMON__HAVE_MAY_ALIAS)                            \
+         && (uintptr_t) PFX##by_size__base % PFX##by_size__align == 0) ? \
+        PFX##by_size__elemsz : 0;                                       \
+      switch (PFX##by_size__class)                                      \
+        {                                                               \
+        case 4:                                                         \
+          QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT__TYPED              \
+            (PFX##w4__, quicksorts__unstable_quicksort__words4_t,       \
+             PFX##by_size__base, PFX##by_size__nmemb, LT,               \
+             PIVOT_SELECTION, (SMALL_SIZE),                             \
+             QUICKSORTS__UNSTABLE_QUICKSORT__TYPED_NAME (SMALL_SORT),   \
+             QUICKSORTS__UNSTABLE_QUICKSORT__TYPED_NAME (PARTITION));   \
+          break;                                                        \
+        case 8:                                                         \
+          QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT__TYPED              \
+            (PFX##w8__, quicksorts__unstable_quicksort__words8_t,       \
+             PFX##by_size__base, PFX##by_size__nmemb, LT,               \
+             PIVOT_SELECTION, (SMALL_SIZE),                             \
+             QUICKSORTS__UNSTABLE_QUICKSORT__TYPED_NAME (SMALL_SORT),   \
+             QUICKSORTS__UNSTABLE_QUICKSORT__TYPED_NAME (PARTITION));   \
+          break;                                                        \
+        case 16:                                                        \
+          QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT__TYPED              \
+            (PFX##w16__, quicksorts__unstable_quicksort__words16_t,     \
+             PFX##by_size__base, PFX##by_size__nmemb, LT,               \
+             PIVOT_SELECTION, (SMALL_SIZE),                             \
+             QUICKSORTS__UNSTABLE_QUICKSORT__TYPED_NAME (SMALL_SORT),   \
+             QUICKSORTS__UNSTABLE_QUICKSORT__TYPED_NAME (PARTITION));   \
+          break;                                                        \
+        case 24:                                                        \
+          QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT__TYPED              \
+            (PFX##w24__, quicksorts__unstable_quicksort__words24_t,     \
+             PFX##by_size__base, PFX##by_size__nmemb, LT,               \
+             PIVOT_SELECTION, (SMALL_SIZE),                             \
+             QUICKSORTS__UNSTABLE_QUICKSORT__TYPED_NAME (SMALL_SORT),   \
+             QUICKSORTS__UNSTABLE_QUICKSORT__TYPED_NAME (PARTITION));   \
+          break;                                                        \
+        case 32:                                                        \
+          QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT__TYPED              \
+            (PFX##w32__, quicksorts__unstable_quicksort__words32_t,     \
+             PFX##by_size__base, PFX##by_size__nmemb, LT,               \
+             PIVOT_SELECTION, (SMALL_SIZE),                             \
+             QUICKSORTS__UNSTABLE_QUICKSORT__TYPED_NAME (SMALL_SORT),   \
+             QUICKSORTS__UNSTABLE_QUICKSORT__TYPED_NAME (PARTITION));   \
+          break;                                                        \
+        case 64:                                                        \
+          QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT__TYPED              \
+            (PFX##w64__, quicksorts__unstable_quicksort__words64_t,     \
+             PFX##by_size__base, PFX##by_size__nmemb, LT,               \
+             PIVOT_SELECTION, (SMALL_SIZE),                             \
+             QUICKSORTS__UNSTABLE_QUICKSORT__TYPED_NAME (SMALL_SORT),   \
+             QUICKSORTS__UNSTABLE_QUICKSORT__TYPED_NAME (PARTITION));   \
+          break;                                                        \
+        default:                                                        \
+          QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT                     \
+            (PFX##bytes__, PFX##by_size__base, PFX##by_size__nmemb,     \
+             PFX##by_size__elemsz, LT, PIVOT_SELECTION, (SMALL_SIZE),   \
+             SMALL_SORT, PARTITION);                                    \
+          break;                                                        \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+/*
+  A QUICKSORT for big elements, such as unstable_qsort_indirect
+  needs. It sorts pointers to the elements, comparing them with
+  LT_INDIRECT, which must apply LT to the elements that two pointers
+  point to, and then moves each element once into its place. The
+  pointers and a temporary element come from
+  QUICKSORTS_COMMON__MALLOC; if they cannot be had, the elements are
+  sorted where they lie. SMALL_SORT and PARTITION are given as for
+  QUICKSORT_BY_SIZE. SMALL_SIZE is for the pointers.
+*/
+#define QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT_INDIRECT(PFX, BASE,   \
+                                                           NMEMB,       \
+                                                           ELEMSZ, LT,  \
+                                                           LT_INDIRECT, \
+                                                           PIVOT_SELECTION, \
+                                                           SMALL_SIZE,  \
+                                                           SMALL_SORT,  \
+                                                           PARTITION)   \
+  do                                                                    \
+    {                                                                   \
+      char *PFX##ind__base = (void *) (BASE);                           \
+      const size_t PFX##ind__nmemb = (size_t) (NMEMB);                  \
+      const size_t PFX##ind__elemsz = (size_t) (ELEMSZ);                \
+      char **PFX##ind__ptrs = NULL;                                     \
+      char *PFX##ind__tmp = NULL;                                       \
+      if (2 <= PFX##ind__nmemb && 0 < PFX##ind__elemsz                  \
+          && PFX##ind__nmemb <= SIZE_MAX / sizeof (char *))             \
+        {                                                               \
+          PFX##ind__ptrs =                                              \
+            QUICKSORTS_COMMON__MALLOC (PFX##ind__nmemb * sizeof (char *)); \
+          PFX##ind__tmp = QUICKSORTS_COMMON__MALLOC (PFX##ind__elemsz); \
+        }                                                               \
+      if (PFX##ind__ptrs == NULL || PFX##ind__tmp == NULL)              \
+        QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT                       \
+          (PFX##bytes__, PFX##ind__base, PFX##ind__nmemb,               \
+           PFX##ind__elemsz, LT, PIVOT_SELECTION, (SMALL_SIZE),         \
+           SMALL_SORT, PARTITION);                                      \
+      else                                                              \
+        {                                                               \
+          for (size_t PFX##i = 0; PFX##i != PFX##ind__nmemb; PFX##i += 1) \
+            PFX##ind__ptrs[PFX##i] =                                    \
+              PFX##ind__base + (PFX##i * PFX##ind__elemsz);             \
+          QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT__TYPED              \
+            (PFX##ptrs__, char *, PFX##ind__ptrs, PFX##ind__nmemb,      \
+             LT_INDIRECT, PIVOT_SELECTION, (SMALL_SIZE),                \
+             QUICKSORTS__UNSTABLE_QUICKSORT__TYPED_NAME (SMALL_SORT),   \
+             QUICKSORTS__UNSTABLE_QUICKSORT__TYPED_NAME (PARTITION));   \
+          quicksorts_common__permute_by_pointers                        \
+            (PFX##ind__base, PFX##ind__nmemb, PFX##ind__elemsz,         \
+             PFX##ind__ptrs, PFX##ind__tmp);                            \
+        }                                                               \
+      QUICKSORTS_COMMON__FREE (PFX##ind__tmp);                          \
+      QUICKSORTS_COMMON__FREE (PFX##ind__ptrs);                         \
+    }                                                                   \
+  while (0)
+
+/* The number of element moves after which a partial insertion sort
+   gives up and leaves the subarray to be partitioned. */
+#define QUICKSORTS__UNSTABLE_QUICKSORT__PARTIAL_INSERTION_LIMIT 8
+
+/* Try to finish a subarray with an insertion sort, giving up once
+   more than MOVE_LIMIT elements have had to move. RESULT is set true
+   if the subarray got sorted. */
+#define QUICKSORTS__UNSTABLE_QUICKSORT__PARTIAL_INSERTION_SORT(PFX,    \
+                                                               BASE,   \
+                                                               NMEMB,  \
+                                                               ELEMSZ, \
+                                                               LT,     \
+                                                               MOVE_LIMIT, \
+                                                               RESULT) \
+  do                                                                    \
+    {                                                                   \
+      char *PFX##partial__arr = (void *) (BASE);                        \
+      size_t PFX##partial__nmemb = (size_t) (NMEMB);                    \
+      size_t PFX##partial__elemsz = (size_t) (ELEMSZ);                  \
+                                                                        \
+      (RESULT) = true;                                                  \
+      if (PFX##partial__nmemb > 1)                                      \
+        {                                                               \
+          size_t PFX##partial__pfx_len;                                 \
+          QUICKSORTS__UNSTABLE_QUICKSORT__MAKE_AN_ORDERED_PREFIX        \
+            (PFX##partial__, LT);                                       \
+          size_t PFX##partial__moves = 0;                               \
+          size_t PFX##partial__i = PFX##partial__pfx_len;               \
+          while (PFX##partial__i != PFX##partial__nmemb)                \
+            {                                                           \
+              char *PFX##partial__pi =                                  \
+                PFX##partial__arr + (PFX##partial__elemsz               \
+                                     * PFX##partial__i);                \
+              if (LT ((const void *) PFX##partial__pi,                  \
+                      (const void *) (PFX##partial__pi                  \
+                                      - PFX##partial__elemsz)))         \
+                {                                                       \
+                  char *PFX##partial__pos;                              \
+                  QUICKSORTS_COMMON__INSERTION_POSITION                 \
+                    (PFX##partial__, LT);                               \
+                  PFX##partial__moves +=                                \
+                    ((size_t) (PFX##partial__pi - PFX##partial__pos)    \
+                     / PFX##partial__elemsz);                           \
+                  quicksorts_common__subcirculate_right                 \
+                    (PFX##partial__pos, PFX##partial__pi,               \
+                     PFX##partial__elemsz);                             \
+                }                                                       \
+              PFX##partial__i += 1;                                     \
+              if ((MOVE_LIMIT) < PFX##partial__moves                    \
+                  && PFX##partial__i != PFX##partial__nmemb)            \
+                {                                                       \
+                  (RESULT) = false;                                     \
+                  break;                                                \
+                }                                                       \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__UNSTABLE_QUICKSORT__PARTIAL_INSERTION_SORT__TYPED(PFX, \
+                                                                      T, \
+                                                                      BASE, \
+                                                                      NMEMB, \
+                                                                      LT, \
+                                                                      MOVE_LIMIT, \
+                                                                      RESULT) \
+  do                                                                    \
+    {                                                                   \
+      T *PFX##partial__arr = (T *) (BASE);                              \
+      size_t PFX##partial__nmemb = (size_t) (NMEMB);                    \
+                                                                        \
+      (RESULT) = true;                                                  \
+      if (PFX##partial__nmemb > 1)                                      \
+        {                                                               \
+          size_t PFX##partial__pfx_len;                                 \
+          QUICKSORTS__UNSTABLE_QUICKSORT__MAKE_AN_ORDERED_PREFIX__TYPED \
+            (PFX##partial__, T, LT);                                    \
+          size_t PFX##partial__moves = 0;                               \
+          size_t PFX##partial__i = PFX##partial__pfx_len;               \
+          while (PFX##partial__i != PFX##partial__nmemb)                \
+            {                                                           \
+              T *PFX##partial__pi = PFX##partial__arr + PFX##partial__i; \
+              if (LT (PFX##partial__pi, PFX##partial__pi - 1))          \
+                {                                                       \
+                  T *PFX##partial__pos;                                 \
+                  QUICKSORTS_COMMON__INSERTION_POSITION__TYPED          \
+                    (PFX##partial__, T, LT);                            \
+                  PFX##partial__moves +=                                \
+                    (size_t) (PFX##partial__pi - PFX##partial__pos);    \
+                  QUICKSORTS_COMMON__SUBCIRCULATE_RIGHT__TYPED          \
+                    (PFX##partial__, T, PFX##partial__pos,              \
+                     PFX##partial__pi);                                 \
+                }                                                       \
+              PFX##partial__i += 1;                                     \
+              if ((MOVE_LIMIT) < PFX##partial__moves                    \
+                  && PFX##partial__i != PFX##partial__nmemb)            \
+                {                                                       \
+                  (RESULT) = false;                                     \
+                  break;                                                \
+                }                                                       \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+/* Swap a few elements of a subarray into new positions, to break up
+   whatever pattern produced a bad partition. Subarrays of fewer than
+   eight elements are left alone. */
+#define QUICKSORTS__UNSTABLE_QUICKSORT__BREAK_PATTERNS(PFX, P, N)       \
+  do                                                                    \
+    {                                                                   \
+      char *PFX##break__p = (P);                                        \
+      const size_t PFX##break__n = (N);                                 \
+      if (8 <= PFX##break__n)                                           \
+        {                                                               \
+          const size_t PFX##break__q = PFX##break__n >> 2;              \
+          char *PFX##break__p_end =                                     \
+            PFX##break__p + (PFX##elemsz * PFX##break__n);              \
+          char *PFX##break__p_q =                                       \
+            PFX##break__p + (PFX##elemsz * PFX##break__q);              \
+          char *PFX##break__p_endq =                                    \
+            PFX##break__p_end - (PFX##elemsz * PFX##break__q);          \
+          quicksorts_common__elem_swap                                  \
+            (PFX##break__p, PFX##break__p_q, PFX##elemsz);              \
+          quicksorts_common__elem_swap                                  \
+            (PFX##break__p_end - PFX##elemsz, PFX##break__p_endq,       \
+             PFX##elemsz);                                              \
+          if (128 < PFX##break__n)                                      \
+            for (size_t PFX##break__k = 1; PFX##break__k != 3;          \
+                 PFX##break__k += 1)                                    \
+              {                                                         \
+                const size_t PFX##break__off =                          \
+                  PFX##elemsz * PFX##break__k;                          \
+                quicksorts_common__elem_swap                            \
+                  (PFX##break__p + PFX##break__off,                     \
+                   PFX##break__p_q + PFX##break__off, PFX##elemsz);     \
+                quicksorts_common__elem_swap                            \
+                  (PFX##break__p_end - PFX##elemsz - PFX##break__off,   \
+                   PFX##break__p_endq - PFX##break__off, PFX##elemsz);  \
+              }                                                         \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__UNSTABLE_QUICKSORT__BREAK_PATTERNS__TYPED(PFX, T,   \
+                                                              P, N)     \
+  do                                                                    \
+    {                                                                   \
+      T *PFX##break__p = (P);                                           \
+      const size_t PFX##break__n = (N);                                 \
+      if (8 <= PFX##break__n)                                           \
+        {                                                               \
+          const size_t PFX##break__q = PFX##break__n >> 2;              \
+          T *PFX##break__p_end = PFX##break__p + PFX##break__n;         \
+          T *PFX##break__p_q = PFX##break__p + PFX##break__q;           \
+          T *PFX##break__p_endq = PFX##break__p_end - PFX##break__q;    \
+          QUICKSORTS_COMMON__ELEM_SWAP__TYPED                           \
+            (PFX##break__, T, PFX##break__p, PFX##break__p_q);          \
+          QUICKSORTS_COMMON__ELEM_SWAP__TYPED                           \
+            (PFX##break__, T, PFX##break__p_end - 1,                    \
+             PFX##break__p_endq);                                       \
+          if (128 < PFX##break__n)                                      \
+            for (size_t PFX##break__k = 1; PFX##break__k != 3;          \
+                 PFX##break__k += 1)                                    \
+              {                                                         \
+                QUICKSORTS_COMMON__ELEM_SWAP__TYPED                     \
+                  (PFX##break__, T, PFX##break__p + PFX##break__k,      \
+                   PFX##break__p_q + PFX##break__k);                    \
+                QUICKSORTS_COMMON__ELEM_SWAP__TYPED                     \
+                  (PFX##break__, T,                                     \
+                   PFX##break__p_end - 1 - PFX##break__k,               \
+                   PFX##break__p_endq - PFX##break__k);                 \
+              }                                                         \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+/*
+  A pattern-defeating quicksort, after Orson Peters, "Pattern-defeating
+  Quicksort", https://arxiv.org/abs/2106.05123
+
+  The depth budget here counts bad partitions only: those that leave
+  fewer than an eighth of the subarray on one side. Each bad partition
+  spends one unit and scrambles a few elements of both sides. When a
+  balanced partition swaps nothing, the subarray is probably in order
+  already, and each side is given a partial insertion sort before it
+  is partitioned further. Sorted, reverse-sorted and similar inputs
+  are then sorted in about linear time.
+*/
+#define QUICKSORTS__UNSTABLE_QUICKSORT__PDQSORT(PFX, BASE, NMEMB,       \
+                                                ELEMSZ, LT,             \
+                                                PIVOT_SELECTION,        \
+                                                SMALL_SIZE,             \
+                                                SMALL_SORT,             \
+                                                PARTITION)              \
+  do                                                                    \
+    {                                                                   \
+      char *PFX##arr = (void *) (BASE);                                 \
+      size_t PFX##nmemb = (size_t) (NMEMB);                             \
+      size_t PFX##elemsz = (size_t) (ELEMSZ);                           \
+                                                                        \
+      if (0 < PFX##elemsz && 2 <= PFX##nmemb                            \
+          && PFX##nmemb <= (SMALL_SIZE))                                \
+        {                                                               \
+          /* A tiny array needs no partitioning, and so no stack. */    \
+          SMALL_SORT (PFX, PFX##arr, PFX##nmemb, PFX##elemsz, LT,       \
+                      (SMALL_SIZE));                                    \
+        }                                                               \
+      else if (0 < PFX##elemsz && 2 <= PFX##nmemb)                      \
+        {                                                               \
+          size_t PFX##i_pivot;                                          \
+          size_t PFX##n_pivot;                                          \
+          bool PFX##swapped;                                            \
+          char *PFX##p_pivot;                                           \
+          char *PFX##hole__tmp = NULL;                                  \
+          int PFX##depth;                                               \
+          bool PFX##sorted;                                             \
+                                                                        \
+          QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_RUNS                    \
+            (PFX, LT, PFX##sorted);                                     \
+          QUICKSORTS_COMMON__STK_MAKE (PFX);                            \
+          if (!PFX##sorted)                                             \
+            QUICKSORTS_COMMON__STK_PUSH                                 \
+              (PFX, PFX##arr, PFX##nmemb,                               \
+               quicksorts_common__depth_limit (PFX##nmemb) >> 1);       \
+          while (PFX##stk_depth != 0)                                   \
+            {                                                           \
+              QUICKSORTS_COMMON__STK_POP (PFX);                         \
+              if (PFX##nmemb <= (SMALL_SIZE))                           \
+                {                                                       \
+                  SMALL_SORT (PFX, PFX##arr, PFX##nmemb, PFX##elemsz,   \
+                              LT, (SMALL_SIZE));                        \
+                }                                                       \
+              else if (PFX##depth == 0)                                 \
+                {                                                       \
+                  QUICKSORTS__UNSTABLE_QUICKSORT__HEAP_SORT             \
+                    (PFX, PFX##arr, PFX##nmemb, PFX##elemsz, LT,        \
+                     (SMALL_SIZE));                                     \
+                }                                                       \
+              else                                                      \
+                {                                                       \
+                  PARTITION (PFX, LT, PIVOT_SELECTION);                 \
+                                                                        \
+                  size_t PFX##n_le = PFX##i_pivot;                      \
+                  size_t PFX##n_ge =                                    \
+                    PFX##nmemb - PFX##n_pivot - PFX##i_pivot;           \
+                  char *PFX##p_ge =                                     \
+                    PFX##p_pivot + (PFX##n_pivot * PFX##elemsz);        \
+                  bool PFX##le_done = (PFX##n_le == 0);                 \
+                  bool PFX##ge_done = (PFX##n_ge == 0);                 \
+                                                                        \
+                  if (PFX##n_le < (PFX##nmemb >> 3)                     \
+                      || PFX##n_ge < (PFX##nmemb >> 3))                 \
+                    {                                                   \
+                      PFX##depth -= 1;                                  \
+                      if ((SMALL_SIZE) < PFX##n_le)                     \
+                        QUICKSORTS__UNSTABLE_QUICKSORT__BREAK_PATTERNS  \
+                          (PFX, PFX##arr, PFX##n_le);                   \
+                      if ((SMALL_SIZE) < PFX##n_ge)                     \
+                        QUICKSORTS__UNSTABLE_QUICKSORT__BREAK_PATTERNS  \
+                          (PFX, PFX##p_ge, PFX##n_ge);                  \
+                    }                                                   \
+                  else if (!PFX##swapped)                               \
+                    {                                                   \
+                      QUICKSORTS__UNSTABLE_QUICKSORT__PARTIAL_INSERTION_SORT \
+                        (PFX, PFX##arr, PFX##n_le, PFX##elemsz, LT,     \
+                         QUICKSORTS__UNSTABLE_QUICKSORT__PARTIAL_INSERTION_LIMIT, \
+                         PFX##le_done);                                 \
+                      QUICKSORTS__UNSTABLE_QUICKSORT__PARTIAL_INSERTION_SORT \
+                        (PFX, PFX##p_ge, PFX##n_ge, PFX##elemsz, LT,    \
+                         QUICKSORTS__UNSTABLE_QUICKSORT__PARTIAL_INSERTION_LIMIT, \
+                         PFX##ge_done);                                 \
+                    }                                                   \
+                                                                        \
+                  /* Push the larger part of the partition first. */    \
+                  /* Otherwise the stack may overflow.            */    \
+                                                                        \
+                  if (PFX##n_le < PFX##n_ge)                            \
+                    {                                                   \
+                      if (!PFX##ge_done)                                \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX, PFX##p_ge, PFX##n_ge, PFX##depth);      \
+                      if (!PFX##le_done)                                \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX, PFX##arr, PFX##n_le, PFX##depth);       \
+                    }                                                   \
+                  else                                                  \
+                    {                                                   \
+                      if (!PFX##le_done)                                \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX, PFX##arr, PFX##n_le, PFX##depth);       \
+                      if (!PFX##ge_done)                                \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX, PFX##p_ge, PFX##n_ge, PFX##depth);      \
+                    }                                                   \
+                }                                                       \
+            }                                                           \
+          if (PFX##hole__tmp != NULL)                                   \
+            QUICKSORTS_COMMON__FREE (PFX##hole__tmp);                   \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__UNSTABLE_QUICKSORT__PDQSORT__TYPED(PFX, T, BASE,    \
+                                                       NMEMB, LT,       \
+                                                       PIVOT_SELECTION, \
+                                                       SMALL_SIZE,      \
+                                                       SMALL_SORT,      \
+                                                       PARTITION)       \
+  do                                                                    \
+    {                                                                   \
+      T *PFX##arr = (T *) (BASE);                                       \
+      size_t PFX##nmemb = (size_t) (NMEMB);                             \
+                                                                        \
+      if (0 < sizeof (T) && 2 <= PFX##nmemb                             \
+          && PFX##nmemb <= (SMALL_SIZE))                                \
+        {                                                               \
+          /* A tiny array needs no partitioning, and so no stack. */    \
+          SMALL_SORT (PFX, T, PFX##arr, PFX##nmemb, LT, (SMALL_SIZE));  \
+        }                                                               \
+      else if (0 < sizeof (T) && 2 <= PFX##nmemb)                       \
+        {                                                               \
+          size_t PFX##i_pivot;                                          \
+          size_t PFX##n_pivot;                                          \
+          bool PFX##swapped;                                            \
+          T *PFX##p_pivot;                                              \
+          int PFX##depth;                                               \
+          bool PFX##sorted;                                             \
+                                                                        \
+          QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_RUNS__TYPED             \
+            (PFX, T, LT, PFX##sorted);                                  \
+          QUICKSORTS_COMMON__STK_MAKE (PFX);                            \
+          if (!PFX##sorted)                                             \
+            QUICKSORTS_COMMON__STK_PUSH                                 \
+              (PFX, PFX##arr, PFX##nmemb,                               \
+               quicksorts_common__depth_limit (PFX##nmemb) >> 1);       \
+          while (PFX##stk_depth != 0)                                   \
+            {                                                           \
+              QUICKSORTS_COMMON__STK_POP (PFX);                         \
+              if (PFX##nmemb <= (SMALL_SIZE))                           \
+                {                                                       \
+                  SMALL_SORT (PFX, T, PFX##arr, PFX##nmemb, LT,         \
+                              (SMALL_SIZE));                            \
+                }                                                       \
+              else if (PFX##depth == 0)                                 \
+                {                                                       \
+                  QUICKSORTS__UNSTABLE_QUICKSORT__HEAP_SORT__TYPED      \
+                    (PFX, T, PFX##arr, PFX##nmemb, LT, (SMALL_SIZE));   \
+                }                                                       \
+              else                                                      \
+                {                                                       \
+                  PARTITION (PFX, T, LT, PIVOT_SELECTION);              \
+                                                                        \
+                  size_t PFX##n_le = PFX##i_pivot;                      \
+                  size_t PFX##n_ge =                                    \
+                    PFX##nmemb - PFX##n_pivot - PFX##i_pivot;           \
+                  T *PFX##p_ge = PFX##p_pivot + PFX##n_pivot;           \
+                  bool PFX##le_done = (PFX##n_le == 0);                 \
+                  bool PFX##ge_done = (PFX##n_ge == 0);                 \
+                                                                        \
+                  if (PFX##n_le < (PFX##nmemb >> 3)                     \
+                      || PFX##n_ge < (PFX##nmemb >> 3))                 \
+                    {                                                   \
+                      PFX##depth -= 1;                                  \
+                      if ((SMALL_SIZE) < PFX##n_le)                     \
+                        QUICKSORTS__UNSTABLE_QUICKSORT__BREAK_PATTERNS__TYPED \
+                          (PFX, T, PFX##arr, PFX##n_le);                \
+                      if ((SMALL_SIZE) < PFX##n_ge)                     \
+                        QUICKSORTS__UNSTABLE_QUICKSORT__BREAK_PATTERNS__TYPED \
+                          (PFX, T, PFX##p_ge, PFX##n_ge);               \
+                    }                                                   \
+                  else if (!PFX##swapped)                               \
+                    {                                                   \
+                      QUICKSORTS__UNSTABLE_QUICKSORT__PARTIAL_INSERTION_SORT__TYPED \
+                        (PFX, T, PFX##arr, PFX##n_le, LT,               \
+                         QUICKSORTS__UNSTABLE_QUICKSORT__PARTIAL_INSERTION_LIMIT, \
+                         PFX##le_done);                                 \
+                      QUICKSORTS__UNSTABLE_QUICKSORT__PARTIAL_INSERTION_SORT__TYPED \
+                        (PFX, T, PFX##p_ge, PFX##n_ge, LT,              \
+                         QUICKSORTS__UNSTABLE_QUICKSORT__PARTIAL_INSERTION_LIMIT, \
+                         PFX##ge_done);                                 \
+                    }                                                   \
+                                                                        \
+                  /* Push the larger part of the partition first. */    \
+                  /* Otherwise the stack may overflow.            */    \
+                                                                        \
+                  if (PFX##n_le < PFX##n_ge)                            \
+                    {                                                   \
+                      if (!PFX##ge_done)                                \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX, PFX##p_ge, PFX##n_ge, PFX##depth);      \
+                      if (!PFX##le_done)                                \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX, PFX##arr, PFX##n_le, PFX##depth);       \
+                    }                                                   \
+                  else                                                  \
+                    {                                                   \
+                      if (!PFX##le_done)                                \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX, PFX##arr, PFX##n_le, PFX##depth);       \
+                      if (!PFX##ge_done)                                \
+                        QUICKSORTS_COMMON__STK_PUSH                     \
+                          (PFX, PFX##p_ge, PFX##n_ge, PFX##depth);      \
+                    }                                                   \
+                }                                                       \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define UNSTABLE_QUICKSORT_8ARGS(BASE, NMEMB, ELEMSZ, LT,           \
+                                 PIVOT_SELECTION, SMALL_SIZE,       \
+                                 SMALL_SORT, PARTITION)             \
+  do                                                                \
+    {                                                               \
+      QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT                     \
+        (quicksorts__unstable_quicksort__,                          \
+         (BASE), (NMEMB), (ELEMSZ),                                 \
+         LT, PIVOT_SELECTION, (SMALL_SIZE), SMALL_SORT,             \
+         PARTITION);                                                \
+    }                                                               \
+  while (0)
+
+#define UNSTABLE_QUICKSORT_TYPED_8ARGS(T, BASE, NMEMB, LT,      \
+                                       PIVOT_SELECTION,         \
+                                       SMALL_SIZE, SMALL_SORT,  \
+                                       PARTITION)               \
+  do                                                            \
+    {                                                           \
+      QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT__TYPED          \
+        (quicksorts__unstable_quicksort__typed__, T,            \
+         (BASE), (NMEMB), LT, PIVOT_SELECTION,                  \
+         (SMALL_SIZE), SMALL_SORT, PARTITION);                  \
+    }                                                           \
+  while (0)
+
+/* The defaults come from <quicksorts/tuned-config.h>, which ‘make
+   tune’ fits to the build host. */
+
+#ifndef UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION
+#define UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION    \
+  QUICKSORTS_TUNED__PIVOT_SELECTION
+#endif
+
+#ifndef UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE
+#define UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE \
+  QUICKSORTS_TUNED__SMALL_SIZE
+#endif
+
+#ifndef UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT
+#define UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT \
+  QUICKSORTS_TUNED__SMALL_SORT
+#endif
+
+#ifndef UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT__TYPED
+#define UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT__TYPED  \
+  QUICKSORTS_TUNED__SMALL_SORT__TYPED
+#endif
+
+/* Define these before including this header, to have the 7ARGS and
+   4ARGS macros use, for instance, three-way partitioning. */
+#ifndef UNSTABLE_QUICKSORT__DEFAULT__PARTITION
+#define UNSTABLE_QUICKSORT__DEFAULT__PARTITION  \
+  QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION
+#endif
+
+#ifndef UNSTABLE_QUICKSORT__DEFAULT__PARTITION__TYPED
+#define UNSTABLE_QUICKSORT__DEFAULT__PARTITION__TYPED   \
+  QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION__TYPED
+#endif
+
+#define UNSTABLE_QUICKSORT_7ARGS(BASE, NMEMB, ELEMSZ, LT,           \
+                                 PIVOT_SELECTION,                   \
+                                 SMALL_SIZE, SMALL_SORT)            \
+  do                                                                \
+    {                                                               \
+      QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT                     \
+        (quicksorts__unstable_quicksort__,                          \
+         (BASE), (NMEMB), (ELEMSZ),                                 \
+         LT, PIVOT_SELECTION, (SMALL_SIZE), SMALL_SORT,             \
+         UNSTABLE_QUICKSORT__DEFAULT__PARTITION);                   \
+    }                                                               \
+  while (0)
+
+#define UNSTABLE_QUICKSORT_TYPED_7ARGS(T, BASE, NMEMB, LT,      \
+                                       PIVOT_SELECTION,         \
+                                       SMALL_SIZE, SMALL_SORT)  \
+  do                                                            \
+    {                                                           \
+      QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT__TYPED          \
+        (quicksorts__unstable_quicksort__typed__, T,            \
+         (BASE), (NMEMB), LT, PIVOT_SELECTION,                  \
+         (SMALL_SIZE), SMALL_SORT,                              \
+         UNSTABLE_QUICKSORT__DEFAULT__PARTITION__TYPED);        \
+    }                                                           \
+  while (0)
+
+#define UNSTABLE_QUICKSORT_4ARGS(BASE, NMEMB, ELEMSZ, LT)   \
+  do                                                        \
+    {                                                       \
+      QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT             \
+        (quicksorts__unstable_quicksort__,                  \
+         (BASE), (NMEMB), (ELEMSZ), LT,                     \
+         UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION,      \
+         (UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE),         \
+         UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT,           \
+         UNSTABLE_QUICKSORT__DEFAULT__PARTITION);           \
+    }                                                       \
+  while (0)
+
+#define UNSTABLE_QUICKSORT_TYPED_4ARGS(T, BASE, NMEMB, LT)  \
+  do                                                        \
+    {                                                       \
+      QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT__TYPED      \
+        (quicksorts__unstable_quicksort__typed__,           \
+         T, (BASE), (NMEMB), LT,                            \
+         UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION,      \
+         (UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE),         \
+         UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT__TYPED,    \
+         UNSTABLE_QUICKSORT__DEFAULT__PARTITION__TYPED);    \
+    }                                                       \
+  while (0)
+
+#define UNSTABLE_QUICKSORT UNSTABLE_QUICKSORT_4ARGS
+#define UNSTABLE_QUICKSORT_TYPED UNSTABLE_QUICKSORT_TYPED_4ARGS
+
+#define UNSTABLE_PDQSORT_8ARGS(BASE, NMEMB, ELEMSZ, LT,             \
+                               PIVOT_SELECTION, SMALL_SIZE,         \
+                               SMALL_SORT, PARTITION)               \
+  do                                                                \
+    {                                                               \
+      QUICKSORTS__UNSTABLE_QUICKSORT__PDQSORT                       \
+        (quicksorts__unstable_pdqsort__,                            \
+         (BASE), (NMEMB), (ELEMSZ),                                 \
+         LT, PIVOT_SELECTION, (SMALL_SIZE), SMALL_SORT,             \
+         PARTITION);                                                \
+    }                                                               \
+  while (0)
+
+#define UNSTABLE_PDQSORT_TYPED_8ARGS(T, BASE, NMEMB, LT,        \
+                                     PIVOT_SELECTION,           \
+                                     SMALL_SIZE, SMALL_SORT,    \
+                                     PARTITION)                 \
+  do                                                            \
+    {                                                           \
+      QUICKSORTS__UNSTABLE_QUICKSORT__PDQSORT__TYPED            \
+        (quicksorts__unstable_pdqsort__typed__, T,              \
+         (BASE), (NMEMB), LT, PIVOT_SELECTION,                  \
+         (SMALL_SIZE), SMALL_SORT, PARTITION);                  \
+    }                                                           \
+  while (0)
+
+#define UNSTABLE_PDQSORT_4ARGS(BASE, NMEMB, ELEMSZ, LT)     \
+  do                                                        \
+    {                                                       \
+      QUICKSORTS__UNSTABLE_QUICKSORT__PDQSORT               \
+        (quicksorts__unstable_pdqsort__,                    \
+         (BASE), (NMEMB), (ELEMSZ), LT,                     \
+         UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION,      \
+         (UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE),         \
+         UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT,           \
+         UNSTABLE_QUICKSORT__DEFAULT__PARTITION);           \
+    }                                                       \
+  while (0)
+
+#define UNSTABLE_PDQSORT_TYPED_4ARGS(T, BASE, NMEMB, LT)    \
+  do                                                        \
+    {                                                       \
+      QUICKSORTS__UNSTABLE_QUICKSORT__PDQSORT__TYPED        \
+        (quicksorts__unstable_pdqsort__typed__,             \
+         T, (BASE), (NMEMB), LT,                            \
+         UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION,      \
+         (UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE),         \
+         UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT__TYPED,    \
+         UNSTABLE_QUICKSORT__DEFAULT__PARTITION__TYPED);    \
+    }                                                       \
+  while (0)
+
+#define UNSTABLE_PDQSORT UNSTABLE_PDQSORT_4ARGS
+#define UNSTABLE_PDQSORT_TYPED UNSTABLE_PDQSORT_TYPED_4ARGS
 
 #endif /* QUICKSORTS__UNSTABLE_QUICKSORT_H__HEADER_GUARD__ */
@@ -0,0 +1,259 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef QUICKSORTS__UNSTABLE_RADIX_SORT_H__HEADER_GUARD__
+#define QUICKSORTS__UNSTABLE_RADIX_SORT_H__HEADER_GUARD__
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include <quicksorts/unstable-quicksort.h>
+
+/*
+  An in-place most-significant-digit radix sort (‘American flag
+  sort’, after McIlroy, Bostic and McIlroy), one byte of the key at a
+  time.
+
+  KEY (p) must give, for a pointer p to an element, an unsigned
+  integer of at most 64 bits, whose order is the order wanted. LT
+  must order the elements exactly as KEY does: buckets smaller than
+  BUCKET_SIZE are finished with the quicksort, and buckets of equal
+  keys are left as they are. The functions below map signed and
+  floating-point values to suitable unsigned keys.
+
+  The storage required is two 256-entry tables, plus a stack of
+  at most one entry for each byte of the key.
+*/
+
+#ifndef QUICKSORTS__UNSTABLE_RADIX_SORT__BUCKET_SIZE
+#define QUICKSORTS__UNSTABLE_RADIX_SORT__BUCKET_SIZE 64
+#endif
+
+quicksorts_common__inline uint32_t
+unstable_radix_sort_int32_key (int32_t x)
+{
+  return ((uint32_t) x) ^ UINT32_C (0x80000000);
+}
+
+quicksorts_common__inline uint64_t
+unstable_radix_sort_int64_key (int64_t x)
+{
+  return ((uint64_t) x) ^ UINT64_C (0x8000000000000000);
+}
+
+/* Negative numbers have all their bits flipped, so that larger
+   magnitudes come first; other numbers have their sign bit set.
+   Negative zero gets a smaller key than positive zero, and NaNs go to
+   the ends. */
+quicksorts_common__inline uint32_t
+unstable_radix_sort_float_key (float x)
+{
+  uint32_t u;
+  QUICKSORTS_COMMON__MEMCPY (&u, &x, sizeof u);
+  return (u & UINT32_C (0x80000000)) ? ~u : (u | UINT32_C (0x80000000));
+}
+
+quicksorts_common__inline uint64_t
+unstable_radix_sort_double_key (double x)
+{
+  uint64_t u;
+  QUICKSORTS_COMMON__MEMCPY (&u, &x, sizeof u);
+  return ((u & UINT64_C (0x8000000000000000)) ?
+          ~u : (u | UINT64_C (0x8000000000000000)));
+}
+
+#define QUICKSORTS__UNSTABLE_RADIX_SORT__DIGIT(KEY, P, SHIFT)   \
+  ((size_t) ((((uint64_t) KEY (P)) >> (SHIFT)) & 0xFF))
+
+#define QUICKSORTS__UNSTABLE_RADIX_SORT__RADIX_SORT__TYPED(PFX, T,      \
+                                                           BASE,        \
+                                                           NMEMB,       \
+                                                           KEY, LT,     \
+                                                           BUCKET_SIZE) \
+  do                                                                    \
+    {                                                                   \
+      T *PFX##lo = (T *) (BASE);                                        \
+      size_t PFX##n = (size_t) (NMEMB);                                 \
+      int PFX##shift = 8 * ((int) sizeof (KEY (PFX##lo)) - 1);          \
+                                                                        \
+      /* Skip the high bytes that are the same in every key. */         \
+      if ((BUCKET_SIZE) < PFX##n)                                       \
+        {                                                               \
+          const uint64_t PFX##k0 = (uint64_t) KEY (PFX##lo);            \
+          uint64_t PFX##diff = 0;                                       \
+          for (size_t PFX##i = 1; PFX##i != PFX##n; PFX##i += 1)        \
+            PFX##diff |= ((uint64_t) KEY (PFX##lo + PFX##i)) ^ PFX##k0; \
+          if (PFX##diff == 0)                                           \
+            PFX##n = 0;     /* Every key is the same. */                \
+          while (PFX##shift != 0                                        \
+                 && ((PFX##diff >> PFX##shift) & 0xFF) == 0)            \
+            PFX##shift -= 8;                                            \
+        }                                                               \
+                                                                        \
+      /* Each stack entry is a region distributed on the byte at */     \
+      /* its shift, less the buckets already finished.            */    \
+      struct                                                            \
+      {                                                                 \
+        T *lo;                                                          \
+        T *hi;                                                          \
+        int shift;                                                      \
+      } PFX##stk[sizeof (KEY (PFX##lo))];                               \
+      size_t PFX##stk_depth = 0;                                        \
+      size_t PFX##end[256];                                             \
+      size_t PFX##next[256];                                            \
+                                                                        \
+      bool PFX##more = true;                                            \
+      while (PFX##more)                                                 \
+        {                                                               \
+          if (PFX##n <= (BUCKET_SIZE))                                  \
+            {                                                           \
+              QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT__TYPED          \
+                (PFX##bucket__, T, PFX##lo, PFX##n, LT,                 \
+                 UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION,          \
+                 (UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE),             \
+                 UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT__TYPED,        \
+                 UNSTABLE_QUICKSORT__DEFAULT__PARTITION__TYPED);        \
+            }                                                           \
+          else                                                          \
+            {                                                           \
+              QUICKSORTS_COMMON__MEMSET (PFX##end, 0, sizeof PFX##end); \
+              for (size_t PFX##i = 0; PFX##i != PFX##n; PFX##i += 1)    \
+                PFX##end[QUICKSORTS__UNSTABLE_RADIX_SORT__DIGIT         \
+                         (KEY, PFX##lo + PFX##i, PFX##shift)] += 1;     \
+                                                                        \
+              const size_t PFX##d0 =                                    \
+                QUICKSORTS__UNSTABLE_RADIX_SORT__DIGIT                  \
+                (KEY, PFX##lo, PFX##shift);                             \
+              if (PFX##end[PFX##d0] == PFX##n)                          \
+                {                                                       \
+                  /* Everything is in one bucket. Go on to the next */  \
+                  /* byte, unless there is none.                     */ \
+                  if (PFX##shift != 0)                                  \
+                    {                                                   \
+                      PFX##shift -= 8;                                  \
+                      continue;                                         \
+                    }                                                   \
+                }                                                       \
+              else                                                      \
+                {                                                       \
+                  size_t PFX##sum = 0;                                  \
+                  for (size_t PFX##b = 0; PFX##b != 256; PFX##b += 1)   \
+                    {                                                   \
+                      PFX##next[PFX##b] = PFX##sum;                     \
+                      PFX##sum += PFX##end[PFX##b];                     \
+                      PFX##end[PFX##b] = PFX##sum;                      \
+                    }                                                   \
+                                                                        \
+                  /* Move each element into its bucket, following */   \
+                  /* the cycles of the permutation. The last bucket */  \
+                  /* is filled by the time the others are.          */  \
+                  for (size_t PFX##b = 0; PFX##b != 255; PFX##b += 1)   \
+                    while (PFX##next[PFX##b] != PFX##end[PFX##b])       \
+                      {                                                 \
+                        T PFX##x = PFX##lo[PFX##next[PFX##b]];          \
+                        size_t PFX##d =                                 \
+                          QUICKSORTS__UNSTABLE_RADIX_SORT__DIGIT        \
+                          (KEY, &PFX##x, PFX##shift);                   \
+                        while (PFX##d != PFX##b)                        \
+                          {                                             \
+                            T *PFX##p = PFX##lo + PFX##next[PFX##d];    \
+                            T PFX##y = *PFX##p;                         \
+                            *PFX##p = PFX##x;                           \
+                            PFX##x = PFX##y;                            \
+                            PFX##next[PFX##d] += 1;                     \
+                            PFX##d =                                    \
+                              QUICKSORTS__UNSTABLE_RADIX_SORT__DIGIT    \
+                              (KEY, &PFX##x, PFX##shift);               \
+                          }                                             \
+                        PFX##lo[PFX##next[PFX##b]] = PFX##x;            \
+                        PFX##next[PFX##b] += 1;                         \
+                      }                                                 \
+                                                                        \
+                  PFX##stk[PFX##stk_depth].lo = PFX##lo;                \
+                  PFX##stk[PFX##stk_depth].hi = PFX##lo + PFX##n;       \
+                  PFX##stk[PFX##stk_depth].shift = PFX##shift;          \
+                  PFX##stk_depth += 1;                                  \
+                }                                                       \
+            }                                                           \
+                                                                        \
+          /* Find the next bucket that needs work. */                   \
+          PFX##more = false;                                            \
+          while (!PFX##more && PFX##stk_depth != 0)                     \
+            {                                                           \
+              T *PFX##first = PFX##stk[PFX##stk_depth - 1].lo;          \
+              T *PFX##last = PFX##stk[PFX##stk_depth - 1].hi;           \
+              const int PFX##s = PFX##stk[PFX##stk_depth - 1].shift;    \
+              if (PFX##first == PFX##last)                              \
+                PFX##stk_depth -= 1;                                    \
+              else                                                      \
+                {                                                       \
+                  /* The region is in order of the digit, so the */     \
+                  /* bucket’s end can be found by bisection.       */   \
+                  const size_t PFX##d =                                 \
+                    QUICKSORTS__UNSTABLE_RADIX_SORT__DIGIT              \
+                    (KEY, PFX##first, PFX##s);                          \
+                  T *PFX##a = PFX##first + 1;                           \
+                  T *PFX##z = PFX##last;                                \
+                  while (PFX##a != PFX##z)                              \
+                    {                                                   \
+                      T *PFX##mid = PFX##a + ((PFX##z - PFX##a) >> 1);  \
+                      if (QUICKSORTS__UNSTABLE_RADIX_SORT__DIGIT        \
+                          (KEY, PFX##mid, PFX##s) == PFX##d)            \
+                        PFX##a = PFX##mid + 1;                          \
+                      else                                              \
+                        PFX##z = PFX##mid;                              \
+                    }                                                   \
+                  PFX##stk[PFX##stk_depth - 1].lo = PFX##a;             \
+                                                                        \
+                  /* A bucket on the last byte holds equal keys. */     \
+                  if (PFX##s != 0 && 2 <= PFX##a - PFX##first)          \
+                    {                                                   \
+                      PFX##lo = PFX##first;                             \
+                      PFX##n = (size_t) (PFX##a - PFX##first);          \
+                      PFX##shift = PFX##s - 8;                          \
+                      PFX##more = true;                                 \
+                    }                                                   \
+                }                                                       \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define UNSTABLE_RADIX_SORT_TYPED_6ARGS(T, BASE, NMEMB, KEY, LT,    \
+                                        BUCKET_SIZE)                \
+  do                                                                \
+    {                                                               \
+      QUICKSORTS__UNSTABLE_RADIX_SORT__RADIX_SORT__TYPED            \
+        (quicksorts__unstable_radix_sort__typed__, T,               \
+         (BASE), (NMEMB), KEY, LT, (BUCKET_SIZE));                  \
+    }                                                               \
+  while (0)
+
+#define UNSTABLE_RADIX_SORT_TYPED_5ARGS(T, BASE, NMEMB, KEY, LT)    \
+  do                                                                \
+    {                                                               \
+      QUICKSORTS__UNSTABLE_RADIX_SORT__RADIX_SORT__TYPED            \
+        (quicksorts__unstable_radix_sort__typed__, T,               \
+         (BASE), (NMEMB), KEY, LT,                                  \
+         (QUICKSORTS__UNSTABLE_RADIX_SORT__BUCKET_SIZE));           \
+    }                                                               \
+  while (0)
+
+#define UNSTABLE_RADIX_SORT_TYPED UNSTABLE_RADIX_SORT_TYPED_5ARGS
+
+#endif /* QUICKSORTS__UNSTABLE_RADIX_SORT_H__HEADER_GUARD__ */
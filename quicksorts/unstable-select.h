@@ -0,0 +1,521 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef QUICKSORTS__UNSTABLE_SELECT_H__HEADER_GUARD__
+#define QUICKSORTS__UNSTABLE_SELECT_H__HEADER_GUARD__
+
+#include <stdlib.h>
+#include <quicksorts/unstable-quicksort.h>
+
+/*
+  Selection, after Hoare’s FIND, with the quicksort partitions.
+
+  NTH_ELEMENT puts at index K the element that would be there were
+  the array sorted, with no greater element before it and no lesser
+  element after it. Only the side of each partition that holds K is
+  partitioned further.
+
+  Each partition is charged the size of its subarray, against a
+  budget of WORK_FACTOR times the number of elements. Partitions that
+  shrink the subarray by some fraction each time, as they do on
+  average, stay well within the budget, whose worth of partitioning
+  is O(n). When it runs out, the m elements left are finished by
+  selection with a heap of min (K + 1, m - K) elements: a max-heap of
+  the least elements or a min-heap of the greatest. The worst case is
+  therefore O(n log min (k + 1, n - k)), which is O(n log n) for a
+  median.
+
+  PARTIAL_SORT sorts the K least elements into the first K places,
+  leaving the rest in no particular order. It costs an NTH_ELEMENT
+  and a sort of K elements.
+*/
+
+#ifndef QUICKSORTS__UNSTABLE_SELECT__WORK_FACTOR
+#define QUICKSORTS__UNSTABLE_SELECT__WORK_FACTOR 8
+#endif
+
+quicksorts_common__inline size_t
+quicksorts__unstable_select__work_limit (size_t nmemb)
+{
+  const size_t factor = (QUICKSORTS__UNSTABLE_SELECT__WORK_FACTOR);
+  return (nmemb <= SIZE_MAX / factor) ? (factor * nmemb) : SIZE_MAX;
+}
+
+/* Whether the element at P belongs above the element at Q in a
+   max-heap, if MAX_HEAP, or else in a min-heap. */
+#define QUICKSORTS__UNSTABLE_SELECT__ABOVE(LT, MAX_HEAP, P, Q)          \
+  ((MAX_HEAP) ? LT ((Q), (P)) : LT ((P), (Q)))
+
+/* Sift the element at index ROOT down the heap at HEAP, which has
+   END elements. */
+#define QUICKSORTS__UNSTABLE_SELECT__SIFT_DOWN(PFX, LT, MAX_HEAP,       \
+                                               HEAP, ROOT, END)         \
+  do                                                                    \
+    {                                                                   \
+      size_t PFX##root = (ROOT);                                        \
+      const size_t PFX##end = (END);                                    \
+      size_t PFX##child = (2 * PFX##root) + 1;                          \
+      while (PFX##child < PFX##end)                                     \
+        {                                                               \
+          char *PFX##p_child = (HEAP) + (PFX##elemsz * PFX##child);     \
+          if (PFX##child + 1 < PFX##end                                 \
+              && (QUICKSORTS__UNSTABLE_SELECT__ABOVE                    \
+                  (LT, MAX_HEAP,                                        \
+                   (const void *) (PFX##p_child + PFX##elemsz),         \
+                   (const void *) PFX##p_child)))                       \
+            {                                                           \
+              PFX##child += 1;                                          \
+              PFX##p_child += PFX##elemsz;                              \
+            }                                                           \
+          char *PFX##p_root = (HEAP) + (PFX##elemsz * PFX##root);       \
+          if (!(QUICKSORTS__UNSTABLE_SELECT__ABOVE                      \
+                (LT, MAX_HEAP, (const void *) PFX##p_child,             \
+                 (const void *) PFX##p_root)))                          \
+            break;                                                      \
+          quicksorts_common__elem_swap                                  \
+            (PFX##p_root, PFX##p_child, PFX##elemsz);                   \
+          PFX##root = PFX##child;                                       \
+          PFX##child = (2 * PFX##root) + 1;                             \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__UNSTABLE_SELECT__SIFT_DOWN__TYPED(PFX, T, LT,       \
+                                                      MAX_HEAP, HEAP,   \
+                                                      ROOT, END)        \
+  do                                                                    \
+    {                                                                   \
+      size_t PFX##root = (ROOT);                                        \
+      const size_t PFX##end = (END);                                    \
+      size_t PFX##child = (2 * PFX##root) + 1;                          \
+      while (PFX##child < PFX##end)                                     \
+        {                                                               \
+          if (PFX##child + 1 < PFX##end                                 \
+              && (QUICKSORTS__UNSTABLE_SELECT__ABOVE                    \
+                  (LT, MAX_HEAP, (HEAP) + PFX##child + 1,               \
+                   (HEAP) + PFX##child)))                               \
+            PFX##child += 1;                                            \
+          if (!(QUICKSORTS__UNSTABLE_SELECT__ABOVE                      \
+                (LT, MAX_HEAP, (HEAP) + PFX##child,                     \
+                 (HEAP) + PFX##root)))                                  \
+            break;                                                      \
+          QUICKSORTS_COMMON__ELEM_SWAP__TYPED                           \
+            (PFX, T, (HEAP) + PFX##root, (HEAP) + PFX##child);          \
+          PFX##root = PFX##child;                                       \
+          PFX##child = (2 * PFX##root) + 1;                             \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+/* Make a heap of the HEAP_SIZE elements at HEAP, then pass through
+   it each of the REST_SIZE elements at REST that belongs below its
+   top, so that the top ends up the HEAP_SIZE-th element in order from
+   that end. */
+#define QUICKSORTS__UNSTABLE_SELECT__HEAP_PASS(PFX, LT, MAX_HEAP,       \
+                                               HEAP, HEAP_SIZE, REST,   \
+                                               REST_SIZE)               \
+  do                                                                    \
+    {                                                                   \
+      char *PFX##heap = (HEAP);                                         \
+      const size_t PFX##heap_size = (HEAP_SIZE);                        \
+      char *PFX##rest = (REST);                                         \
+      const size_t PFX##rest_size = (REST_SIZE);                        \
+      for (size_t PFX##i = PFX##heap_size >> 1; PFX##i != 0;            \
+           PFX##i -= 1)                                                 \
+        QUICKSORTS__UNSTABLE_SELECT__SIFT_DOWN                          \
+          (PFX, LT, MAX_HEAP, PFX##heap, PFX##i - 1, PFX##heap_size);   \
+      for (size_t PFX##j = 0; PFX##j != PFX##rest_size; PFX##j += 1)    \
+        {                                                               \
+          char *PFX##p_j = PFX##rest + (PFX##elemsz * PFX##j);          \
+          if (QUICKSORTS__UNSTABLE_SELECT__ABOVE                        \
+              (LT, MAX_HEAP, (const void *) PFX##heap,                  \
+               (const void *) PFX##p_j))                                \
+            {                                                           \
+              quicksorts_common__elem_swap                              \
+                (PFX##heap, PFX##p_j, PFX##elemsz);                     \
+              QUICKSORTS__UNSTABLE_SELECT__SIFT_DOWN                    \
+                (PFX, LT, MAX_HEAP, PFX##heap, 0, PFX##heap_size);      \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__UNSTABLE_SELECT__HEAP_PASS__TYPED(PFX, T, LT,       \
+                                                      MAX_HEAP, HEAP,   \
+                                                      HEAP_SIZE, REST,  \
+                                                      REST_SIZE)        \
+  do                                                                    \
+    {                                                                   \
+      T *PFX##heap = (HEAP);                                            \
+      const size_t PFX##heap_size = (HEAP_SIZE);                        \
+      T *PFX##rest = (REST);                                            \
+      const size_t PFX##rest_size = (REST_SIZE);                        \
+      for (size_t PFX##i = PFX##heap_size >> 1; PFX##i != 0;            \
+           PFX##i -= 1)                                                 \
+        QUICKSORTS__UNSTABLE_SELECT__SIFT_DOWN__TYPED                   \
+          (PFX, T, LT, MAX_HEAP, PFX##heap, PFX##i - 1,                 \
+           PFX##heap_size);                                             \
+      for (size_t PFX##j = 0; PFX##j != PFX##rest_size; PFX##j += 1)    \
+        if (QUICKSORTS__UNSTABLE_SELECT__ABOVE                          \
+            (LT, MAX_HEAP, PFX##heap, PFX##rest + PFX##j))              \
+          {                                                             \
+            QUICKSORTS_COMMON__ELEM_SWAP__TYPED                         \
+              (PFX, T, PFX##heap, PFX##rest + PFX##j);                  \
+            QUICKSORTS__UNSTABLE_SELECT__SIFT_DOWN__TYPED               \
+              (PFX, T, LT, MAX_HEAP, PFX##heap, 0, PFX##heap_size);     \
+          }                                                             \
+    }                                                                   \
+  while (0)
+
+/* Select with a heap from whichever side of K is the shorter: a
+   max-heap of the first K + 1 elements, whose top is then moved to
+   K, or a min-heap of the elements from K on, whose top is at K
+   already. Needs K < PFX##nmemb. */
+#define QUICKSORTS__UNSTABLE_SELECT__HEAP_SELECT(PFX, LT, K)            \
+  do                                                                    \
+    {                                                                   \
+      const size_t PFX##k_sel = (K);                                    \
+      char *PFX##p_k = PFX##arr + (PFX##elemsz * PFX##k_sel);           \
+      if (PFX##k_sel < PFX##nmemb - PFX##k_sel)                         \
+        {                                                               \
+          QUICKSORTS__UNSTABLE_SELECT__HEAP_PASS                        \
+            (PFX, LT, true, PFX##arr, PFX##k_sel + 1,                   \
+             PFX##p_k + PFX##elemsz, PFX##nmemb - PFX##k_sel - 1);      \
+          if (PFX##k_sel != 0)                                          \
+            quicksorts_common__elem_swap                                \
+              (PFX##arr, PFX##p_k, PFX##elemsz);                        \
+        }                                                               \
+      else                                                              \
+        QUICKSORTS__UNSTABLE_SELECT__HEAP_PASS                          \
+          (PFX, LT, false, PFX##p_k, PFX##nmemb - PFX##k_sel,           \
+           PFX##arr, PFX##k_sel);                                       \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__UNSTABLE_SELECT__HEAP_SELECT__TYPED(PFX, T, LT, K)  \
+  do                                                                    \
+    {                                                                   \
+      const size_t PFX##k_sel = (K);                                    \
+      T *PFX##p_k = PFX##arr + PFX##k_sel;                              \
+      if (PFX##k_sel < PFX##nmemb - PFX##k_sel)                         \
+        {                                                               \
+          QUICKSORTS__UNSTABLE_SELECT__HEAP_PASS__TYPED                 \
+            (PFX, T, LT, true, PFX##arr, PFX##k_sel + 1,                \
+             PFX##p_k + 1, PFX##nmemb - PFX##k_sel - 1);                \
+          if (PFX##k_sel != 0)                                          \
+            QUICKSORTS_COMMON__ELEM_SWAP__TYPED                         \
+              (PFX, T, PFX##arr, PFX##p_k);                             \
+        }                                                               \
+      else                                                              \
+        QUICKSORTS__UNSTABLE_SELECT__HEAP_PASS__TYPED                   \
+          (PFX, T, LT, false, PFX##p_k, PFX##nmemb - PFX##k_sel,        \
+           PFX##arr, PFX##k_sel);                                       \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__UNSTABLE_SELECT__NTH_ELEMENT(PFX, BASE, NMEMB,      \
+                                                 ELEMSZ, K, LT,         \
+                                                 PIVOT_SELECTION,       \
+                                                 SMALL_SIZE,            \
+                                                 SMALL_SORT,            \
+                                                 PARTITION)             \
+  do                                                                    \
+    {                                                                   \
+      char *PFX##arr = (void *) (BASE);                                 \
+      size_t PFX##nmemb = (size_t) (NMEMB);                             \
+      size_t PFX##elemsz = (size_t) (ELEMSZ);                           \
+      size_t PFX##k = (size_t) (K);                                     \
+                                                                        \
+      if (0 < PFX##elemsz && PFX##k < PFX##nmemb)                       \
+        {                                                               \
+          size_t PFX##i_pivot;                                          \
+          size_t PFX##n_pivot;                                          \
+          bool PFX##swapped;                                            \
+          char *PFX##p_pivot;                                           \
+          char *PFX##hole__tmp = NULL;                                  \
+          size_t PFX##work =                                            \
+            quicksorts__unstable_select__work_limit (PFX##nmemb);       \
+          bool PFX##done = false;                                       \
+          while (!PFX##done)                                            \
+            {                                                           \
+              if (PFX##nmemb <= (SMALL_SIZE))                           \
+                {                                                       \
+                  SMALL_SORT (PFX, PFX##arr, PFX##nmemb, PFX##elemsz,   \
+                              LT, (SMALL_SIZE));                        \
+                  PFX##done = true;                                     \
+                }                                                       \
+              else if (PFX##work < PFX##nmemb)                          \
+                {                                                       \
+                  QUICKSORTS__UNSTABLE_SELECT__HEAP_SELECT              \
+                    (PFX, LT, PFX##k);                                  \
+                  PFX##done = true;                                     \
+                }                                                       \
+              else                                                      \
+                {                                                       \
+                  PFX##work -= PFX##nmemb;                              \
+                  PARTITION (PFX, LT, PIVOT_SELECTION);                 \
+                  (void) PFX##swapped;                                  \
+                  (void) PFX##p_pivot;                                  \
+                  const size_t PFX##i_ge = PFX##i_pivot + PFX##n_pivot; \
+                  if (PFX##k < PFX##i_pivot)                            \
+                    PFX##nmemb = PFX##i_pivot;                          \
+                  else if (PFX##k < PFX##i_ge)                          \
+                    PFX##done = true;                                   \
+                  else                                                  \
+                    {                                                   \
+                      PFX##arr += PFX##i_ge * PFX##elemsz;              \
+                      PFX##nmemb -= PFX##i_ge;                          \
+                      PFX##k -= PFX##i_ge;                              \
+                    }                                                   \
+                }                                                       \
+            }                                                           \
+          if (PFX##hole__tmp != NULL)                                   \
+            QUICKSORTS_COMMON__FREE (PFX##hole__tmp);                   \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__UNSTABLE_SELECT__NTH_ELEMENT__TYPED(PFX, T, BASE,   \
+                                                        NMEMB, K, LT,   \
+                                                        PIVOT_SELECTION, \
+                                                        SMALL_SIZE,     \
+                                                        SMALL_SORT,     \
+                                                        PARTITION)      \
+  do                                                                    \
+    {                                                                   \
+      T *PFX##arr = (T *) (BASE);                                       \
+      size_t PFX##nmemb = (size_t) (NMEMB);                             \
+      size_t PFX##k = (size_t) (K);                                     \
+                                                                        \
+      if (PFX##k < PFX##nmemb)                                          \
+        {                                                               \
+          size_t PFX##i_pivot;                                          \
+          size_t PFX##n_pivot;                                          \
+          bool PFX##swapped;                                            \
+          T *PFX##p_pivot;                                              \
+          size_t PFX##work =                                            \
+            quicksorts__unstable_select__work_limit (PFX##nmemb);       \
+          bool PFX##done = false;                                       \
+          while (!PFX##done)                                            \
+            {                                                           \
+              if (PFX##nmemb <= (SMALL_SIZE))                           \
+                {                                                       \
+                  SMALL_SORT (PFX, T, PFX##arr, PFX##nmemb, LT,         \
+                              (SMALL_SIZE));                            \
+                  PFX##done = true;                                     \
+                }                                                       \
+              else if (PFX##work < PFX##nmemb)                          \
+                {                                                       \
+                  QUICKSORTS__UNSTABLE_SELECT__HEAP_SELECT__TYPED       \
+                    (PFX, T, LT, PFX##k);                               \
+                  PFX##done = true;                                     \
+                }                                                       \
+              else                                                      \
+                {                                                       \
+                  PFX##work -= PFX##nmemb;                              \
+                  PARTITION (PFX, T, LT, PIVOT_SELECTION);              \
+                  (void) PFX##swapped;                                  \
+                  (void) PFX##p_pivot;                                  \
+                  const size_t PFX##i_ge = PFX##i_pivot + PFX##n_pivot; \
+                  if (PFX##k < PFX##i_pivot)                            \
+                    PFX##nmemb = PFX##i_pivot;                          \
+                  else if (PFX##k < PFX##i_ge)                          \
+                    PFX##done = true;                                   \
+                  else                                                  \
+                    {                                                   \
+                      PFX##arr += PFX##i_ge;                            \
+                      PFX##nmemb -= PFX##i_ge;                          \
+                      PFX##k -= PFX##i_ge;                              \
+                    }                                                   \
+                }                                                       \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__UNSTABLE_SELECT__PARTIAL_SORT(PFX, BASE, NMEMB,     \
+                                                  ELEMSZ, K, LT,        \
+                                                  PIVOT_SELECTION,      \
+                                                  SMALL_SIZE,           \
+                                                  SMALL_SORT,           \
+                                                  PARTITION)            \
+  do                                                                    \
+    {                                                                   \
+      void *PFX##base = (BASE);                                         \
+      const size_t PFX##n = (size_t) (NMEMB);                           \
+      const size_t PFX##elemsz = (size_t) (ELEMSZ);                     \
+      size_t PFX##n_sorted = (size_t) (K);                              \
+      if (PFX##n_sorted < PFX##n)                                       \
+        {                                                               \
+          if (PFX##n_sorted != 0)                                       \
+            {                                                           \
+              /* Put the greatest of the first K in place, and the */   \
+              /* others before it. */                                   \
+              PFX##n_sorted -= 1;                                       \
+              QUICKSORTS__UNSTABLE_SELECT__NTH_ELEMENT                  \
+                (PFX##select__, PFX##base, PFX##n, PFX##elemsz,         \
+                 PFX##n_sorted, LT, PIVOT_SELECTION, (SMALL_SIZE),      \
+                 SMALL_SORT, PARTITION);                                \
+            }                                                           \
+        }                                                               \
+      else                                                              \
+        PFX##n_sorted = PFX##n;                                         \
+      QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT                         \
+        (PFX##sort__, PFX##base, PFX##n_sorted, PFX##elemsz, LT,        \
+         PIVOT_SELECTION, (SMALL_SIZE), SMALL_SORT, PARTITION);         \
+    }                                                                   \
+  while (0)
+
+#define QUICKSORTS__UNSTABLE_SELECT__PARTIAL_SORT__TYPED(PFX, T, BASE,  \
+                                                         NMEMB, K, LT,  \
+                                                         PIVOT_SELECTION, \
+                                                         SMALL_SIZE,    \
+                                                         SMALL_SORT,    \
+                                                         PARTITION)     \
+  do                                                                    \
+    {                                                                   \
+      T *PFX##base = (T *) (BASE);                                      \
+      const size_t PFX##n = (size_t) (NMEMB);                           \
+      size_t PFX##n_sorted = (size_t) (K);                              \
+      if (PFX##n_sorted < PFX##n)                                       \
+        {                                                               \
+          if (PFX##n_sorted != 0)                                       \
+            {                                                           \
+              /* Put the greatest of the first K in place, and the */   \
+              /* others before it. */                                   \
+              PFX##n_sorted -= 1;                                       \
+              QUICKSORTS__UNSTABLE_SELECT__NTH_ELEMENT__TYPED           \
+                (PFX##select__, T, PFX##base, PFX##n, PFX##n_sorted,    \
+                 LT, PIVOT_SELECTION, (SMALL_SIZE), SMALL_SORT,         \
+                 PARTITION);                                            \
+            }                                                           \
+        }                                                               \
+      else                                                              \
+        PFX##n_sorted = PFX##n;                                         \
+      QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT__TYPED                  \
+        (PFX##sort__, T, PFX##base, PFX##n_sorted, LT,                  \
+         PIVOT_SELECTION, (SMALL_SIZE), SMALL_SORT, PARTITION);         \
+    }                                                                   \
+  while (0)
+
+#define UNSTABLE_NTH_ELEMENT_9ARGS(BASE, NMEMB, ELEMSZ, K, LT,          \
+                                   PIVOT_SELECTION, SMALL_SIZE,         \
+                                   SMALL_SORT, PARTITION)               \
+  do                                                                    \
+    {                                                                   \
+      QUICKSORTS__UNSTABLE_SELECT__NTH_ELEMENT                          \
+        (quicksorts__unstable_select__, (BASE), (NMEMB), (ELEMSZ),      \
+         (K), LT, PIVOT_SELECTION, (SMALL_SIZE), SMALL_SORT,            \
+         PARTITION);                                                    \
+    }                                                                   \
+  while (0)
+
+#define UNSTABLE_NTH_ELEMENT_TYPED_9ARGS(T, BASE, NMEMB, K, LT,         \
+                                         PIVOT_SELECTION, SMALL_SIZE,   \
+                                         SMALL_SORT, PARTITION)         \
+  do                                                                    \
+    {                                                                   \
+      QUICKSORTS__UNSTABLE_SELECT__NTH_ELEMENT__TYPED                   \
+        (quicksorts__unstable_select__typed__, T, (BASE), (NMEMB),      \
+         (K), LT, PIVOT_SELECTION, (SMALL_SIZE), SMALL_SORT,            \
+         PARTITION);                                                    \
+    }                                                                   \
+  while (0)
+
+#define UNSTABLE_NTH_ELEMENT_5ARGS(BASE, NMEMB, ELEMSZ, K, LT)          \
+  do                                                                    \
+    {                                                                   \
+      QUICKSORTS__UNSTABLE_SELECT__NTH_ELEMENT                          \
+        (quicksorts__unstable_select__,                                 \
+         (BASE), (NMEMB), (ELEMSZ), (K), LT,                            \
+         UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION,                  \
+         (UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE),                     \
+         UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT,                       \
+         UNSTABLE_QUICKSORT__DEFAULT__PARTITION);                       \
+    }                                                                   \
+  while (0)
+
+#define UNSTABLE_NTH_ELEMENT_TYPED_5ARGS(T, BASE, NMEMB, K, LT)         \
+  do                                                                    \
+    {                                                                   \
+      QUICKSORTS__UNSTABLE_SELECT__NTH_ELEMENT__TYPED                   \
+        (quicksorts__unstable_select__typed__, T,                       \
+         (BASE), (NMEMB), (K), LT,                                      \
+         UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION,                  \
+         (UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE),                     \
+         UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT__TYPED,                \
+         UNSTABLE_QUICKSORT__DEFAULT__PARTITION__TYPED);                \
+    }                                                                   \
+  while (0)
+
+#define UNSTABLE_PARTIAL_SORT_9ARGS(BASE, NMEMB, ELEMSZ, K, LT,         \
+                                    PIVOT_SELECTION, SMALL_SIZE,        \
+                                    SMALL_SORT, PARTITION)              \
+  do                                                                    \
+    {                                                                   \
+      QUICKSORTS__UNSTABLE_SELECT__PARTIAL_SORT                         \
+        (quicksorts__unstable_partial_sort__, (BASE), (NMEMB),          \
+         (ELEMSZ), (K), LT, PIVOT_SELECTION, (SMALL_SIZE),              \
+         SMALL_SORT, PARTITION);                                        \
+    }                                                                   \
+  while (0)
+
+#define UNSTABLE_PARTIAL_SORT_TYPED_9ARGS(T, BASE, NMEMB, K, LT,        \
+                                          PIVOT_SELECTION, SMALL_SIZE,  \
+                                          SMALL_SORT, PARTITION)        \
+  do                                                                    \
+    {                                                                   \
+      QUICKSORTS__UNSTABLE_SELECT__PARTIAL_SORT__TYPED                  \
+        (quicksorts__unstable_partial_sort__typed__, T, (BASE),         \
+         (NMEMB), (K), LT, PIVOT_SELECTION, (SMALL_SIZE),               \
+         SMALL_SORT, PARTITION);                                        \
+    }                                                                   \
+  while (0)
+
+#define UNSTABLE_PARTIAL_SORT_5ARGS(BASE, NMEMB, ELEMSZ, K, LT)         \
+  do                                                                    \
+    {                                                                   \
+      QUICKSORTS__UNSTABLE_SELECT__PARTIAL_SORT                         \
+        (quicksorts__unstable_partial_sort__,                           \
+         (BASE), (NMEMB), (ELEMSZ), (K), LT,                            \
+         UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION,                  \
+         (UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE),                     \
+         UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT,                       \
+         UNSTABLE_QUICKSORT__DEFAULT__PARTITION);                       \
+    }                                                                   \
+  while (0)
+
+#define UNSTABLE_PARTIAL_SORT_TYPED_5ARGS(T, BASE, NMEMB, K, LT)        \
+  do                                                                    \
+    {                                                                   \
+      QUICKSORTS__UNSTABLE_SELECT__PARTIAL_SORT__TYPED                  \
+        (quicksorts__unstable_partial_sort__typed__, T,                 \
+         (BASE), (NMEMB), (K), LT,                                      \
+         UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION,                  \
+         (UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE),                     \
+         UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT__TYPED,                \
+         UNSTABLE_QUICKSORT__DEFAULT__PARTITION__TYPED);                \
+    }                                                                   \
+  while (0)
+
+#define UNSTABLE_NTH_ELEMENT UNSTABLE_NTH_ELEMENT_5ARGS
+#define UNSTABLE_NTH_ELEMENT_TYPED UNSTABLE_NTH_ELEMENT_TYPED_5ARGS
+#define UNSTABLE_PARTIAL_SORT UNSTABLE_PARTIAL_SORT_5ARGS
+#define UNSTABLE_PARTIAL_SORT_TYPED UNSTABLE_PARTIAL_SORT_TYPED_5ARGS
+
+#endif /* QUICKSORTS__UNSTABLE_SELECT_H__HEADER_GUARD__ */
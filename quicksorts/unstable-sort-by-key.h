@@ -0,0 +1,151 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef QUICKSORTS__UNSTABLE_SORT_BY_KEY_H__HEADER_GUARD__
+#define QUICKSORTS__UNSTABLE_SORT_BY_KEY_H__HEADER_GUARD__
+
+#include <stdint.h>
+#include <stdlib.h>
+#include <quicksorts/unstable-quicksort.h>
+#include <quicksorts/unstable-radix-sort.h>
+
+/*
+  Sorting by a cached key (‘decorate, sort, undecorate’).
+
+  KEY (p) gives, for a pointer p to an element, a 64-bit unsigned
+  prefix of the element’s sort key: for instance the first eight
+  bytes of a string, taken in big-endian order, or a float mapped by
+  unstable_radix_sort_float_key. LT must be the full order, and must
+  agree with the keys: if KEY (a) < KEY (b) then LT (a, b).
+
+  The keys are computed once, paired with pointers to their elements,
+  and the pairs radix-sorted on the keys alone. The elements are then
+  moved into that order, each once, and only runs of elements with
+  equal keys are sorted with LT.
+
+  The pairs take 16 bytes per element. If they cannot be allocated,
+  the elements are sorted with LT directly.
+*/
+
+struct quicksorts__unstable_sort_by_key__pair
+{
+  uint64_t key;
+  char *p;
+};
+
+#define QUICKSORTS__UNSTABLE_SORT_BY_KEY__PAIR_KEY(P)                   \
+  (((const struct quicksorts__unstable_sort_by_key__pair *) (P))->key)
+
+#define QUICKSORTS__UNSTABLE_SORT_BY_KEY__PAIR_LT(P, Q)     \
+  (QUICKSORTS__UNSTABLE_SORT_BY_KEY__PAIR_KEY (P)           \
+   < QUICKSORTS__UNSTABLE_SORT_BY_KEY__PAIR_KEY (Q))
+
+/* If BREAK_TIES is false, elements with equal keys are left in
+   whatever order the radix sort leaves them. */
+#define QUICKSORTS__UNSTABLE_SORT_BY_KEY__SORT(PFX, BASE, NMEMB,        \
+                                               ELEMSZ, KEY, LT,         \
+                                               BREAK_TIES)              \
+  do                                                                    \
+    {                                                                   \
+      char *PFX##base = (void *) (BASE);                                \
+      const size_t PFX##n = (size_t) (NMEMB);                           \
+      const size_t PFX##elemsz = (size_t) (ELEMSZ);                     \
+                                                                        \
+      struct quicksorts__unstable_sort_by_key__pair *PFX##pairs = NULL; \
+      char *PFX##tmp = NULL;                                            \
+      if (2 <= PFX##n && 0 < PFX##elemsz                                \
+          && PFX##n <= SIZE_MAX / sizeof *PFX##pairs)                   \
+        {                                                               \
+          PFX##pairs =                                                  \
+            QUICKSORTS_COMMON__MALLOC (PFX##n * sizeof *PFX##pairs);    \
+          PFX##tmp = QUICKSORTS_COMMON__MALLOC (PFX##elemsz);           \
+        }                                                               \
+                                                                        \
+      if (PFX##pairs == NULL || PFX##tmp == NULL)                       \
+        {                                                               \
+          /* There is nothing to sort, or no memory for the keys. */    \
+          QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT                     \
+            (PFX##direct__, PFX##base, PFX##n, PFX##elemsz, LT,         \
+             UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION,              \
+             (UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE),                 \
+             UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT,                   \
+             UNSTABLE_QUICKSORT__DEFAULT__PARTITION);                   \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          for (size_t PFX##i = 0; PFX##i != PFX##n; PFX##i += 1)        \
+            {                                                           \
+              PFX##pairs[PFX##i].p =                                    \
+                PFX##base + (PFX##i * PFX##elemsz);                     \
+              PFX##pairs[PFX##i].key =                                  \
+                (uint64_t) KEY ((const void *) PFX##pairs[PFX##i].p);   \
+            }                                                           \
+          QUICKSORTS__UNSTABLE_RADIX_SORT__RADIX_SORT__TYPED            \
+            (PFX##radix__, struct quicksorts__unstable_sort_by_key__pair, \
+             PFX##pairs, PFX##n,                                        \
+             QUICKSORTS__UNSTABLE_SORT_BY_KEY__PAIR_KEY,                \
+             QUICKSORTS__UNSTABLE_SORT_BY_KEY__PAIR_LT,                 \
+             (QUICKSORTS__UNSTABLE_RADIX_SORT__BUCKET_SIZE));           \
+                                                                        \
+          /* Only the pointers are overwritten, so the keys */          \
+          /* are left in the order of the elements.         */          \
+          quicksorts_common__permute_by_strided_pointers                \
+            (PFX##base, PFX##n, PFX##elemsz, (char *) &PFX##pairs->p,   \
+             sizeof *PFX##pairs, PFX##tmp);                             \
+                                                                        \
+          if (BREAK_TIES)                                               \
+            {                                                           \
+              /* Sort each run of equal keys with the full order. */    \
+              /* The pairs hold the keys, now in sorted order.    */    \
+              size_t PFX##i = 0;                                        \
+              while (PFX##i != PFX##n)                                  \
+                {                                                       \
+                  const size_t PFX##start = PFX##i;                     \
+                  do                                                    \
+                    PFX##i += 1;                                        \
+                  while (PFX##i != PFX##n                               \
+                         && (PFX##pairs[PFX##i].key                     \
+                             == PFX##pairs[PFX##start].key));           \
+                  if (2 <= PFX##i - PFX##start)                         \
+                    QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT           \
+                      (PFX##ties__,                                     \
+                       PFX##base + (PFX##start * PFX##elemsz),          \
+                       PFX##i - PFX##start, PFX##elemsz, LT,            \
+                       UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION,    \
+                       (UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE),       \
+                       UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT,         \
+                       UNSTABLE_QUICKSORT__DEFAULT__PARTITION);         \
+                }                                                       \
+            }                                                           \
+        }                                                               \
+                                                                        \
+      QUICKSORTS_COMMON__FREE (PFX##pairs);                             \
+      QUICKSORTS_COMMON__FREE (PFX##tmp);                               \
+    }                                                                   \
+  while (0)
+
+#define UNSTABLE_SORT_BY_KEY(BASE, NMEMB, ELEMSZ, KEY, LT)  \
+  do                                                        \
+    {                                                       \
+      QUICKSORTS__UNSTABLE_SORT_BY_KEY__SORT                \
+        (quicksorts__unstable_sort_by_key__,                \
+         (BASE), (NMEMB), (ELEMSZ), KEY, LT, true);         \
+    }                                                       \
+  while (0)
+
+#endif /* QUICKSORTS__UNSTABLE_SORT_BY_KEY_H__HEADER_GUARD__ */
@@ -0,0 +1,44 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef QUICKSORTS__UNSTABLE_SORT_KEYS_H__HEADER_GUARD__
+#define QUICKSORTS__UNSTABLE_SORT_KEYS_H__HEADER_GUARD__
+
+#include <stdint.h>
+#include <stdlib.h>
+
+/*
+  Sort arrays of primitive keys into ascending order. On x86-64, the
+  partitioning is vectorized with AVX-512 or AVX2, whichever the CPU
+  supports; elsewhere a scalar quicksort is used.
+
+  Floating-point arrays that contain NaNs are left in an unspecified
+  order.
+
+  The environment variable QUICKSORTS_SIMD may be set to "avx2" or
+  "none", to hold the vectorization down to that level.
+*/
+
+void unstable_sort_int32 (int32_t *base, size_t nmemb);
+void unstable_sort_uint32 (uint32_t *base, size_t nmemb);
+void unstable_sort_int64 (int64_t *base, size_t nmemb);
+void unstable_sort_uint64 (uint64_t *base, size_t nmemb);
+void unstable_sort_float (float *base, size_t nmemb);
+void unstable_sort_double (double *base, size_t nmemb);
+
+#endif /* QUICKSORTS__UNSTABLE_SORT_KEYS_H__HEADER_GUARD__ */
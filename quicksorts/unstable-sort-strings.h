@@ -0,0 +1,32 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef QUICKSORTS__UNSTABLE_SORT_STRINGS_H__HEADER_GUARD__
+#define QUICKSORTS__UNSTABLE_SORT_STRINGS_H__HEADER_GUARD__
+
+#include <stdlib.h>
+
+/* Sort an array of C strings into strcmp order, by multikey
+   quicksort. If lcp is not NULL, it must have room for nmemb entries,
+   and receives the length of the common prefix of each string and
+   the one before it (zero for the first). See
+   <quicksorts/unstable-string-sort.h>. */
+void unstable_sort_strings (const char **base, size_t nmemb,
+                            size_t *lcp);
+
+#endif /* QUICKSORTS__UNSTABLE_SORT_STRINGS_H__HEADER_GUARD__ */
@@ -0,0 +1,300 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#ifndef QUICKSORTS__UNSTABLE_STRING_SORT_H__HEADER_GUARD__
+#define QUICKSORTS__UNSTABLE_STRING_SORT_H__HEADER_GUARD__
+
+#include <stdlib.h>
+#include <quicksorts/unstable-quicksort.h>
+
+/*
+  Multikey quicksort of arrays of C strings, after Jon L. Bentley and
+  Robert Sedgewick, "Fast algorithms for sorting and searching
+  strings", Proceedings of the Eighth Annual ACM-SIAM Symposium on
+  Discrete Algorithms, 1997, pp. 360-369.
+
+  Every string in a subarray shares a prefix of known length, the
+  subarray’s depth, and the subarray is partitioned three ways on the
+  character at that depth: the three-way partition and the pivot
+  selection are the quicksort’s own, ordering strings by that one
+  character. Strings with a lesser or greater character stay at the
+  same depth; those with an equal character go one character deeper.
+  A shared prefix is therefore examined once, not at every
+  comparison.
+
+  Small subarrays are finished by SMALL_SORT, comparing the strings
+  from the subarray’s depth on. A subarray that exhausts its
+  partitioning budget without getting any deeper is heapsorted the
+  same way.
+
+  Characters are compared as unsigned char, as strcmp does.
+
+  If LCP is not NULL, it must have room for NMEMB entries, and is
+  filled with the longest-common-prefix array of the result: LCP[0]
+  is zero, and LCP[i] is the length of the common prefix of the
+  strings at i - 1 and i. Most of it comes free from the
+  partitioning.
+
+  The character depth has a fixed name, for the comparison macros
+  below to see; so these sorts cannot be nested inside one another’s
+  comparisons.
+*/
+
+#define QUICKSORTS__UNSTABLE_STRING_SORT__CHAR_AT(P)                    \
+  ((unsigned char)                                                      \
+   (*(const char *const *) (P))[quicksorts__unstable_string_sort__depth])
+
+#define QUICKSORTS__UNSTABLE_STRING_SORT__CHAR_LT(P, Q)     \
+  (QUICKSORTS__UNSTABLE_STRING_SORT__CHAR_AT (P)            \
+   < QUICKSORTS__UNSTABLE_STRING_SORT__CHAR_AT (Q))
+
+#define QUICKSORTS__UNSTABLE_STRING_SORT__SUFFIX_LT(P, Q)               \
+  (QUICKSORTS_COMMON__STRCMP                                            \
+   ((*(const char *const *) (P)) + quicksorts__unstable_string_sort__depth, \
+    (*(const char *const *) (Q)) + quicksorts__unstable_string_sort__depth) \
+   < 0)
+
+#define QUICKSORTS__UNSTABLE_STRING_SORT__SORT(PFX, BASE, NMEMB, LCP,   \
+                                               PIVOT_SELECTION,         \
+                                               SMALL_SIZE, SMALL_SORT)  \
+  do                                                                    \
+    {                                                                   \
+      const char **PFX##base = (const char **) (BASE);                  \
+      const size_t PFX##n = (size_t) (NMEMB);                           \
+      size_t *PFX##lcp = (LCP);                                         \
+                                                                        \
+      if (PFX##lcp != NULL && PFX##n != 0)                              \
+        PFX##lcp[0] = 0;                                                \
+      if (2 <= PFX##n)                                                  \
+        {                                                               \
+          typedef struct                                                \
+          {                                                             \
+            const char **p;                                             \
+            size_t n;                                                   \
+            size_t depth;                                               \
+            int budget;                                                 \
+          } PFX##task_t;                                                \
+                                                                        \
+          /* The smallest part is always taken next, and it is at */   \
+          /* most half its parent whenever more than one part is */     \
+          /* pushed; so this is enough. */                              \
+          PFX##task_t PFX##stk[2 * CHAR_BIT * sizeof (size_t) + 1];     \
+          size_t PFX##stk_depth = 0;                                    \
+          PFX##stk[0].p = PFX##base;                                    \
+          PFX##stk[0].n = PFX##n;                                       \
+          PFX##stk[0].depth = 0;                                        \
+          PFX##stk[0].budget = quicksorts_common__depth_limit (PFX##n); \
+          PFX##stk_depth = 1;                                           \
+                                                                        \
+          while (PFX##stk_depth != 0)                                   \
+            {                                                           \
+              PFX##stk_depth -= 1;                                      \
+              const char **PFX##arr = PFX##stk[PFX##stk_depth].p;       \
+              size_t PFX##nmemb = PFX##stk[PFX##stk_depth].n;           \
+              const size_t quicksorts__unstable_string_sort__depth =    \
+                PFX##stk[PFX##stk_depth].depth;                         \
+              const int PFX##budget = PFX##stk[PFX##stk_depth].budget;  \
+              const size_t PFX##i0 = PFX##arr - PFX##base;              \
+              bool PFX##scan_lcp = false;                               \
+                                                                        \
+              if (PFX##nmemb <= (SMALL_SIZE))                           \
+                {                                                       \
+                  SMALL_SORT                                            \
+                    (PFX, const char *, PFX##arr, PFX##nmemb,           \
+                     QUICKSORTS__UNSTABLE_STRING_SORT__SUFFIX_LT,       \
+                     (SMALL_SIZE));                                     \
+                  PFX##scan_lcp = true;                                 \
+                }                                                       \
+              else if (PFX##budget == 0)                                \
+                {                                                       \
+                  QUICKSORTS__UNSTABLE_QUICKSORT__HEAP_SORT__TYPED      \
+                    (PFX, const char *, PFX##arr, PFX##nmemb,           \
+                     QUICKSORTS__UNSTABLE_STRING_SORT__SUFFIX_LT,       \
+                     (SMALL_SIZE));                                     \
+                  PFX##scan_lcp = true;                                 \
+                }                                                       \
+              else                                                      \
+                {                                                       \
+                  size_t PFX##i_pivot;                                  \
+                  size_t PFX##n_pivot;                                  \
+                  bool PFX##swapped;                                    \
+                  const char **PFX##p_pivot;                            \
+                  QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_THREE_WAY__TYPED \
+                    (PFX, const char *,                                 \
+                     QUICKSORTS__UNSTABLE_STRING_SORT__CHAR_LT,         \
+                     PIVOT_SELECTION);                                  \
+                  (void) PFX##swapped;                                  \
+                                                                        \
+                  const size_t PFX##n_lt = PFX##i_pivot;                \
+                  const size_t PFX##n_eq = PFX##n_pivot;                \
+                  const size_t PFX##n_gt =                              \
+                    PFX##nmemb - PFX##n_lt - PFX##n_eq;                 \
+                  const bool PFX##at_end =                              \
+                    (QUICKSORTS__UNSTABLE_STRING_SORT__CHAR_AT          \
+                     (PFX##p_pivot) == 0);                              \
+                                                                        \
+                  /* Strings in different parts differ at this depth. */ \
+                  /* Strings that ended here are all equal. */          \
+                  if (PFX##lcp != NULL)                                 \
+                    {                                                   \
+                      size_t *PFX##lcp_eq = PFX##lcp + PFX##i0 + PFX##n_lt; \
+                      if (PFX##n_lt != 0)                               \
+                        PFX##lcp_eq[0] =                                \
+                          quicksorts__unstable_string_sort__depth;      \
+                      if (PFX##n_gt != 0)                               \
+                        PFX##lcp_eq[PFX##n_eq] =                        \
+                          quicksorts__unstable_string_sort__depth;      \
+                      if (PFX##at_end)                                  \
+                        for (size_t PFX##j = 1; PFX##j < PFX##n_eq;     \
+                             PFX##j += 1)                               \
+                          PFX##lcp_eq[PFX##j] =                         \
+                            quicksorts__unstable_string_sort__depth;    \
+                    }                                                   \
+                                                                        \
+                  /* Push the parts left to sort, largest first. */     \
+                  PFX##task_t PFX##parts[3];                            \
+                  size_t PFX##n_parts = 0;                              \
+                  if (2 <= PFX##n_lt)                                   \
+                    {                                                   \
+                      PFX##parts[PFX##n_parts].p = PFX##arr;            \
+                      PFX##parts[PFX##n_parts].n = PFX##n_lt;           \
+                      PFX##parts[PFX##n_parts].depth =                  \
+                        quicksorts__unstable_string_sort__depth;        \
+                      PFX##parts[PFX##n_parts].budget = PFX##budget - 1; \
+                      PFX##n_parts += 1;                                \
+                    }                                                   \
+                  if (2 <= PFX##n_eq && !PFX##at_end)                   \
+                    {                                                   \
+                      size_t PFX##next_depth =                          \
+                        quicksorts__unstable_string_sort__depth + 1;    \
+                      if (PFX##n_eq == PFX##nmemb)                      \
+                        {                                               \
+                          /* No progress but a character: look for */   \
+                          /* the end of the whole shared prefix. */     \
+                          const unsigned char *PFX##s =                 \
+                            (const unsigned char *) PFX##arr[0];        \
+                          size_t PFX##limit = SIZE_MAX;                 \
+                          for (size_t PFX##j = 1; PFX##j != PFX##nmemb; \
+                               PFX##j += 1)                             \
+                            {                                           \
+                              const unsigned char *PFX##t =             \
+                                (const unsigned char *) PFX##arr[PFX##j]; \
+                              size_t PFX##d = PFX##next_depth;          \
+                              while (PFX##d != PFX##limit               \
+                                     && PFX##s[PFX##d] != 0             \
+                                     && PFX##s[PFX##d] == PFX##t[PFX##d]) \
+                                PFX##d += 1;                            \
+                              PFX##limit = PFX##d;                      \
+                            }                                           \
+                          PFX##next_depth = PFX##limit;                 \
+                        }                                               \
+                      PFX##parts[PFX##n_parts].p = PFX##p_pivot;        \
+                      PFX##parts[PFX##n_parts].n = PFX##n_eq;           \
+                      PFX##parts[PFX##n_parts].depth = PFX##next_depth; \
+                      PFX##parts[PFX##n_parts].budget =                 \
+                        quicksorts_common__depth_limit (PFX##n_eq);     \
+                      PFX##n_parts += 1;                                \
+                    }                                                   \
+                  if (2 <= PFX##n_gt)                                   \
+                    {                                                   \
+                      PFX##parts[PFX##n_parts].p =                      \
+                        PFX##p_pivot + PFX##n_eq;                       \
+                      PFX##parts[PFX##n_parts].n = PFX##n_gt;           \
+                      PFX##parts[PFX##n_parts].depth =                  \
+                        quicksorts__unstable_string_sort__depth;        \
+                      PFX##parts[PFX##n_parts].budget = PFX##budget - 1; \
+                      PFX##n_parts += 1;                                \
+                    }                                                   \
+                  for (size_t PFX##j = 1; PFX##j < PFX##n_parts;        \
+                       PFX##j += 1)                                     \
+                    for (size_t PFX##m = PFX##j;                        \
+                         0 < PFX##m                                     \
+                           && (PFX##parts[PFX##m - 1].n                 \
+                               < PFX##parts[PFX##m].n);                 \
+                         PFX##m -= 1)                                   \
+                      {                                                 \
+                        PFX##task_t PFX##t = PFX##parts[PFX##m];        \
+                        PFX##parts[PFX##m] = PFX##parts[PFX##m - 1];    \
+                        PFX##parts[PFX##m - 1] = PFX##t;                \
+                      }                                                 \
+                  for (size_t PFX##j = 0; PFX##j != PFX##n_parts;       \
+                       PFX##j += 1)                                     \
+                    {                                                   \
+                      assert (PFX##stk_depth                            \
+                              < 2 * CHAR_BIT * sizeof (size_t) + 1);    \
+                      PFX##stk[PFX##stk_depth] = PFX##parts[PFX##j];    \
+                      PFX##stk_depth += 1;                              \
+                    }                                                   \
+                }                                                       \
+                                                                        \
+              if (PFX##scan_lcp && PFX##lcp != NULL)                    \
+                for (size_t PFX##j = 1; PFX##j < PFX##nmemb; PFX##j += 1) \
+                  {                                                     \
+                    const unsigned char *PFX##s =                       \
+                      (const unsigned char *) PFX##arr[PFX##j - 1];     \
+                    const unsigned char *PFX##t =                       \
+                      (const unsigned char *) PFX##arr[PFX##j];         \
+                    size_t PFX##d = quicksorts__unstable_string_sort__depth; \
+                    while (PFX##s[PFX##d] != 0                          \
+                           && PFX##s[PFX##d] == PFX##t[PFX##d])         \
+                      PFX##d += 1;                                      \
+                    PFX##lcp[PFX##i0 + PFX##j] = PFX##d;                \
+                  }                                                     \
+            }                                                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+#define UNSTABLE_STRING_SORT_6ARGS(BASE, NMEMB, LCP, PIVOT_SELECTION,   \
+                                   SMALL_SIZE, SMALL_SORT)              \
+  do                                                                    \
+    {                                                                   \
+      QUICKSORTS__UNSTABLE_STRING_SORT__SORT                            \
+        (quicksorts__unstable_string_sort__, (BASE), (NMEMB), (LCP),    \
+         PIVOT_SELECTION, (SMALL_SIZE), SMALL_SORT);                    \
+    }                                                                   \
+  while (0)
+
+#define UNSTABLE_STRING_SORT_3ARGS(BASE, NMEMB, LCP)                \
+  do                                                                \
+    {                                                               \
+      QUICKSORTS__UNSTABLE_STRING_SORT__SORT                        \
+        (quicksorts__unstable_string_sort__, (BASE), (NMEMB), (LCP), \
+         UNSTABLE_STRING_SORT__DEFAULT__PIVOT_SELECTION,            \
+         (UNSTABLE_STRING_SORT__DEFAULT__SMALL_SIZE),               \
+         UNSTABLE_STRING_SORT__DEFAULT__SMALL_SORT);                \
+    }                                                               \
+  while (0)
+
+#define UNSTABLE_STRING_SORT UNSTABLE_STRING_SORT_3ARGS
+
+#ifndef UNSTABLE_STRING_SORT__DEFAULT__PIVOT_SELECTION
+#define UNSTABLE_STRING_SORT__DEFAULT__PIVOT_SELECTION  \
+  QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE
+#endif
+
+#ifndef UNSTABLE_STRING_SORT__DEFAULT__SMALL_SIZE
+#define UNSTABLE_STRING_SORT__DEFAULT__SMALL_SIZE 16
+#endif
+
+#ifndef UNSTABLE_STRING_SORT__DEFAULT__SMALL_SORT
+#define UNSTABLE_STRING_SORT__DEFAULT__SMALL_SORT           \
+  QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED
+#endif
+
+#endif /* QUICKSORTS__UNSTABLE_STRING_SORT_H__HEADER_GUARD__ */
@@ -0,0 +1,455 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdalign.h>
+#include <stddef.h>
+#include <stdint.h>
+#include "quicksorts/qsort-plan.h"
+
+/* The sorts take their scratch memory from the plan. Every expansion
+   of these is in an engine, where ‘plan’ is the plan executing. */
+#define QUICKSORTS_COMMON__MALLOC(SIZE) scratch_malloc (plan, (SIZE))
+#define QUICKSORTS_COMMON__FREE(PTR) scratch_free (plan, (PTR))
+
+#include "quicksorts/unstable-qsort.h"
+#include "quicksorts/unstable-qsort-parallel.h"
+#include "quicksorts/unstable-quicksort.h"
+#include "quicksorts/unstable-radix-sort.h"
+#include "quicksorts/unstable-sort-by-key.h"
+#include "quicksorts/unstable-sort-keys.h"
+#include "quicksorts/stable-quicksort.h"
+#include "unstable-qsort-defaults.h"
+
+#undef LT_PREDICATE
+#define LT_PREDICATE(x, y) (compar ((x), (y), arg) < 0)
+
+/* Compare the elements that two entries of the pointer array point
+   to. */
+#undef LT_INDIRECT
+#define LT_INDIRECT(x, y)                                       \
+  LT_PREDICATE (*(char *const *) (x), *(char *const *) (y))
+
+/* The stable sorts are those of stable_qsort_r. */
+#ifndef STABLE_PIVOT_SELECTION
+#define STABLE_PIVOT_SELECTION QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE
+#endif
+
+#ifndef STABLE_SMALL_SIZE
+#define STABLE_SMALL_SIZE 40
+#endif
+
+#ifndef STABLE_SMALL_SORT
+#define STABLE_SMALL_SORT QUICKSORTS__STABLE_QUICKSORT__INSERTION_SORT
+#endif
+
+typedef int compar_t (const void *, const void *, void *);
+
+typedef void engine_t (quicksorts_plan *plan, void *base, size_t nmemb,
+                       compar_t *compar, void *arg);
+
+struct quicksorts_plan
+{
+  engine_t *engine;
+  size_t elemsz;
+  size_t small_size;
+
+  /* Scratch memory is handed out from the front. Freeing a block
+     takes back it and everything handed out after it, which suits
+     the sorts: they free what they allocate before they allocate
+     anything that outlives it, or else free it all together. */
+  char *scratch;
+  size_t scratch_size;
+  size_t scratch_used;
+};
+
+#define SCRATCH_ALIGN (alignof (max_align_t))
+
+static void *
+scratch_malloc (quicksorts_plan *plan, size_t size)
+{
+  void *p;
+  if (size <= plan->scratch_size - plan->scratch_used)
+    {
+      p = plan->scratch + plan->scratch_used;
+      plan->scratch_used +=
+        ((size + (SCRATCH_ALIGN - 1)) / SCRATCH_ALIGN) * SCRATCH_ALIGN;
+    }
+  else
+    p = malloc (size);
+  return p;
+}
+
+static void
+scratch_free (quicksorts_plan *plan, void *ptr)
+{
+  const size_t offset = (uintptr_t) ptr - (uintptr_t) plan->scratch;
+  if (offset < plan->scratch_size)
+    {
+      if (offset < plan->scratch_used)
+        plan->scratch_used = offset;
+    }
+  else
+    free (ptr);
+}
+
+/* Add room for n blocks of size bytes to *total, returning false on
+   overflow. */
+static bool
+scratch_add (size_t *total, size_t n, size_t size)
+{
+  bool ok = (size == 0 || n <= (SIZE_MAX / 2) / size);
+  if (ok)
+    {
+      const size_t bytes =
+        (((n * size) + (SCRATCH_ALIGN - 1)) / SCRATCH_ALIGN)
+        * SCRATCH_ALIGN;
+      ok = (bytes <= (SIZE_MAX / 2) - *total);
+      if (ok)
+        *total += bytes;
+    }
+  return ok;
+}
+
+/* The elements of the buffer for merging the runs of an array of n
+   elements of the given size. The sorts merge through no more than
+   MERGE_BUFFER_SIZE bytes. */
+static size_t
+merge_buffer_nmemb (size_t n, size_t size)
+{
+  const size_t cap =
+    (QUICKSORTS__UNSTABLE_QUICKSORT__MERGE_BUFFER_SIZE) / size;
+  return (n / 2 < cap) ? (n / 2) : cap;
+}
+
+/*------------------------------------------------------------------*/
+/* Engines for the comparison function.                             */
+
+static void
+engine_bytes (quicksorts_plan *plan, void *base, size_t nmemb,
+              compar_t *compar, void *arg)
+{
+  QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT
+    (quicksorts__plan__, base, nmemb, plan->elemsz, LT_PREDICATE,
+     PIVOT_SELECTION, plan->small_size, SMALL_SORT, PARTITION);
+}
+
+/* The same, for elements of HOLE_PARTITION_SIZE bytes or more. */
+static void
+engine_large (quicksorts_plan *plan, void *base, size_t nmemb,
+              compar_t *compar, void *arg)
+{
+  QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT
+    (quicksorts__plan__, base, nmemb, plan->elemsz, LT_PREDICATE,
+     LARGE_PIVOT_SELECTION, plan->small_size, SMALL_SORT,
+     LARGE_PARTITION);
+}
+
+/* The same, for elements that can be moved as words. If the array is
+   not aligned for the words, it is sorted as bytes. */
+#define DEFINE_WORDS_ENGINE(NAME, T)                                    \
+  static void                                                           \
+  NAME (quicksorts_plan *plan, void *base, size_t nmemb,                \
+        compar_t *compar, void *arg)                                    \
+  {                                                                     \
+    if ((uintptr_t) base % alignof (T) != 0)                            \
+      engine_bytes (plan, base, nmemb, compar, arg);                    \
+    else                                                                \
+      QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT__TYPED                  \
+        (quicksorts__plan__, T, base, nmemb, LT_PREDICATE,              \
+         PIVOT_SELECTION, plan->small_size,                             \
+         SMALL_SORT__TYPED, PARTITION__TYPED);                          \
+  }
+
+DEFINE_WORDS_ENGINE (engine_words4, quicksorts__unstable_quicksort__words4_t)
+DEFINE_WORDS_ENGINE (engine_words8, quicksorts__unstable_quicksort__words8_t)
+DEFINE_WORDS_ENGINE (engine_words16,
+                     quicksorts__unstable_quicksort__words16_t)
+DEFINE_WORDS_ENGINE (engine_words24,
+                     quicksorts__unstable_quicksort__words24_t)
+DEFINE_WORDS_ENGINE (engine_words32,
+                     quicksorts__unstable_quicksort__words32_t)
+DEFINE_WORDS_ENGINE (engine_words64,
+                     quicksorts__unstable_quicksort__words64_t)
+
+/* As unstable_qsort_r_indirect. */
+static void
+engine_indirect (quicksorts_plan *plan, void *base, size_t nmemb,
+                 compar_t *compar, void *arg)
+{
+  QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT_INDIRECT
+    (quicksorts__plan__, base, nmemb, plan->elemsz, LT_PREDICATE,
+     LT_INDIRECT, PIVOT_SELECTION, plan->small_size, SMALL_SORT,
+     PARTITION);
+}
+
+static void
+engine_parallel (quicksorts_plan *plan, void *base, size_t nmemb,
+                 compar_t *compar, void *arg)
+{
+  unstable_qsort_r_parallel (base, nmemb, plan->elemsz, compar, arg);
+}
+
+static void
+engine_stable (quicksorts_plan *plan, void *base, size_t nmemb,
+               compar_t *compar, void *arg)
+{
+  QUICKSORTS__STABLE_QUICKSORT__QUICKSORT
+    (quicksorts__plan__, base, nmemb, plan->elemsz, LT_PREDICATE,
+     STABLE_PIVOT_SELECTION, STABLE_SMALL_SIZE, STABLE_SMALL_SORT);
+}
+
+/*------------------------------------------------------------------*/
+/* Engines for keys.                                                */
+
+/* Keys are mapped to unsigned integers in the same order, as for the
+   radix sort, and 32-bit ones put in the high half, where the radix
+   sort looks first. */
+#define KEY_AS_IS(x) (x)
+
+#define DEFINE_KEY(NAME, T, KEY_OF, SHIFT)                              \
+  static inline uint64_t                                                \
+  key_##NAME (const void *p)                                            \
+  {                                                                     \
+    T x;                                                                \
+    QUICKSORTS_COMMON__MEMCPY (&x, p, sizeof x);                        \
+    return ((uint64_t) KEY_OF (x)) << (SHIFT);                          \
+  }
+
+DEFINE_KEY (int32, int32_t, unstable_radix_sort_int32_key, 32)
+DEFINE_KEY (uint32, uint32_t, KEY_AS_IS, 32)
+DEFINE_KEY (int64, int64_t, unstable_radix_sort_int64_key, 0)
+DEFINE_KEY (uint64, uint64_t, KEY_AS_IS, 0)
+DEFINE_KEY (float, float, unstable_radix_sort_float_key, 32)
+DEFINE_KEY (double, double, unstable_radix_sort_double_key, 0)
+
+/* Order by key, then by the comparison function if there is one. */
+#define LT_KEYED(KEY, x, y)                             \
+  (KEY (x) < KEY (y)                                    \
+   || (compar != NULL && KEY (x) == KEY (y)             \
+       && LT_PREDICATE ((x), (y))))
+
+#define LT_int32(x, y) LT_KEYED (key_int32, x, y)
+#define LT_uint32(x, y) LT_KEYED (key_uint32, x, y)
+#define LT_int64(x, y) LT_KEYED (key_int64, x, y)
+#define LT_uint64(x, y) LT_KEYED (key_uint64, x, y)
+#define LT_float(x, y) LT_KEYED (key_float, x, y)
+#define LT_double(x, y) LT_KEYED (key_double, x, y)
+
+/* Records are radix-sorted on their keys, or stable-sorted. Arrays of
+   nothing but keys go to the vectorized sorts, unless they are not
+   aligned for them. */
+#define DEFINE_KEY_ENGINES(NAME, T)                                     \
+  static void                                                           \
+  engine_keyed_##NAME (quicksorts_plan *plan, void *base,               \
+                       size_t nmemb, compar_t *compar, void *arg)       \
+  {                                                                     \
+    QUICKSORTS__UNSTABLE_SORT_BY_KEY__SORT                              \
+      (quicksorts__plan__, base, nmemb, plan->elemsz, key_##NAME,       \
+       LT_##NAME, compar != NULL);                                      \
+  }                                                                     \
+                                                                        \
+  static void                                                           \
+  engine_stable_##NAME (quicksorts_plan *plan, void *base,              \
+                        size_t nmemb, compar_t *compar, void *arg)      \
+  {                                                                     \
+    QUICKSORTS__STABLE_QUICKSORT__QUICKSORT                             \
+      (quicksorts__plan__, base, nmemb, plan->elemsz, LT_##NAME,        \
+       STABLE_PIVOT_SELECTION, STABLE_SMALL_SIZE, STABLE_SMALL_SORT);   \
+  }                                                                     \
+                                                                        \
+  static void                                                           \
+  engine_bare_##NAME (quicksorts_plan *plan, void *base,                \
+                      size_t nmemb, compar_t *compar, void *arg)        \
+  {                                                                     \
+    if ((uintptr_t) base % alignof (T) != 0)                            \
+      engine_keyed_##NAME (plan, base, nmemb, NULL, arg);               \
+    else                                                                \
+      unstable_sort_##NAME ((T *) base, nmemb);                         \
+    (void) compar;                                                      \
+  }
+
+DEFINE_KEY_ENGINES (int32, int32_t)
+DEFINE_KEY_ENGINES (uint32, uint32_t)
+DEFINE_KEY_ENGINES (int64, int64_t)
+DEFINE_KEY_ENGINES (uint64, uint64_t)
+DEFINE_KEY_ENGINES (float, float)
+DEFINE_KEY_ENGINES (double, double)
+
+typedef struct
+{
+  size_t size;
+  engine_t *keyed;
+  engine_t *stable;
+  engine_t *bare;
+} key_engines_t;
+
+#define KEY_ENGINES(NAME, T)                                            \
+  { sizeof (T), engine_keyed_##NAME, engine_stable_##NAME,              \
+    engine_bare_##NAME }
+
+static const key_engines_t key_engines[] = {
+  [QUICKSORTS_KEY_INT32] = KEY_ENGINES (int32, int32_t),
+  [QUICKSORTS_KEY_UINT32] = KEY_ENGINES (uint32, uint32_t),
+  [QUICKSORTS_KEY_INT64] = KEY_ENGINES (int64, int64_t),
+  [QUICKSORTS_KEY_UINT64] = KEY_ENGINES (uint64, uint64_t),
+  [QUICKSORTS_KEY_FLOAT] = KEY_ENGINES (float, float),
+  [QUICKSORTS_KEY_DOUBLE] = KEY_ENGINES (double, double)
+};
+
+/*------------------------------------------------------------------*/
+/* Plans.                                                           */
+
+quicksorts_plan *
+quicksorts_plan_create (size_t elemsz, enum quicksorts_key key,
+                        size_t size_hint, unsigned int flags)
+{
+  const size_t n = size_hint;
+  const bool stable = ((flags & QUICKSORTS_PLAN_STABLE) != 0);
+  engine_t *engine = NULL;
+  size_t small_size = SMALL_SIZE_BY_ELEMSZ (elemsz);
+  size_t scratch_size = 0;
+  bool ok = true;
+
+  if (elemsz == 0 || QUICKSORTS_KEY_DOUBLE < key)
+    engine = NULL;
+  else if (key != QUICKSORTS_KEY_COMPAR)
+    {
+      const key_engines_t *k = &key_engines[key];
+      if (elemsz < k->size)
+        engine = NULL;
+      else if (elemsz == k->size)
+        engine = k->bare;
+      else if (stable)
+        {
+          /* The buffer of the stable partitioning. */
+          engine = k->stable;
+          ok = scratch_add (&scratch_size, n + 1, elemsz);
+        }
+      else
+        {
+          /* The key-and-pointer pairs and an element, then a merge
+             buffer for sorting a run of equal keys. */
+          engine = k->keyed;
+          ok = (scratch_add (&scratch_size, n,
+                             sizeof (struct
+                                     quicksorts__unstable_sort_by_key__pair))
+                && scratch_add (&scratch_size, 1, elemsz)
+                && scratch_add (&scratch_size,
+                                merge_buffer_nmemb (n, elemsz), elemsz));
+        }
+    }
+  else if (stable)
+    {
+      engine = engine_stable;
+      ok = scratch_add (&scratch_size, n + 1, elemsz);
+    }
+  else if ((flags & QUICKSORTS_PLAN_PARALLEL) != 0)
+    {
+      /* The pool threads get their own memory. */
+      engine = engine_parallel;
+      quicksorts__unstable_qsort_parallel__start_pool ();
+    }
+  else if ((QUICKSORTS__UNSTABLE_QSORT__INDIRECT_SIZE) <= elemsz)
+    {
+      /* The pointers and an element, then a merge buffer of
+         pointers. */
+      engine = engine_indirect;
+      small_size = SMALL_SIZE_BY_ELEMSZ (sizeof (char *));
+      ok = (scratch_add (&scratch_size, n, sizeof (char *))
+            && scratch_add (&scratch_size, 1, elemsz)
+            && scratch_add (&scratch_size,
+                            merge_buffer_nmemb (n, sizeof (char *)),
+                            sizeof (char *)));
+    }
+  else
+    {
+      /* A merge buffer, or the hole of the partitioning; not both at
+         once. Elements are moved as words only where the word types
+         may alias them. */
+      switch ((QUICKSORTS_COMMON__HAVE_MAY_ALIAS) ? elemsz : 0)
+        {
+        case 4:
+          engine = engine_words4;
+          break;
+        case 8:
+          engine = engine_words8;
+          break;
+        case 16:
+          engine = engine_words16;
+          break;
+        case 24:
+          engine = engine_words24;
+          break;
+        case 32:
+          engine = engine_words32;
+          break;
+        case 64:
+          engine = engine_words64;
+          break;
+        default:
+          engine = ((QUICKSORTS__UNSTABLE_QUICKSORT__HOLE_PARTITION_SIZE)
+                    <= elemsz) ? engine_large : engine_bytes;
+          break;
+        }
+      ok = scratch_add (&scratch_size, merge_buffer_nmemb (n, elemsz) + 1,
+                        elemsz);
+    }
+
+  quicksorts_plan *plan = NULL;
+  if (engine != NULL && ok)
+    {
+      plan = malloc (sizeof (quicksorts_plan));
+      if (plan != NULL)
+        {
+          plan->engine = engine;
+          plan->elemsz = elemsz;
+          plan->small_size = small_size;
+          plan->scratch = NULL;
+          plan->scratch_size = scratch_size;
+          plan->scratch_used = 0;
+          if (scratch_size != 0)
+            {
+              plan->scratch = malloc (scratch_size);
+              if (plan->scratch == NULL)
+                {
+                  free (plan);
+                  plan = NULL;
+                }
+            }
+        }
+    }
+  return plan;
+}
+
+void
+quicksorts_plan_execute (quicksorts_plan *plan, void *base, size_t nmemb,
+                         compar_t *compar, void *arg)
+{
+  plan->scratch_used = 0;
+  plan->engine (plan, base, nmemb, compar, arg);
+}
+
+void
+quicksorts_plan_destroy (quicksorts_plan *plan)
+{
+  if (plan != NULL)
+    {
+      free (plan->scratch);
+      free (plan);
+    }
+}
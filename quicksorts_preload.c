@@ -0,0 +1,380 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  A library for LD_PRELOAD, which puts the sorts of this package in
+  place of the C library’s qsort and qsort_r in programs that were
+  never built against it:
+
+      LD_PRELOAD=/usr/local/lib/libquicksorts-preload.so program ...
+
+  It exports qsort; qsort_r, with the argument order of the C library
+  it was built for; and __qsort_r_compat, with the BSD argument order
+  (the comparison function last, taking its argument first), under
+  the name by which FreeBSD’s <stdlib.h> calls that order.
+
+  The environment, read once, chooses the sort:
+
+    QUICKSORTS_ENGINE=unstable   unstable_qsort_r (the default)
+    QUICKSORTS_ENGINE=stable     stable_qsort_r
+    QUICKSORTS_ENGINE=parallel   unstable_qsort_r_parallel
+    QUICKSORTS_ENGINE=libc       the C library’s own sort
+
+  QUICKSORTS_STABLE, set to anything but "" or "0", asks for a stable
+  sort whatever the engine.
+
+  QUICKSORTS_STATS, if set, has totals of the sorting done written at
+  exit: to standard error if it is "", "1" or "stderr", otherwise
+  appended to the file it names. Comparisons are counted, and the
+  time taken; for the unstable engine, also what the sorts moved and
+  how they partitioned.
+*/
+
+#define _GNU_SOURCE 1
+
+#include <dlfcn.h>
+#include <inttypes.h>
+#include <pthread.h>
+#include <stdatomic.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "quicksorts/stable-qsort.h"
+#include "quicksorts/unstable-qsort.h"
+#include "quicksorts/unstable-qsort-parallel.h"
+#include "quicksorts/unstable-qsort-stats.h"
+
+#ifndef QUICKSORTS_PRELOAD__BSD_QSORT_R
+#if defined __APPLE__ || defined __DragonFly__
+#define QUICKSORTS_PRELOAD__BSD_QSORT_R 1
+#elif defined __FreeBSD__
+#include <sys/param.h>
+#define QUICKSORTS_PRELOAD__BSD_QSORT_R (__FreeBSD_version < 1400000)
+#else
+#define QUICKSORTS_PRELOAD__BSD_QSORT_R 0
+#endif
+#endif
+
+#define EXPORT __attribute__ ((__visibility__ ("default")))
+
+typedef int compar_t (const void *, const void *);
+typedef int compar_r_t (const void *, const void *, void *);
+typedef int compar_bsd_t (void *, const void *, const void *);
+
+typedef enum
+{
+  ENGINE_UNSTABLE,
+  ENGINE_STABLE,
+  ENGINE_PARALLEL,
+  ENGINE_LIBC
+} engine_t;
+
+static const char *const engine_names[] = {
+  [ENGINE_UNSTABLE] = "unstable",
+  [ENGINE_STABLE] = "stable",
+  [ENGINE_PARALLEL] = "parallel",
+  [ENGINE_LIBC] = "libc"
+};
+
+static pthread_once_t config_once = PTHREAD_ONCE_INIT;
+static engine_t engine = ENGINE_UNSTABLE;
+static const char *stats_file = NULL;
+static void (*libc_qsort) (void *, size_t, size_t, compar_t *) = NULL;
+static void (*libc_qsort_r) (void *, size_t, size_t, compar_r_t *,
+                             void *) = NULL;
+
+/* Totals, kept if stats_file is not NULL. Guarded by totals_lock. */
+static pthread_mutex_t totals_lock = PTHREAD_MUTEX_INITIALIZER;
+static uint64_t total_calls = 0;
+static uint64_t total_elements = 0;
+static struct unstable_qsort_stats totals;
+
+static void write_stats (void);
+
+static void
+configure (void)
+{
+  const char *s = getenv ("QUICKSORTS_ENGINE");
+  if (s != NULL)
+    for (size_t i = 0; i != sizeof engine_names / sizeof engine_names[0];
+         i += 1)
+      if (strcmp (s, engine_names[i]) == 0)
+        engine = (engine_t) i;
+
+  s = getenv ("QUICKSORTS_STABLE");
+  if (s != NULL && s[0] != '\0' && strcmp (s, "0") != 0)
+    engine = ENGINE_STABLE;
+
+  if (engine == ENGINE_LIBC)
+    {
+      /* The next definitions after this library’s own. */
+      *(void **) &libc_qsort = dlsym (RTLD_NEXT, "qsort");
+      *(void **) &libc_qsort_r = dlsym (RTLD_NEXT, "qsort_r");
+      if (libc_qsort == NULL || libc_qsort_r == NULL)
+        engine = ENGINE_UNSTABLE;
+    }
+
+  stats_file = getenv ("QUICKSORTS_STATS");
+  if (stats_file != NULL)
+    {
+      memset (&totals, 0, sizeof totals);
+      atexit (write_stats);
+    }
+}
+
+static uint64_t
+now_ns (void)
+{
+  struct timespec t;
+  clock_gettime (CLOCK_MONOTONIC, &t);
+  return ((uint64_t) t.tv_sec * UINT64_C (1000000000)) + t.tv_nsec;
+}
+
+static void
+write_stats (void)
+{
+  FILE *f = stderr;
+  if (stats_file[0] != '\0' && strcmp (stats_file, "1") != 0
+      && strcmp (stats_file, "stderr") != 0)
+    f = fopen (stats_file, "a");
+  if (f != NULL)
+    {
+      pthread_mutex_lock (&totals_lock);
+      fprintf (f, "quicksorts: %s engine: %" PRIu64 " calls, %" PRIu64
+               " elements, %" PRIu64 " comparisons, %.6f s\n",
+               engine_names[engine], total_calls, total_elements,
+               totals.lt_calls, totals.total_ns * 1e-9);
+      if (engine == ENGINE_UNSTABLE)
+        {
+          fprintf (f, "quicksorts: %" PRIu64 " swaps, %" PRIu64
+                   " bytes moved, %" PRIu64 " partitions, %" PRIu64
+                   " heap sorts, %" PRIu64 " small sorts\n",
+                   totals.swaps, totals.bytes_moved, totals.partitions,
+                   totals.heap_sorts, totals.small_sorts);
+          fprintf (f, "quicksorts: partition balance:");
+          for (size_t i = 0; i != UNSTABLE_QSORT_STATS_IMBALANCE_BINS;
+               i += 1)
+            fprintf (f, " %" PRIu64, totals.imbalance[i]);
+          fprintf (f, "\n");
+        }
+      pthread_mutex_unlock (&totals_lock);
+      if (f != stderr)
+        fclose (f);
+    }
+}
+
+static void
+add_stats (size_t nmemb, const struct unstable_qsort_stats *stats)
+{
+  pthread_mutex_lock (&totals_lock);
+  total_calls += 1;
+  total_elements += nmemb;
+  totals.lt_calls += stats->lt_calls;
+  totals.swaps += stats->swaps;
+  totals.bytes_moved += stats->bytes_moved;
+  totals.partitions += stats->partitions;
+  totals.heap_sorts += stats->heap_sorts;
+  totals.small_sorts += stats->small_sorts;
+  totals.small_sort_elements += stats->small_sort_elements;
+  totals.small_sort_ns += stats->small_sort_ns;
+  totals.total_ns += stats->total_ns;
+  for (size_t i = 0; i != UNSTABLE_QSORT_STATS_IMBALANCE_BINS; i += 1)
+    totals.imbalance[i] += stats->imbalance[i];
+  if (totals.max_stack_depth < stats->max_stack_depth)
+    totals.max_stack_depth = stats->max_stack_depth;
+  pthread_mutex_unlock (&totals_lock);
+}
+
+/* Every call comes here, in the argument order of qsort_r. A qsort
+   comparison function is called through call_compar, with itself as
+   the argument. The parallel engine calls from several threads at
+   once, so the count is atomic. */
+
+typedef struct
+{
+  compar_r_t *compar;
+  void *arg;
+  atomic_uint_least64_t count;
+} counted_t;
+
+static int
+call_counted (const void *x, const void *y, void *arg)
+{
+  counted_t *c = arg;
+  atomic_fetch_add_explicit (&c->count, 1, memory_order_relaxed);
+  return c->compar (x, y, c->arg);
+}
+
+static int
+call_compar (const void *x, const void *y, void *arg)
+{
+  return (*(compar_t **) arg) (x, y);
+}
+
+#if QUICKSORTS_PRELOAD__BSD_QSORT_R
+
+/* The C library’s qsort_r takes its arguments in the BSD order. */
+
+typedef struct
+{
+  compar_r_t *compar;
+  void *arg;
+} gnu_t;
+
+static int
+call_gnu (void *thunk, const void *x, const void *y)
+{
+  const gnu_t *g = thunk;
+  return g->compar (x, y, g->arg);
+}
+
+static void
+call_libc_qsort_r (void *base, size_t nmemb, size_t size,
+                   compar_r_t *compar, void *arg)
+{
+  gnu_t g = { .compar = compar, .arg = arg };
+  void (*f) (void *, size_t, size_t, void *, compar_bsd_t *);
+  *(void **) &f = *(void **) &libc_qsort_r;
+  f (base, nmemb, size, &g, call_gnu);
+}
+
+#else
+
+static void
+call_libc_qsort_r (void *base, size_t nmemb, size_t size,
+                   compar_r_t *compar, void *arg)
+{
+  libc_qsort_r (base, nmemb, size, compar, arg);
+}
+
+#endif
+
+static void
+sort (void *base, size_t nmemb, size_t size, compar_r_t *compar,
+      void *arg)
+{
+  switch (engine)
+    {
+    case ENGINE_STABLE:
+      stable_qsort_r (base, nmemb, size, compar, arg);
+      break;
+    case ENGINE_PARALLEL:
+      unstable_qsort_r_parallel (base, nmemb, size, compar, arg);
+      break;
+    case ENGINE_LIBC:
+      call_libc_qsort_r (base, nmemb, size, compar, arg);
+      break;
+    default:
+      unstable_qsort_r (base, nmemb, size, compar, arg);
+      break;
+    }
+}
+
+static void
+sort_with_stats (void *base, size_t nmemb, size_t size,
+                 compar_r_t *compar, void *arg)
+{
+  struct unstable_qsort_stats stats;
+  if (engine == ENGINE_UNSTABLE)
+    unstable_qsort_r_stats (base, nmemb, size, compar, arg, &stats);
+  else
+    {
+      counted_t counted = { .compar = compar, .arg = arg };
+      atomic_init (&counted.count, 0);
+      memset (&stats, 0, sizeof stats);
+      const uint64_t t0 = now_ns ();
+      sort (base, nmemb, size, call_counted, &counted);
+      stats.total_ns = now_ns () - t0;
+      stats.lt_calls =
+        atomic_load_explicit (&counted.count, memory_order_relaxed);
+    }
+  add_stats (nmemb, &stats);
+}
+
+EXPORT void
+qsort (void *base, size_t nmemb, size_t size, compar_t *compar)
+{
+  pthread_once (&config_once, configure);
+  if (stats_file != NULL)
+    sort_with_stats (base, nmemb, size, call_compar, &compar);
+  else if (engine == ENGINE_LIBC)
+    libc_qsort (base, nmemb, size, compar);
+  else
+    sort (base, nmemb, size, call_compar, &compar);
+}
+
+static void
+qsort_r_gnu (void *base, size_t nmemb, size_t size, compar_r_t *compar,
+             void *arg)
+{
+  pthread_once (&config_once, configure);
+  if (stats_file != NULL)
+    sort_with_stats (base, nmemb, size, compar, arg);
+  else
+    sort (base, nmemb, size, compar, arg);
+}
+
+typedef struct
+{
+  compar_bsd_t *compar;
+  void *thunk;
+} bsd_t;
+
+static int
+call_bsd (const void *x, const void *y, void *arg)
+{
+  const bsd_t *b = arg;
+  return b->compar (b->thunk, x, y);
+}
+
+static void
+qsort_r_bsd (void *base, size_t nmemb, size_t size, void *thunk,
+             compar_bsd_t *compar)
+{
+  bsd_t b = { .compar = compar, .thunk = thunk };
+  qsort_r_gnu (base, nmemb, size, call_bsd, &b);
+}
+
+#if QUICKSORTS_PRELOAD__BSD_QSORT_R
+
+EXPORT void
+qsort_r (void *base, size_t nmemb, size_t size, void *thunk,
+         compar_bsd_t *compar)
+{
+  qsort_r_bsd (base, nmemb, size, thunk, compar);
+}
+
+#else
+
+EXPORT void
+qsort_r (void *base, size_t nmemb, size_t size, compar_r_t *compar,
+         void *arg)
+{
+  qsort_r_gnu (base, nmemb, size, compar, arg);
+}
+
+#endif
+
+EXPORT void
+__qsort_r_compat (void *base, size_t nmemb, size_t size, void *thunk,
+                  compar_bsd_t *compar)
+{
+  qsort_r_bsd (base, nmemb, size, thunk, compar);
+}
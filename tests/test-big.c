@@ -22,7 +22,10 @@
 #include <stdint.h>
 #include <string.h>
 #include <time.h>
+#include "quicksorts/stable-quicksort.h"
+#include "quicksorts/unstable-qsort.h"
 #include "quicksorts/unstable-quicksort.h"
+#include "quicksorts/unstable-sort-by-key.h"
 
 #define MAX_SZ 10000ULL
 
@@ -105,6 +108,15 @@ unstable_median3_insertion_big (void *base, size_t nmemb)
      80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT);
 }
 
+static void
+unstable_adaptive_insertion_big (void *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_7ARGS
+    (base, nmemb, BIG_SIZE, string_lt,
+     QUICKSORTS_COMMON__PIVOT_ADAPTIVE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT);
+}
+
 static void
 unstable_random_shell_big (void *base, size_t nmemb)
 {
@@ -123,6 +135,74 @@ unstable_median3_shell_big (void *base, size_t nmemb)
      350, QUICKSORTS__UNSTABLE_QUICKSORT__SHELL_SORT);
 }
 
+static void
+unstable_median3_insertion_3way_big (void *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_8ARGS
+    (base, nmemb, BIG_SIZE, string_lt,
+     QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT,
+     QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_THREE_WAY);
+}
+
+static void
+unstable_adaptive_insertion_hole_big (void *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_8ARGS
+    (base, nmemb, BIG_SIZE, string_lt,
+     QUICKSORTS_COMMON__PIVOT_ADAPTIVE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT,
+     QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_HOLE);
+}
+
+static void
+unstable_pdq_median3_insertion_big (void *base, size_t nmemb)
+{
+  UNSTABLE_PDQSORT_8ARGS
+    (base, nmemb, BIG_SIZE, string_lt,
+     QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT,
+     QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION);
+}
+
+static void
+stable_median3_insertion_big (void *base, size_t nmemb)
+{
+  STABLE_QUICKSORT_7ARGS
+    (base, nmemb, BIG_SIZE, string_lt,
+     QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE,
+     40, QUICKSORTS__STABLE_QUICKSORT__INSERTION_SORT);
+}
+
+/* How many times string_prefix_key has been called. */
+static size_t key_calls = 0;
+
+/* The first eight bytes of a string, in big-endian order. */
+static inline uint64_t
+string_prefix_key (const void *x)
+{
+  key_calls += 1;
+  const unsigned char *s = x;
+  uint64_t key = 0;
+  bool ended = false;
+  for (size_t i = 0; i != 8; i += 1)
+    {
+      ended = ended || (s[i] == '\0');
+      key = (key << 8) | (ended ? 0 : s[i]);
+    }
+  return key;
+}
+
+static void
+unstable_sort_by_key_big (void *base, size_t nmemb)
+{
+  key_calls = 0;
+  UNSTABLE_SORT_BY_KEY (base, nmemb, BIG_SIZE, string_prefix_key,
+                        string_lt);
+  /* Each key is computed once. */
+  CHECK (key_calls == ((nmemb < 2) ? 0 : nmemb));
+}
+
 static void
 test_arrays (sortkind_t sortkind)
 {
@@ -178,6 +258,53 @@ test_arrays (sortkind_t sortkind)
           unstable_median3_shell_big (p3, sz);
           t32 = get_clock ();
         }
+      else if (sortkind_eq (sortkind,
+                            "unstable-median3-insertion-3way-big"))
+        {
+          t31 = get_clock ();
+          unstable_median3_insertion_3way_big (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind,
+                            "unstable-adaptive-insertion-hole-big"))
+        {
+          t31 = get_clock ();
+          unstable_adaptive_insertion_hole_big (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind,
+                            "unstable-pdq-median3-insertion-big"))
+        {
+          t31 = get_clock ();
+          unstable_pdq_median3_insertion_big (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "stable-median3-insertion-big"))
+        {
+          t31 = get_clock ();
+          stable_median3_insertion_big (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable-adaptive-insertion-big"))
+        {
+          t31 = get_clock ();
+          unstable_adaptive_insertion_big (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable_qsort-big"))
+        {
+          /* Elements this big are sorted indirectly. */
+          t31 = get_clock ();
+          unstable_qsort (p3, sz, BIG_SIZE,
+                          (int (*) (const void *, const void *)) strcmp);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable-sort-by-key-big"))
+        {
+          t31 = get_clock ();
+          unstable_sort_by_key_big (p3, sz);
+          t32 = get_clock ();
+        }
       else
         {
           printf ("Invalid command-line argument.\n");
@@ -0,0 +1,199 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "quicksorts/unstable-external-sort.h"
+
+#if __GNUC__
+#define STRCMP __builtin_strcmp
+#else
+#define STRCMP strcmp
+#endif
+
+typedef const char *sortkind_t;
+#define sortkind_eq(A, B) (STRCMP ((A), (B)) == 0)
+
+#define CHECK(expr)                             \
+  if (expr)                                     \
+    {}                                          \
+  else                                          \
+    check_failed (__FILE__, __LINE__)
+
+static void
+check_failed (const char *file, unsigned int line)
+{
+  fprintf (stderr, "CHECK failed at %s:%u\n", file, line);
+  exit (1);
+}
+
+long double
+get_clock (void)
+{
+  return ((long double) clock ()) / CLOCKS_PER_SEC;
+}
+
+/* The sequence numbers are unique, so the order is total and the
+   result can be compared with qsort's. */
+typedef struct
+{
+  uint32_t key;
+  uint32_t seq;
+  char payload[32];
+} record_t;
+
+static int
+record_cmp (const void *px, const void *py)
+{
+  const record_t *x = px;
+  const record_t *y = py;
+  if (x->key != y->key)
+    return (x->key < y->key) ? -1 : 1;
+  return (x->seq < y->seq) ? -1 : ((y->seq < x->seq) ? 1 : 0);
+}
+
+static int
+record_cmp_r (const void *px, const void *py, void *arg)
+{
+  *(size_t *) arg += 1;
+  return record_cmp (px, py);
+}
+
+static void
+initialize (record_t *p, size_t n, int pattern)
+{
+  for (size_t i = 0; i != n; i += 1)
+    {
+      switch (pattern)
+        {
+        case 0:
+          p[i].key = (uint32_t) lrand48 ();
+          break;
+        case 1:
+          p[i].key = (uint32_t) (lrand48 () % 5);
+          break;
+        default:
+          p[i].key = (uint32_t) (n - i);
+          break;
+        }
+      p[i].seq = (uint32_t) i;
+      memset (p[i].payload, (int) (p[i].key ^ i), sizeof p[i].payload);
+    }
+}
+
+static void
+test_external_sort (bool reentrant,
+                    const struct unstable_external_sort_config *config)
+{
+  const size_t sizes[] = { 0, 1, 2, 819, 820, 1639, 5000, 200000 };
+  const size_t max_sz = 200000;
+  record_t *p1 = malloc (max_sz * sizeof (record_t));
+  record_t *p2 = malloc (max_sz * sizeof (record_t));
+
+  for (int pattern = 0; pattern != 3; pattern += 1)
+    for (size_t j = 0; j != sizeof sizes / sizeof sizes[0]; j += 1)
+      {
+        const size_t sz = sizes[j];
+        initialize (p1, sz, pattern);
+
+        FILE *in = tmpfile ();
+        FILE *out = tmpfile ();
+        CHECK (in != NULL && out != NULL);
+        CHECK (fwrite (p1, sizeof (record_t), sz, in) == sz);
+        rewind (in);
+
+        const long double t1 = get_clock ();
+        qsort (p1, sz, sizeof (record_t), record_cmp);
+        const long double t2 = get_clock ();
+        size_t count = 0;
+        if (reentrant)
+          CHECK (unstable_external_sort_r (in, out, sizeof (record_t),
+                                           record_cmp_r, &count,
+                                           config) == 0);
+        else
+          CHECK (unstable_external_sort (in, out, sizeof (record_t),
+                                         record_cmp, config) == 0);
+        const long double t3 = get_clock ();
+        CHECK (!reentrant || sz < 2 || count != 0);
+
+        rewind (out);
+        CHECK (fread (p2, sizeof (record_t), sz, out) == sz);
+        CHECK (fgetc (out) == EOF);
+        CHECK (memcmp (p1, p2, sz * sizeof (record_t)) == 0);
+        printf ("  qsort:%Lf  ours:%Lf  %zu\n", t2 - t1, t3 - t2, sz);
+
+        fclose (in);
+        fclose (out);
+      }
+
+  /* A partial record at the end is an error. */
+  FILE *in = tmpfile ();
+  FILE *out = tmpfile ();
+  CHECK (in != NULL && out != NULL);
+  initialize (p1, 1000, 0);
+  CHECK (fwrite (p1, 1, 1000 * sizeof (record_t) - 1, in)
+         == 1000 * sizeof (record_t) - 1);
+  rewind (in);
+  errno = 0;
+  CHECK (unstable_external_sort (in, out, sizeof (record_t), record_cmp,
+                                 config) == -1);
+  CHECK (errno == EINVAL);
+  fclose (in);
+  fclose (out);
+
+  free (p1);
+  free (p2);
+}
+
+int
+main (int argc, char *argv[])
+{
+  if (argc <= 1)
+    {
+      printf ("This program expects a command-line argument.\n");
+      exit (1);
+    }
+  sortkind_t sortkind = argv[1];
+
+  /* Chunks of 819 records, merged four at a time, so the larger
+     inputs take several merge passes. */
+  const struct unstable_external_sort_config small = {
+    .memory = 2 * 819 * sizeof (record_t),
+    .tmpdir = NULL,
+    .fan_in = 4
+  };
+
+  if (sortkind_eq (sortkind, "external-sort"))
+    test_external_sort (false, &small);
+  else if (sortkind_eq (sortkind, "external-sort_r"))
+    test_external_sort (true, &small);
+  else if (sortkind_eq (sortkind, "external-sort-defaults"))
+    test_external_sort (false, NULL);
+  else
+    {
+      printf ("Invalid command-line argument.\n");
+      exit (1);
+    }
+
+  return 0;
+}
@@ -17,11 +17,16 @@
 */
 
 #include <stdio.h>
+#include <stdbool.h>
 #include <stdlib.h>
 #include <stdint.h>
 #include <string.h>
 #include <time.h>
+#include "quicksorts/stable-qsort.h"
+#include "quicksorts/stable-quicksort.h"
 #include "quicksorts/unstable-qsort.h"
+#include "quicksorts/unstable-qsort-parallel.h"
+#include "quicksorts/unstable-qsort-stats.h"
 #include "quicksorts/unstable-quicksort.h"
 
 #define MAX_SZ 10000000ULL
@@ -100,6 +105,40 @@ int_lt (const void *px, const void *py)
   return (*(const int *) px < *(const int *) py);
 }
 
+/* A key that leaves the low bits to the comparison function. */
+static uint64_t
+coarse_int_key (const void *px)
+{
+  return (((uint32_t) *(const int *) px) ^ UINT32_C (0x80000000)) >> 8;
+}
+
+/* The statistics must add up, and agree with what was sorted. */
+static void
+check_stats (const struct unstable_qsort_stats *stats, size_t nmemb)
+{
+  uint64_t binned = 0;
+  for (size_t i = 0; i != UNSTABLE_QSORT_STATS_IMBALANCE_BINS; i += 1)
+    binned += stats->imbalance[i];
+  CHECK (binned == stats->partitions);
+  CHECK (stats->small_sort_elements <= nmemb);
+  CHECK (stats->small_sort_ns <= stats->total_ns);
+  CHECK (stats->bytes_moved % sizeof (int) == 0);
+  CHECK (stats->swaps * 2 * sizeof (int) <= stats->bytes_moved);
+  if (nmemb < 2)
+    CHECK (stats->lt_calls == 0 && stats->small_sorts == 0);
+  else
+    CHECK (nmemb - 1 <= stats->lt_calls);
+  if (nmemb <= QUICKSORTS_TUNED__SMALL_SIZE_BY_ELEMSZ (sizeof (int)))
+    CHECK (stats->partitions == 0 && stats->max_stack_depth == 0);
+  else
+    {
+      /* Unless it was sorted or merged from runs. */
+      CHECK ((stats->partitions == 0) == (stats->max_stack_depth == 0));
+      CHECK ((stats->partitions == 0)
+             == (stats->small_sorts + stats->heap_sorts == 0));
+    }
+}
+
 static void
 unstable_defaults (void *base, size_t nmemb)
 {
@@ -166,6 +205,24 @@ unstable_median3_insertion_typed (void *base, size_t nmemb)
      80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED);
 }
 
+static void
+unstable_adaptive_insertion (void *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_7ARGS
+    (base, nmemb, sizeof (int), int_lt,
+     QUICKSORTS_COMMON__PIVOT_ADAPTIVE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT);
+}
+
+static void
+unstable_adaptive_insertion_typed (void *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_TYPED_7ARGS
+    (int, base, nmemb, int_lt,
+     QUICKSORTS_COMMON__PIVOT_ADAPTIVE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED);
+}
+
 static void
 unstable_random_shell (void *base, size_t nmemb)
 {
@@ -220,6 +277,148 @@ unstable_median3_shell_typed (void *base, size_t nmemb)
      350, QUICKSORTS__UNSTABLE_QUICKSORT__SHELL_SORT__TYPED);
 }
 
+static void
+unstable_median3_insertion_3way (void *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_8ARGS
+    (base, nmemb, sizeof (int), int_lt,
+     QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT,
+     QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_THREE_WAY);
+}
+
+static void
+unstable_median3_insertion_3way_typed (void *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_TYPED_8ARGS
+    (int, base, nmemb, int_lt,
+     QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED,
+     QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_THREE_WAY__TYPED);
+}
+
+/* Always choosing the first element as pivot is quadratic on
+   pre-sorted input, unless the depth limit takes over. */
+#define PIVOT_FIRST(BASE, NMEMB, SIZE, LT, RESULT)  \
+  do                                                \
+    {                                               \
+      RESULT = (size_t) 0;                          \
+    }                                               \
+  while (0)
+
+static void
+unstable_first_insertion (void *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_7ARGS
+    (base, nmemb, sizeof (int), int_lt, PIVOT_FIRST,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT);
+}
+
+static void
+unstable_first_insertion_typed (void *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_TYPED_7ARGS
+    (int, base, nmemb, int_lt, PIVOT_FIRST,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED);
+}
+
+static void
+unstable_median3_heap (void *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_7ARGS
+    (base, nmemb, sizeof (int), int_lt,
+     QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__HEAP_SORT);
+}
+
+static void
+unstable_median3_heap_typed (void *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_TYPED_7ARGS
+    (int, base, nmemb, int_lt,
+     QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__HEAP_SORT__TYPED);
+}
+
+static void
+unstable_pdq_median3_insertion (void *base, size_t nmemb)
+{
+  UNSTABLE_PDQSORT_8ARGS
+    (base, nmemb, sizeof (int), int_lt,
+     QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT,
+     QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION);
+}
+
+static void
+unstable_pdq_median3_insertion_typed (void *base, size_t nmemb)
+{
+  UNSTABLE_PDQSORT_TYPED_8ARGS
+    (int, base, nmemb, int_lt,
+     QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED,
+     QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION__TYPED);
+}
+
+static void
+unstable_median3_insertion_block_typed (void *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_TYPED_8ARGS
+    (int, base, nmemb, int_lt,
+     QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED,
+     QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_BLOCK__TYPED);
+}
+
+static void
+unstable_median3_network (void *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_7ARGS
+    (base, nmemb, sizeof (int), int_lt,
+     QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE,
+     64, QUICKSORTS__UNSTABLE_QUICKSORT__NETWORK_SORT);
+}
+
+static void
+unstable_median3_network_typed (void *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_TYPED_7ARGS
+    (int, base, nmemb, int_lt,
+     QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE,
+     64, QUICKSORTS__UNSTABLE_QUICKSORT__NETWORK_SORT__TYPED);
+}
+
+static void
+stable_defaults (void *base, size_t nmemb)
+{
+  STABLE_QUICKSORT (base, nmemb, sizeof (int), int_lt);
+}
+
+static void
+stable_defaults_typed (void *base, size_t nmemb)
+{
+  STABLE_QUICKSORT_TYPED (int, base, nmemb, int_lt);
+}
+
+static void
+stable_first_insertion (void *base, size_t nmemb)
+{
+  STABLE_QUICKSORT_7ARGS
+    (base, nmemb, sizeof (int), int_lt, PIVOT_FIRST,
+     40, QUICKSORTS__STABLE_QUICKSORT__INSERTION_SORT);
+}
+
+static void
+stable_first_insertion_typed (void *base, size_t nmemb)
+{
+  STABLE_QUICKSORT_TYPED_7ARGS
+    (int, base, nmemb, int_lt, PIVOT_FIRST,
+     40, QUICKSORTS__STABLE_QUICKSORT__INSERTION_SORT__TYPED);
+}
+
+UNSTABLE_QUICKSORT_PARALLEL_TYPED_DEFINE (unstable_parallel_typed, int,
+                                          int_lt)
+
 static void
 test_arrays_with_int_keys (sortkind_t sortkind,
                            void (*init) (size_t i, int *x))
@@ -265,6 +464,26 @@ test_arrays_with_int_keys (sortkind_t sortkind,
           unstable_qsort_r (p3, sz, sizeof (int), intcmp_r, env);
           t32 = get_clock ();
         }
+      else if (sortkind_eq (sortkind, "unstable_qsort_parallel"))
+        {
+          t31 = get_clock ();
+          unstable_qsort_parallel (p3, sz, sizeof (int), intcmp);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable_qsort_r_parallel"))
+        {
+          int env_val = 1234;
+          void *env = &env_val;
+          t31 = get_clock ();
+          unstable_qsort_r_parallel (p3, sz, sizeof (int), intcmp_r, env);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable-parallel-typed"))
+        {
+          t31 = get_clock ();
+          unstable_parallel_typed (p3, sz);
+          t32 = get_clock ();
+        }
       else if (sortkind_eq (sortkind, "unstable-defaults"))
         {
           t31 = get_clock ();
@@ -349,6 +568,165 @@ test_arrays_with_int_keys (sortkind_t sortkind,
           unstable_median3_shell_typed (p3, sz);
           t32 = get_clock ();
         }
+      else if (sortkind_eq (sortkind, "unstable-median3-insertion-3way"))
+        {
+          t31 = get_clock ();
+          unstable_median3_insertion_3way (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind,
+                            "unstable-median3-insertion-3way-typed"))
+        {
+          t31 = get_clock ();
+          unstable_median3_insertion_3way_typed (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable-first-insertion"))
+        {
+          t31 = get_clock ();
+          unstable_first_insertion (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable-first-insertion-typed"))
+        {
+          t31 = get_clock ();
+          unstable_first_insertion_typed (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable-median3-heap"))
+        {
+          t31 = get_clock ();
+          unstable_median3_heap (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable-median3-heap-typed"))
+        {
+          t31 = get_clock ();
+          unstable_median3_heap_typed (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable-pdq-median3-insertion"))
+        {
+          t31 = get_clock ();
+          unstable_pdq_median3_insertion (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind,
+                            "unstable-pdq-median3-insertion-typed"))
+        {
+          t31 = get_clock ();
+          unstable_pdq_median3_insertion_typed (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind,
+                            "unstable-median3-insertion-block-typed"))
+        {
+          t31 = get_clock ();
+          unstable_median3_insertion_block_typed (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable-median3-network"))
+        {
+          t31 = get_clock ();
+          unstable_median3_network (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable-median3-network-typed"))
+        {
+          t31 = get_clock ();
+          unstable_median3_network_typed (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "stable_qsort"))
+        {
+          t31 = get_clock ();
+          stable_qsort (p3, sz, sizeof (int), intcmp);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "stable_qsort_r"))
+        {
+          int env_val = 1234;
+          void *env = &env_val;
+          t31 = get_clock ();
+          stable_qsort_r (p3, sz, sizeof (int), intcmp_r, env);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "stable-defaults"))
+        {
+          t31 = get_clock ();
+          stable_defaults (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "stable-defaults-typed"))
+        {
+          t31 = get_clock ();
+          stable_defaults_typed (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "stable-first-insertion"))
+        {
+          t31 = get_clock ();
+          stable_first_insertion (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "stable-first-insertion-typed"))
+        {
+          t31 = get_clock ();
+          stable_first_insertion_typed (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable-adaptive-insertion"))
+        {
+          t31 = get_clock ();
+          unstable_adaptive_insertion (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable-adaptive-insertion-typed"))
+        {
+          t31 = get_clock ();
+          unstable_adaptive_insertion_typed (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable_qsort_indirect"))
+        {
+          t31 = get_clock ();
+          unstable_qsort_indirect (p3, sz, sizeof (int), intcmp);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable_qsort_r_indirect"))
+        {
+          int env_val = 1234;
+          void *env = &env_val;
+          t31 = get_clock ();
+          unstable_qsort_r_indirect (p3, sz, sizeof (int), intcmp_r, env);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable_qsort_stats"))
+        {
+          struct unstable_qsort_stats stats;
+          t31 = get_clock ();
+          unstable_qsort_stats (p3, sz, sizeof (int), intcmp, &stats);
+          t32 = get_clock ();
+          check_stats (&stats, sz);
+        }
+      else if (sortkind_eq (sortkind, "unstable_qsort_r_stats"))
+        {
+          int env_val = 1234;
+          void *env = &env_val;
+          struct unstable_qsort_stats stats;
+          t31 = get_clock ();
+          unstable_qsort_r_stats (p3, sz, sizeof (int), intcmp_r, env,
+                                  &stats);
+          t32 = get_clock ();
+          check_stats (&stats, sz);
+        }
+      else if (sortkind_eq (sortkind, "unstable_qsort_by_key"))
+        {
+          t31 = get_clock ();
+          unstable_qsort_by_key (p3, sz, sizeof (int), coarse_int_key,
+                                 intcmp);
+          t32 = get_clock ();
+        }
       else
         {
           printf ("Invalid command-line argument.\n");
@@ -417,6 +795,30 @@ test_reverse_presorted_arrays_with_int_keys (sortkind_t sortkind)
   test_arrays_with_int_keys (sortkind, init_with_neg_of_index);
 }
 
+/* Runs from one power of 4 up to the next, alternately ascending and
+   descending, over overlapping ranges of values. There are few enough
+   of them to be merged, at any size. */
+static void
+init_with_runs_of_growing_length (size_t i, int *x)
+{
+  size_t start = 1;
+  int n_runs = 1;
+  while (start <= i / 4)
+    {
+      start *= 4;
+      n_runs += 1;
+    }
+  const int offset = (i < start) ? 0 : (int) (i - start);
+  *x = ((n_runs & 1) == 1) ? offset : -offset;
+}
+
+static void
+test_runs_arrays_with_int_keys (sortkind_t sortkind)
+{
+  printf ("Arrays of sorted runs:\n");
+  test_arrays_with_int_keys (sortkind, init_with_runs_of_growing_length);
+}
+
 static void
 init_with_sign_reversing_random_ints (size_t i, int *x)
 {
@@ -459,6 +861,176 @@ test_sign_reversal_constant_arrays_with_int_keys (sortkind_t sortkind)
     (sortkind, init_with_a_sign_reversing_constant_int);
 }
 
+/* For the stable sorts: sort on the high bits only, and check that
+   the low bits, the original positions, stay in increasing order
+   among equal keys. */
+
+#define STABILITY_MAX_SZ 65536
+
+static int
+keycmp (const void *px, const void *py)
+{
+  const int x = *((const int *) px) >> 16;
+  const int y = *((const int *) py) >> 16;
+  return ((x < y) ? -1 : ((x > y) ? 1 : 0));
+}
+
+static int
+keycmp_r (const void *px, const void *py, void *env)
+{
+  CHECK (*(int *) env == 1234);
+  return keycmp (px, py);
+}
+
+static inline int
+key_lt (const void *px, const void *py)
+{
+  return ((*(const int *) px >> 16) < (*(const int *) py >> 16));
+}
+
+static bool
+sort_by_key (sortkind_t sortkind, int *p, size_t sz)
+{
+  bool sorted = true;
+  if (sortkind_eq (sortkind, "stable_qsort"))
+    stable_qsort (p, sz, sizeof (int), keycmp);
+  else if (sortkind_eq (sortkind, "stable_qsort_r"))
+    {
+      int env_val = 1234;
+      stable_qsort_r (p, sz, sizeof (int), keycmp_r, &env_val);
+    }
+  else if (sortkind_eq (sortkind, "stable-defaults"))
+    STABLE_QUICKSORT (p, sz, sizeof (int), key_lt);
+  else if (sortkind_eq (sortkind, "stable-defaults-typed"))
+    STABLE_QUICKSORT_TYPED (int, p, sz, key_lt);
+  else if (sortkind_eq (sortkind, "stable-first-insertion"))
+    STABLE_QUICKSORT_7ARGS
+      (p, sz, sizeof (int), key_lt, PIVOT_FIRST,
+       40, QUICKSORTS__STABLE_QUICKSORT__INSERTION_SORT);
+  else if (sortkind_eq (sortkind, "stable-first-insertion-typed"))
+    STABLE_QUICKSORT_TYPED_7ARGS
+      (int, p, sz, key_lt, PIVOT_FIRST,
+       40, QUICKSORTS__STABLE_QUICKSORT__INSERTION_SORT__TYPED);
+  else
+    sorted = false;
+  return sorted;
+}
+
+static void
+test_stability_with_int_keys (sortkind_t sortkind)
+{
+  int *p = malloc (STABILITY_MAX_SZ * sizeof (int));
+
+  for (size_t sz = 0; sz <= STABILITY_MAX_SZ; sz = MAX (1, 4 * sz))
+    for (int pattern = 0; pattern != 3; pattern += 1)
+      {
+        for (size_t i = 0; i != sz; i += 1)
+          {
+            const int key =
+              (pattern == 0) ? random_int (0, 99) :
+              (pattern == 1) ? (int) (i / 3) : (int) ((sz - i) / 3);
+            p[i] = (key << 16) | (int) i;
+          }
+        if (!sort_by_key (sortkind, p, sz))
+          {
+            free (p);
+            return;
+          }
+        for (size_t i = 1; i < sz; i += 1)
+          CHECK (p[i - 1] < p[i]);
+      }
+  printf ("Stability: OK\n");
+
+  free (p);
+}
+
+/* For unstable_qsort and the like: sort records of various sizes,
+   some of them misaligned, on an int key at the front, and check
+   that each record moved whole. */
+
+#define RECORDS_MAX_SZ 3000
+
+static int
+recordcmp (const void *px, const void *py)
+{
+  int x;
+  int y;
+  memcpy (&x, px, sizeof x);
+  memcpy (&y, py, sizeof y);
+  return ((x < y) ? -1 : ((x > y) ? 1 : 0));
+}
+
+static int
+recordcmp_r (const void *px, const void *py, void *env)
+{
+  CHECK (*(int *) env == 1234);
+  return recordcmp (px, py);
+}
+
+static bool
+sort_records (sortkind_t sortkind, char *p, size_t sz, size_t size)
+{
+  bool sorted = true;
+  int env_val = 1234;
+  struct unstable_qsort_stats stats;
+  if (sortkind_eq (sortkind, "unstable_qsort"))
+    unstable_qsort (p, sz, size, recordcmp);
+  else if (sortkind_eq (sortkind, "unstable_qsort_r"))
+    unstable_qsort_r (p, sz, size, recordcmp_r, &env_val);
+  else if (sortkind_eq (sortkind, "unstable_qsort_stats"))
+    unstable_qsort_stats (p, sz, size, recordcmp, &stats);
+  else if (sortkind_eq (sortkind, "unstable_qsort_r_stats"))
+    unstable_qsort_r_stats (p, sz, size, recordcmp_r, &env_val, &stats);
+  else
+    sorted = false;
+  return sorted;
+}
+
+static void
+test_record_sizes (sortkind_t sortkind)
+{
+  static const size_t sizes[] = {
+    4, 5, 8, 12, 16, 24, 32, 40, 64, 72, 136, 300
+  };
+  static const size_t offsets[] = { 0, 1, 4 };
+  char *buf = malloc ((RECORDS_MAX_SZ * 300) + 8);
+
+  for (size_t k = 0; k != sizeof sizes / sizeof sizes[0]; k += 1)
+    for (size_t m = 0; m != sizeof offsets / sizeof offsets[0]; m += 1)
+      for (size_t sz = 0; sz <= RECORDS_MAX_SZ; sz = MAX (1, 7 * sz))
+        {
+          const size_t size = sizes[k];
+          char *p = buf + offsets[m];
+          for (size_t i = 0; i != sz; i += 1)
+            {
+              const int key = random_int (0, 99);
+              memcpy (p + (i * size), &key, sizeof key);
+              for (size_t j = sizeof key; j != size; j += 1)
+                p[(i * size) + j] = (char) (key + j);
+            }
+          if (!sort_records (sortkind, p, sz, size))
+            {
+              free (buf);
+              return;
+            }
+          for (size_t i = 0; i != sz; i += 1)
+            {
+              int key;
+              memcpy (&key, p + (i * size), sizeof key);
+              if (i != 0)
+                {
+                  CHECK (recordcmp (p + ((i - 1) * size),
+                                    p + (i * size)) <= 0);
+                }
+              for (size_t j = sizeof key; j != size; j += 1)
+                CHECK (p[(i * size) + j] == (char) (key + j));
+            }
+        }
+  printf ("Record sizes: OK\n");
+
+  free (buf);
+}
+
 int
 main (int argc, char *argv[])
 {
@@ -468,11 +1040,18 @@ main (int argc, char *argv[])
       exit (1);
     }
   sortkind_t sortkind = argv[1];
+
+  /* Use several threads, however many processors there are. */
+  unstable_qsort_parallel_set_threads (4);
+
   test_random_arrays_with_int_keys (sortkind);
   test_presorted_arrays_with_int_keys (sortkind);
   test_reverse_presorted_arrays_with_int_keys (sortkind);
+  test_runs_arrays_with_int_keys (sortkind);
   test_sign_reversal_random_arrays_with_int_keys (sortkind);
   test_constant_arrays_with_int_keys (sortkind);
   test_sign_reversal_constant_arrays_with_int_keys (sortkind);
+  test_stability_with_int_keys (sortkind);
+  test_record_sizes (sortkind);
   return 0;
 }
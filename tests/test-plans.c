@@ -0,0 +1,383 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include "quicksorts/qsort-plan.h"
+#include "quicksorts/unstable-qsort-parallel.h"
+
+#if __GNUC__
+#define STRCMP __builtin_strcmp
+#else
+#define STRCMP strcmp
+#endif
+
+typedef const char *sortkind_t;
+#define sortkind_eq(A, B) (STRCMP ((A), (B)) == 0)
+
+#define CHECK(expr)                             \
+  if (expr)                                     \
+    {}                                          \
+  else                                          \
+    check_failed (__FILE__, __LINE__)
+
+static void
+check_failed (const char *file, unsigned int line)
+{
+  fprintf (stderr, "CHECK failed at %s:%u\n", file, line);
+  exit (1);
+}
+
+static uint64_t
+random_bits (void)
+{
+  return (((uint64_t) mrand48 ()) << 32) ^ (uint64_t) mrand48 ();
+}
+
+/* Each record is a key, then its original index (if there is room),
+   then bytes that depend on the index. With QUICKSORTS_KEY_COMPAR the
+   key is an int32_t. */
+
+static const size_t key_sizes[] = {
+  [QUICKSORTS_KEY_COMPAR] = 4,
+  [QUICKSORTS_KEY_INT32] = 4,
+  [QUICKSORTS_KEY_UINT32] = 4,
+  [QUICKSORTS_KEY_INT64] = 8,
+  [QUICKSORTS_KEY_UINT64] = 8,
+  [QUICKSORTS_KEY_FLOAT] = 4,
+  [QUICKSORTS_KEY_DOUBLE] = 8
+};
+
+static const char *key_names[] = {
+  [QUICKSORTS_KEY_COMPAR] = "compar",
+  [QUICKSORTS_KEY_INT32] = "int32",
+  [QUICKSORTS_KEY_UINT32] = "uint32",
+  [QUICKSORTS_KEY_INT64] = "int64",
+  [QUICKSORTS_KEY_UINT64] = "uint64",
+  [QUICKSORTS_KEY_FLOAT] = "float",
+  [QUICKSORTS_KEY_DOUBLE] = "double"
+};
+
+/* Keys are made from values small enough that a double holds them
+   exactly. */
+static void
+store_key (enum quicksorts_key key, char *p, int64_t v)
+{
+  switch (key)
+    {
+    case QUICKSORTS_KEY_COMPAR:
+    case QUICKSORTS_KEY_INT32:
+      {
+        int32_t x = (int32_t) v;
+        memcpy (p, &x, sizeof x);
+      }
+      break;
+    case QUICKSORTS_KEY_UINT32:
+      {
+        uint32_t x = (uint32_t) v;
+        memcpy (p, &x, sizeof x);
+      }
+      break;
+    case QUICKSORTS_KEY_INT64:
+      {
+        int64_t x = v * 1000003;
+        memcpy (p, &x, sizeof x);
+      }
+      break;
+    case QUICKSORTS_KEY_UINT64:
+      {
+        uint64_t x = (uint64_t) v * 1000003;
+        memcpy (p, &x, sizeof x);
+      }
+      break;
+    case QUICKSORTS_KEY_FLOAT:
+      {
+        float x = (float) v / 8;
+        memcpy (p, &x, sizeof x);
+      }
+      break;
+    case QUICKSORTS_KEY_DOUBLE:
+      {
+        double x = (double) v / 8;
+        memcpy (p, &x, sizeof x);
+      }
+      break;
+    }
+}
+
+static int
+compare_keys (enum quicksorts_key key, const char *p, const char *q)
+{
+  int result = 0;
+  switch (key)
+    {
+#define COMPARE_AS(T)                                   \
+      {                                                 \
+        T x, y;                                         \
+        memcpy (&x, p, sizeof x);                       \
+        memcpy (&y, q, sizeof y);                       \
+        result = (x < y) ? -1 : ((y < x) ? 1 : 0);      \
+      }
+    case QUICKSORTS_KEY_COMPAR:
+    case QUICKSORTS_KEY_INT32:
+      COMPARE_AS (int32_t);
+      break;
+    case QUICKSORTS_KEY_UINT32:
+      COMPARE_AS (uint32_t);
+      break;
+    case QUICKSORTS_KEY_INT64:
+      COMPARE_AS (int64_t);
+      break;
+    case QUICKSORTS_KEY_UINT64:
+      COMPARE_AS (uint64_t);
+      break;
+    case QUICKSORTS_KEY_FLOAT:
+      COMPARE_AS (float);
+      break;
+    case QUICKSORTS_KEY_DOUBLE:
+      COMPARE_AS (double);
+      break;
+#undef COMPARE_AS
+    }
+  return result;
+}
+
+static uint32_t
+index_of (const char *p, size_t keysz)
+{
+  uint32_t i;
+  memcpy (&i, p + keysz, sizeof i);
+  return i;
+}
+
+static int
+key_compar (const void *p, const void *q, void *arg)
+{
+  return compare_keys (QUICKSORTS_KEY_COMPAR, p, q) * *(int *) arg;
+}
+
+/* Breaks ties by the original index, backwards. */
+static int
+index_compar (const void *p, const void *q, void *arg)
+{
+  const size_t keysz = *(size_t *) arg;
+  const uint32_t i = index_of (p, keysz);
+  const uint32_t j = index_of (q, keysz);
+  return (i < j) ? 1 : ((j < i) ? -1 : 0);
+}
+
+static void
+initialize (enum quicksorts_key key, char *p, size_t n, size_t elemsz,
+            int pattern)
+{
+  const size_t keysz = key_sizes[key];
+  for (size_t i = 0; i != n; i += 1)
+    {
+      char *e = p + (i * elemsz);
+      int64_t v;
+      switch (pattern)
+        {
+        case 0:
+          v = (int64_t) (random_bits () % 2000001) - 1000000;
+          break;
+        case 1:
+          v = (int64_t) (random_bits () % 5);
+          break;
+        case 2:
+          v = (int64_t) i;
+          break;
+        default:
+          v = (int64_t) (n - i);
+          break;
+        }
+      if (key == QUICKSORTS_KEY_UINT32 || key == QUICKSORTS_KEY_UINT64)
+        v = (v < 0) ? -v : v;
+      store_key (key, e, v);
+      if (keysz + sizeof (uint32_t) <= elemsz)
+        {
+          const uint32_t index = (uint32_t) i;
+          memcpy (e + keysz, &index, sizeof index);
+          for (size_t j = keysz + sizeof index; j != elemsz; j += 1)
+            e[j] = (char) (i + j);
+        }
+    }
+}
+
+static void
+check_sorted (enum quicksorts_key key, const char *p, size_t n,
+              size_t elemsz, bool ordered_ties, bool reverse_ties,
+              bool *seen)
+{
+  const size_t keysz = key_sizes[key];
+  const bool indexed = (keysz + sizeof (uint32_t) <= elemsz);
+  for (size_t i = 1; i < n; i += 1)
+    {
+      const char *e = p + (i * elemsz);
+      const int c = compare_keys (key, e - elemsz, e);
+      CHECK (c <= 0);
+      if (c == 0 && indexed && ordered_ties)
+        {
+          const uint32_t i0 = index_of (e - elemsz, keysz);
+          const uint32_t i1 = index_of (e, keysz);
+          CHECK (reverse_ties ? (i1 < i0) : (i0 < i1));
+        }
+    }
+  if (indexed)
+    {
+      memset (seen, 0, n * sizeof (bool));
+      for (size_t i = 0; i != n; i += 1)
+        {
+          const char *e = p + (i * elemsz);
+          const uint32_t index = index_of (e, keysz);
+          CHECK (index < n && !seen[index]);
+          seen[index] = true;
+          for (size_t j = keysz + sizeof index; j != elemsz; j += 1)
+            CHECK (e[j] == (char) (index + j));
+        }
+    }
+}
+
+static const size_t sizes[] = {
+  0, 1, 2, 3, 10, 81, 500, 1000, 5000, 40000
+};
+
+#define N_SIZES (sizeof sizes / sizeof sizes[0])
+
+/* Plans are made for arrays of 1000, so the larger sizes go past the
+   hint. */
+#define SIZE_HINT 1000
+
+static void
+plan_test (enum quicksorts_key key, size_t elemsz, unsigned int flags)
+{
+  const size_t max_n = sizes[N_SIZES - 1];
+  const size_t keysz = key_sizes[key];
+  const bool stable = ((flags & QUICKSORTS_PLAN_STABLE) != 0);
+  char *storage = malloc ((max_n * elemsz) + 1);
+  bool *seen = malloc (max_n * sizeof (bool));
+  CHECK (storage != NULL && seen != NULL);
+
+  printf ("%s keys, %zu-byte elements%s%s\n", key_names[key], elemsz,
+          stable ? ", stable" : "",
+          ((flags & QUICKSORTS_PLAN_PARALLEL) != 0) ? ", parallel" : "");
+
+  quicksorts_plan *plan =
+    quicksorts_plan_create (elemsz, key, SIZE_HINT, flags);
+  CHECK (plan != NULL);
+
+  int direction = 1;
+  size_t keysz_arg = keysz;
+  for (size_t k = 0; k != N_SIZES; k += 1)
+    for (int pattern = 0; pattern != 4; pattern += 1)
+      for (size_t offset = 0; offset != 2; offset += 1)
+        {
+          /* An array that is not aligned is sorted all the same. */
+          char *p = storage + offset;
+          const size_t n = sizes[k];
+          initialize (key, p, n, elemsz, pattern);
+          if (key == QUICKSORTS_KEY_COMPAR)
+            {
+              quicksorts_plan_execute (plan, p, n, key_compar, &direction);
+              check_sorted (key, p, n, elemsz, stable, false, seen);
+            }
+          else if (keysz + sizeof (uint32_t) <= elemsz && !stable)
+            {
+              /* The comparison function breaks ties. */
+              quicksorts_plan_execute (plan, p, n, index_compar,
+                                       &keysz_arg);
+              check_sorted (key, p, n, elemsz, true, true, seen);
+            }
+          else
+            {
+              quicksorts_plan_execute (plan, p, n, NULL, NULL);
+              check_sorted (key, p, n, elemsz, stable, false, seen);
+            }
+        }
+
+  quicksorts_plan_destroy (plan);
+  free (storage);
+  free (seen);
+}
+
+static void
+all_plan_tests (unsigned int extra_flags)
+{
+  static const size_t compar_sizes[] = {
+    4, 8, 12, 16, 24, 32, 40, 64, 100, 600
+  };
+  for (size_t i = 0; i != sizeof compar_sizes / sizeof compar_sizes[0];
+       i += 1)
+    {
+      plan_test (QUICKSORTS_KEY_COMPAR, compar_sizes[i], extra_flags);
+      plan_test (QUICKSORTS_KEY_COMPAR, compar_sizes[i],
+                 extra_flags | QUICKSORTS_PLAN_STABLE);
+    }
+
+  for (int key = QUICKSORTS_KEY_INT32; key <= QUICKSORTS_KEY_DOUBLE;
+       key += 1)
+    {
+      const size_t keysz = key_sizes[key];
+      const size_t key_elemszs[] = { keysz, keysz + 4, 24, 40 };
+      for (size_t i = 0; i != 4; i += 1)
+        {
+          plan_test (key, key_elemszs[i], extra_flags);
+          plan_test (key, key_elemszs[i],
+                     extra_flags | QUICKSORTS_PLAN_STABLE);
+        }
+    }
+
+  /* Plans that cannot be made. */
+  CHECK (quicksorts_plan_create (0, QUICKSORTS_KEY_COMPAR,
+                                 SIZE_HINT, extra_flags) == NULL);
+  CHECK (quicksorts_plan_create (4, QUICKSORTS_KEY_INT64,
+                                 SIZE_HINT, extra_flags) == NULL);
+  CHECK (quicksorts_plan_create (8, QUICKSORTS_KEY_COMPAR, SIZE_MAX / 4,
+                                 extra_flags | QUICKSORTS_PLAN_STABLE)
+         == NULL);
+  quicksorts_plan_destroy (NULL);
+}
+
+int
+main (int argc, char *argv[])
+{
+  if (argc <= 1)
+    {
+      printf ("This program expects a command-line argument.\n");
+      exit (1);
+    }
+  sortkind_t sortkind = argv[1];
+
+  if (sortkind_eq (sortkind, "plan"))
+    all_plan_tests (0);
+  else if (sortkind_eq (sortkind, "plan-parallel"))
+    {
+      /* Parallel sorting must be tried even on a single processor. */
+      unstable_qsort_parallel_set_threads (4);
+      all_plan_tests (QUICKSORTS_PLAN_PARALLEL);
+    }
+  else
+    {
+      printf ("Invalid command-line argument.\n");
+      exit (1);
+    }
+
+  return 0;
+}
@@ -0,0 +1,156 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  A program that sorts with the C library’s qsort and qsort_r, and
+  with __qsort_r_compat if something provides it, for running with
+  libquicksorts-preload.so. It is not linked with libquicksorts.
+
+  With the argument "stable", it also checks that equal elements kept
+  their order.
+*/
+
+#define _GNU_SOURCE 1
+
+#include <dlfcn.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define CHECK(expr)                             \
+  if (expr)                                     \
+    {}                                          \
+  else                                          \
+    check_failed (__FILE__, __LINE__)
+
+static void
+check_failed (const char *file, unsigned int line)
+{
+  fprintf (stderr, "CHECK failed at %s:%u\n", file, line);
+  exit (1);
+}
+
+typedef struct
+{
+  int key;
+  unsigned int index;
+  char padding[24];
+} record_t;
+
+static int
+record_cmp (const void *px, const void *py)
+{
+  const record_t *x = px;
+  const record_t *y = py;
+  return (x->key < y->key) ? -1 : ((y->key < x->key) ? 1 : 0);
+}
+
+/* The argument is the direction, 1 or -1. */
+static int
+record_cmp_r (const void *px, const void *py, void *arg)
+{
+  return record_cmp (px, py) * *(const int *) arg;
+}
+
+static int
+record_cmp_bsd (void *arg, const void *px, const void *py)
+{
+  return record_cmp_r (px, py, arg);
+}
+
+static void
+initialize (record_t *p, size_t n, int modulus)
+{
+  for (size_t i = 0; i != n; i += 1)
+    {
+      p[i].key = (int) (lrand48 () % modulus);
+      p[i].index = (unsigned int) i;
+      memset (p[i].padding, (int) (i & 0xFF), sizeof p[i].padding);
+    }
+}
+
+static void
+check (const record_t *p, size_t n, int direction, bool stable)
+{
+  bool *seen = calloc (n + 1, sizeof (bool));
+  CHECK (seen != NULL);
+  for (size_t i = 0; i != n; i += 1)
+    {
+      CHECK (p[i].index < n && !seen[p[i].index]);
+      seen[p[i].index] = true;
+      CHECK (p[i].padding[0] == (char) (p[i].index & 0xFF));
+      if (i != 0)
+        {
+          const int c = record_cmp (&p[i - 1], &p[i]) * direction;
+          CHECK (c <= 0);
+          if (stable && c == 0)
+            {
+              CHECK (p[i - 1].index < p[i].index);
+            }
+        }
+    }
+  free (seen);
+}
+
+int
+main (int argc, char *argv[])
+{
+  const bool stable = (2 <= argc && strcmp (argv[1], "stable") == 0);
+
+  void (*qsort_r_compat) (void *, size_t, size_t, void *,
+                          int (*) (void *, const void *, const void *));
+  *(void **) &qsort_r_compat = dlsym (RTLD_DEFAULT, "__qsort_r_compat");
+
+  static const size_t sizes[] = { 0, 1, 2, 5, 50, 1000, 100000 };
+  const size_t max_n = sizes[sizeof sizes / sizeof sizes[0] - 1];
+  record_t *p = malloc (max_n * sizeof (record_t));
+  CHECK (p != NULL);
+
+  for (size_t k = 0; k != sizeof sizes / sizeof sizes[0]; k += 1)
+    for (int modulus = 3; modulus <= 3000000; modulus *= 1000)
+      {
+        const size_t n = sizes[k];
+        int direction = 1;
+
+        initialize (p, n, modulus);
+        qsort (p, n, sizeof (record_t), record_cmp);
+        check (p, n, 1, stable);
+
+        direction = -1;
+        initialize (p, n, modulus);
+        qsort_r (p, n, sizeof (record_t), record_cmp_r, &direction);
+        check (p, n, -1, stable);
+
+        if (qsort_r_compat != NULL)
+          {
+            initialize (p, n, modulus);
+            qsort_r_compat (p, n, sizeof (record_t), &direction,
+                            record_cmp_bsd);
+            check (p, n, -1, stable);
+          }
+      }
+
+  printf ("qsort: OK\n");
+  printf ("qsort_r: OK\n");
+  printf ("__qsort_r_compat: %s\n",
+          (qsort_r_compat != NULL) ? "OK" : "absent");
+
+  free (p);
+  return 0;
+}
@@ -0,0 +1,285 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "quicksorts/unstable-sort-keys.h"
+#include "quicksorts/unstable-radix-sort.h"
+
+#define MAX_SZ 1000000ULL
+
+#if __GNUC__
+#define STRCMP __builtin_strcmp
+#else
+#define STRCMP strcmp
+#endif
+
+typedef const char *sortkind_t;
+#define sortkind_eq(A, B) (STRCMP ((A), (B)) == 0)
+
+#define MAX(x, y) ((x) < (y) ? (y) : (x))
+
+#define CHECK(expr)                             \
+  if (expr)                                     \
+    {}                                          \
+  else                                          \
+    check_failed (__FILE__, __LINE__)
+
+static void
+check_failed (const char *file, unsigned int line)
+{
+  fprintf (stderr, "CHECK failed at %s:%u\n", file, line);
+  exit (1);
+}
+
+long double
+get_clock (void)
+{
+  return ((long double) clock ()) / CLOCKS_PER_SEC;
+}
+
+static uint64_t
+random_bits (void)
+{
+  return (((uint64_t) mrand48 ()) << 32) ^ (uint64_t) mrand48 ();
+}
+
+/* Patterns: random over the whole range, random with many
+   duplicates, sorted, reverse-sorted, and constant. */
+enum { N_PATTERNS = 5 };
+
+static const char *pattern_names[N_PATTERNS] = {
+  "Random", "Few distinct", "Pre-sorted", "Reverse pre-sorted",
+  "Constant"
+};
+
+#define DEFINE_TEST(NAME, T, FROM_BITS, SORT)                           \
+  static int                                                            \
+  NAME##_cmp (const void *px, const void *py)                           \
+  {                                                                     \
+    const T x = *(const T *) px;                                        \
+    const T y = *(const T *) py;                                        \
+    return ((x < y) ? -1 : ((y < x) ? 1 : 0));                          \
+  }                                                                     \
+                                                                        \
+  static void                                                           \
+  NAME##_initialize (T *p, size_t n, int pattern)                       \
+  {                                                                     \
+    for (size_t i = 0; i != n; i += 1)                                  \
+      switch (pattern)                                                  \
+        {                                                               \
+        case 0:                                                         \
+          p[i] = FROM_BITS (random_bits ());                            \
+          break;                                                        \
+        case 1:                                                         \
+          p[i] = FROM_BITS (random_bits () % 5);                        \
+          break;                                                        \
+        case 2:                                                         \
+          p[i] = FROM_BITS (i);                                         \
+          break;                                                        \
+        case 3:                                                         \
+          p[i] = FROM_BITS (n - i);                                     \
+          break;                                                        \
+        default:                                                        \
+          p[i] = FROM_BITS (12345);                                     \
+          break;                                                        \
+        }                                                               \
+  }                                                                     \
+                                                                        \
+  static void                                                           \
+  NAME##_test (void)                                                    \
+  {                                                                     \
+    T *p1 = malloc (MAX_SZ * sizeof (T));                               \
+    T *p2 = malloc (MAX_SZ * sizeof (T));                               \
+                                                                        \
+    for (int pattern = 0; pattern != N_PATTERNS; pattern += 1)          \
+      {                                                                 \
+        printf ("%s %s arrays:\n", pattern_names[pattern], #NAME);      \
+                                                                        \
+        /* Every small size, to exercise the partition edges. */        \
+        for (size_t sz = 0; sz <= 300; sz += 1)                         \
+          {                                                             \
+            NAME##_initialize (p1, sz, pattern);                        \
+            memcpy (p2, p1, sz * sizeof (T));                           \
+            qsort (p1, sz, sizeof (T), NAME##_cmp);                     \
+            SORT (p2, sz);                                              \
+            for (size_t i = 0; i != sz; i += 1)                         \
+              CHECK (NAME##_cmp (&p1[i], &p2[i]) == 0);                 \
+          }                                                             \
+                                                                        \
+        for (size_t sz = 1000; sz <= MAX_SZ; sz *= 10)                  \
+          {                                                             \
+            NAME##_initialize (p1, sz, pattern);                        \
+            memcpy (p2, p1, sz * sizeof (T));                           \
+            const long double t11 = get_clock ();                       \
+            qsort (p1, sz, sizeof (T), NAME##_cmp);                     \
+            const long double t12 = get_clock ();                       \
+            SORT (p2, sz);                                              \
+            const long double t22 = get_clock ();                       \
+            for (size_t i = 0; i != sz; i += 1)                         \
+              CHECK (NAME##_cmp (&p1[i], &p2[i]) == 0);                 \
+            printf ("  qsort:%Lf  ours:%Lf  %zu\n",                     \
+                    t12 - t11, t22 - t12, sz);                          \
+          }                                                             \
+      }                                                                 \
+                                                                        \
+    free (p1);                                                          \
+    free (p2);                                                          \
+  }
+
+#define INT32_FROM_BITS(b) ((int32_t) (uint32_t) (b))
+#define UINT32_FROM_BITS(b) ((uint32_t) (b))
+#define INT64_FROM_BITS(b) ((int64_t) (uint64_t) (b))
+#define UINT64_FROM_BITS(b) ((uint64_t) (b))
+
+/* Floating-point keys are spread over many magnitudes, with both
+   signs and both zeros. */
+#define FLOAT_FROM_BITS(b)                                      \
+  ((float) ldexp ((double) (int32_t) (uint32_t) (b),            \
+                  (int) ((b) % 64) - 32))
+#define DOUBLE_FROM_BITS(b)                                     \
+  (ldexp ((double) (int64_t) (uint64_t) (b),                    \
+          (int) ((b) % 512) - 256))
+
+DEFINE_TEST (int32, int32_t, INT32_FROM_BITS, unstable_sort_int32)
+DEFINE_TEST (uint32, uint32_t, UINT32_FROM_BITS, unstable_sort_uint32)
+DEFINE_TEST (int64, int64_t, INT64_FROM_BITS, unstable_sort_int64)
+DEFINE_TEST (uint64, uint64_t, UINT64_FROM_BITS, unstable_sort_uint64)
+DEFINE_TEST (float, float, FLOAT_FROM_BITS, unstable_sort_float)
+DEFINE_TEST (double, double, DOUBLE_FROM_BITS, unstable_sort_double)
+
+#define INT32_LT(x, y) (*(const int32_t *) (x) < *(const int32_t *) (y))
+#define UINT32_LT(x, y) (*(const uint32_t *) (x) < *(const uint32_t *) (y))
+#define INT64_LT(x, y) (*(const int64_t *) (x) < *(const int64_t *) (y))
+#define UINT64_LT(x, y) (*(const uint64_t *) (x) < *(const uint64_t *) (y))
+#define FLOAT_LT(x, y) (*(const float *) (x) < *(const float *) (y))
+#define DOUBLE_LT(x, y) (*(const double *) (x) < *(const double *) (y))
+
+#define INT32_KEY(p) unstable_radix_sort_int32_key (*(p))
+#define UINT32_KEY(p) (*(p))
+#define INT64_KEY(p) unstable_radix_sort_int64_key (*(p))
+#define UINT64_KEY(p) (*(p))
+#define FLOAT_KEY(p) unstable_radix_sort_float_key (*(p))
+#define DOUBLE_KEY(p) unstable_radix_sort_double_key (*(p))
+
+#define DEFINE_RADIX_SORT(NAME, T, KEY, LT)     \
+  static void                                   \
+  NAME (T *base, size_t nmemb)                  \
+  {                                             \
+    UNSTABLE_RADIX_SORT_TYPED                   \
+      (T, base, nmemb, KEY, LT);                \
+  }
+
+DEFINE_RADIX_SORT (radix_sort_int32, int32_t, INT32_KEY, INT32_LT)
+DEFINE_RADIX_SORT (radix_sort_uint32, uint32_t, UINT32_KEY, UINT32_LT)
+DEFINE_RADIX_SORT (radix_sort_int64, int64_t, INT64_KEY, INT64_LT)
+DEFINE_RADIX_SORT (radix_sort_uint64, uint64_t, UINT64_KEY, UINT64_LT)
+DEFINE_RADIX_SORT (radix_sort_float, float, FLOAT_KEY, FLOAT_LT)
+DEFINE_RADIX_SORT (radix_sort_double, double, DOUBLE_KEY, DOUBLE_LT)
+
+DEFINE_TEST (radix_int32, int32_t, INT32_FROM_BITS, radix_sort_int32)
+DEFINE_TEST (radix_uint32, uint32_t, UINT32_FROM_BITS, radix_sort_uint32)
+DEFINE_TEST (radix_int64, int64_t, INT64_FROM_BITS, radix_sort_int64)
+DEFINE_TEST (radix_uint64, uint64_t, UINT64_FROM_BITS, radix_sort_uint64)
+DEFINE_TEST (radix_float, float, FLOAT_FROM_BITS, radix_sort_float)
+DEFINE_TEST (radix_double, double, DOUBLE_FROM_BITS, radix_sort_double)
+
+/* A struct keyed by one of its fields. The payload must travel with
+   the key. */
+typedef struct
+{
+  uint16_t key;
+  uint64_t payload;
+} keyed_t;
+
+#define KEYED_LT(x, y)                                          \
+  (((const keyed_t *) (x))->key < ((const keyed_t *) (y))->key)
+#define KEYED_KEY(p) ((p)->key)
+
+static void
+radix_keyed_struct_test (void)
+{
+  keyed_t *p = malloc (MAX_SZ * sizeof (keyed_t));
+
+  printf ("Struct arrays keyed by a field:\n");
+  for (size_t sz = 0; sz <= MAX_SZ; sz = MAX (1, 10 * sz))
+    {
+      for (size_t i = 0; i != sz; i += 1)
+        {
+          p[i].key = (uint16_t) random_bits ();
+          p[i].payload = ~(uint64_t) p[i].key;
+        }
+      UNSTABLE_RADIX_SORT_TYPED (keyed_t, p, sz, KEYED_KEY, KEYED_LT);
+      for (size_t i = 0; i != sz; i += 1)
+        {
+          CHECK (i == 0 || p[i - 1].key <= p[i].key);
+          CHECK (p[i].payload == ~(uint64_t) p[i].key);
+        }
+      printf ("  %zu\n", sz);
+    }
+
+  free (p);
+}
+
+int
+main (int argc, char *argv[])
+{
+  if (argc <= 1)
+    {
+      printf ("This program expects a command-line argument.\n");
+      exit (1);
+    }
+  sortkind_t sortkind = argv[1];
+
+  /* Hold the vectorization down, so every engine the CPU has can be
+     tested. */
+  if (sortkind_eq (sortkind, "sort-keys"))
+    {}
+  else if (sortkind_eq (sortkind, "sort-keys-avx2"))
+    setenv ("QUICKSORTS_SIMD", "avx2", 1);
+  else if (sortkind_eq (sortkind, "sort-keys-scalar"))
+    setenv ("QUICKSORTS_SIMD", "none", 1);
+  else if (sortkind_eq (sortkind, "radix-sort"))
+    {
+      radix_int32_test ();
+      radix_uint32_test ();
+      radix_int64_test ();
+      radix_uint64_test ();
+      radix_float_test ();
+      radix_double_test ();
+      radix_keyed_struct_test ();
+      return 0;
+    }
+  else
+    {
+      printf ("Invalid command-line argument.\n");
+      exit (1);
+    }
+
+  int32_test ();
+  uint32_test ();
+  int64_test ();
+  uint64_test ();
+  float_test ();
+  double_test ();
+  return 0;
+}
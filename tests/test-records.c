@@ -0,0 +1,248 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+/* Tests of the quicksort-records program, whose path is given by
+   the environment variable QUICKSORT_RECORDS. */
+
+#include <math.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+
+#if __GNUC__
+#define STRCMP __builtin_strcmp
+#else
+#define STRCMP strcmp
+#endif
+
+typedef const char *sortkind_t;
+#define sortkind_eq(A, B) (STRCMP ((A), (B)) == 0)
+
+#define CHECK(expr)                             \
+  if (expr)                                     \
+    {}                                          \
+  else                                          \
+    check_failed (__FILE__, __LINE__)
+
+static void
+check_failed (const char *file, unsigned int line)
+{
+  fprintf (stderr, "CHECK failed at %s:%u\n", file, line);
+  exit (1);
+}
+
+enum { RECORD_SIZE = 20, KEY_OFFSET = 4, MAX_SZ = 100000 };
+
+static bool little_endian_host;
+
+/* The key as a number, from the bytes in either order. */
+static uint64_t
+key_bits (const unsigned char *p, size_t size, bool big_endian)
+{
+  uint64_t bits = 0;
+  for (size_t i = 0; i != size; i += 1)
+    {
+      const size_t j = big_endian ? i : size - 1 - i;
+      bits = (bits << 8) | p[j];
+    }
+  return bits;
+}
+
+/* Compare keys of the given type: 'i', 'u' or 'f', or 'b' for
+   bytes. */
+static int
+key_cmp (const unsigned char *p, const unsigned char *q, char type,
+         size_t size, bool big_endian)
+{
+  if (type == 'b')
+    return memcmp (p, q, RECORD_SIZE - KEY_OFFSET);
+  const uint64_t x = key_bits (p, size, big_endian);
+  const uint64_t y = key_bits (q, size, big_endian);
+  if (type == 'u')
+    return (x < y) ? -1 : ((y < x) ? 1 : 0);
+  if (type == 'i')
+    {
+      const uint64_t sign = (uint64_t) 1 << (8 * size - 1);
+      const uint64_t xs = x ^ sign;
+      const uint64_t ys = y ^ sign;
+      return (xs < ys) ? -1 : ((ys < xs) ? 1 : 0);
+    }
+  /* Floats, in the total order that puts -0 before +0 and NaNs
+     beyond the infinities of the same sign. */
+  const uint64_t sign = (uint64_t) 1 << (8 * size - 1);
+  const uint64_t mask = sign | (sign - 1);
+  const uint64_t xf = (x & sign) ? (~x & mask) : (x | sign);
+  const uint64_t yf = (y & sign) ? (~y & mask) : (y | sign);
+  return (xf < yf) ? -1 : ((yf < xf) ? 1 : 0);
+}
+
+static int
+record_cmp (const void *p, const void *q)
+{
+  return memcmp (p, q, RECORD_SIZE);
+}
+
+static void
+fill_random (unsigned char *p, size_t n, char type, size_t size,
+             bool big_endian)
+{
+  for (size_t i = 0; i != n * RECORD_SIZE; i += 1)
+    p[i] = (unsigned char) lrand48 ();
+  if (type == 'f')
+    /* Ordinary numbers, of both signs, with zeros of both signs,
+       infinities and NaNs among them. */
+    for (size_t i = 0; i != n; i += 1)
+      {
+        static const double specials[] = {
+          0.0, -0.0, INFINITY, -INFINITY, NAN, -NAN
+        };
+        const size_t n_specials = sizeof specials / sizeof specials[0];
+        const long r = mrand48 ();
+        const double x = ((unsigned long) r % 8 == 0) ?
+          specials[((unsigned long) r >> 3) % n_specials] : r / 1000.0;
+        unsigned char *k = p + (i * RECORD_SIZE) + KEY_OFFSET;
+        unsigned char bytes[8];
+        if (size == 4)
+          {
+            const float xf = (float) x;
+            memcpy (bytes, &xf, 4);
+          }
+        else
+          memcpy (bytes, &x, 8);
+        for (size_t j = 0; j != size; j += 1)
+          k[j] = bytes[(big_endian == little_endian_host) ?
+                       size - 1 - j : j];
+      }
+  else if (type != 'b' && (lrand48 () & 1))
+    /* Many duplicate keys. */
+    for (size_t i = 0; i != n; i += 1)
+      {
+        unsigned char *k = p + (i * RECORD_SIZE) + KEY_OFFSET;
+        memset (k, 0, size);
+        k[big_endian ? size - 1 : 0] = (unsigned char) (lrand48 () % 3);
+      }
+}
+
+static void
+test_key (const char *tool, const char *key, bool reverse,
+          const char *leaf_size, size_t n)
+{
+  const char type = (key[0] == 'b') ? 'b' : key[0];
+  const size_t size = (type == 'b') ? 0 : (size_t) atoi (key + 1) / 8;
+  const size_t len = strlen (key);
+  bool big_endian = !little_endian_host;
+  if (type != 'b' && 2 < len && strcmp (key + len - 2, "le") == 0)
+    big_endian = false;
+  else if (type != 'b' && 2 < len && strcmp (key + len - 2, "be") == 0)
+    big_endian = true;
+
+  unsigned char *p1 = malloc (MAX_SZ * RECORD_SIZE);
+  unsigned char *p2 = malloc (MAX_SZ * RECORD_SIZE);
+  fill_random (p1, n, type, size, big_endian);
+
+  const char *tmpdir = getenv ("TMPDIR");
+  char path[4096];
+  snprintf (path, sizeof path, "%s/test-records-XXXXXX",
+            (tmpdir == NULL || tmpdir[0] == '\0') ? "/tmp" : tmpdir);
+  const int fd = mkstemp (path);
+  CHECK (fd != -1);
+  CHECK (write (fd, p1, n * RECORD_SIZE) == (ssize_t) (n * RECORD_SIZE));
+  close (fd);
+
+  char command[8192];
+  snprintf (command, sizeof command,
+            "'%s' -s %d -o %d -k %s %s -L %s '%s'",
+            tool, RECORD_SIZE, KEY_OFFSET, key, reverse ? "-r" : "",
+            leaf_size, path);
+  CHECK (system (command) == 0);
+
+  FILE *f = fopen (path, "rb");
+  CHECK (f != NULL);
+  CHECK (fread (p2, RECORD_SIZE, n, f) == n);
+  CHECK (fgetc (f) == EOF);
+  fclose (f);
+  unlink (path);
+
+  for (size_t i = 1; i < n; i += 1)
+    {
+      const int c =
+        key_cmp (p2 + ((i - 1) * RECORD_SIZE) + KEY_OFFSET,
+                 p2 + (i * RECORD_SIZE) + KEY_OFFSET,
+                 type, size, big_endian);
+      CHECK (reverse ? (0 <= c) : (c <= 0));
+    }
+
+  /* The same records, whole, must still be there. */
+  qsort (p1, n, RECORD_SIZE, record_cmp);
+  qsort (p2, n, RECORD_SIZE, record_cmp);
+  CHECK (memcmp (p1, p2, n * RECORD_SIZE) == 0);
+
+  printf ("  %s%s %zu\n", key, reverse ? " reversed" : "", n);
+  free (p1);
+  free (p2);
+}
+
+int
+main (int argc, char *argv[])
+{
+  if (argc <= 1)
+    {
+      printf ("This program expects a command-line argument.\n");
+      exit (1);
+    }
+  sortkind_t sortkind = argv[1];
+
+  const uint16_t one = 1;
+  little_endian_host = (*(const unsigned char *) &one == 1);
+
+  const char *tool = getenv ("QUICKSORT_RECORDS");
+  if (tool == NULL)
+    {
+      printf ("QUICKSORT_RECORDS is not set.\n");
+      exit (1);
+    }
+
+  if (sortkind_eq (sortkind, "quicksort-records"))
+    {
+      static const char *const keys[] = {
+        "bytes", "i8", "u8", "i16", "u16be", "i32le", "u32", "i64be",
+        "u64le", "f32", "f64be", "f32le"
+      };
+      const size_t sizes[] = { 0, 1, 2, 3, 100, 1000, MAX_SZ };
+      for (size_t i = 0; i != sizeof keys / sizeof keys[0]; i += 1)
+        for (size_t j = 0; j != sizeof sizes / sizeof sizes[0]; j += 1)
+          {
+            /* Big leaves, and tiny ones, so that the partitioning */
+            /* over the whole file gets used. */
+            test_key (tool, keys[i], false, "33554432", sizes[j]);
+            test_key (tool, keys[i], true, "33554432", sizes[j]);
+            test_key (tool, keys[i], false, "1000", sizes[j]);
+            test_key (tool, keys[i], true, "1000", sizes[j]);
+          }
+    }
+  else
+    {
+      printf ("Invalid command-line argument.\n");
+      exit (1);
+    }
+
+  return 0;
+}
@@ -0,0 +1,304 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <stdint.h>
+#include <string.h>
+#include <time.h>
+#include "quicksorts/unstable-qsort.h"
+#include "quicksorts/unstable-select.h"
+
+#define MAX_SZ 1000000ULL
+
+#if __GNUC__
+#define STRCMP __builtin_strcmp
+#else
+#define STRCMP strcmp
+#endif
+
+typedef const char *sortkind_t;
+#define sortkind_eq(A, B) (STRCMP ((A), (B)) == 0)
+
+#define MAX(x, y) ((x) < (y) ? (y) : (x))
+
+#define CHECK(expr)                             \
+  if (expr)                                     \
+    {}                                          \
+  else                                          \
+    check_failed (__FILE__, __LINE__)
+
+static void
+check_failed (const char *file, unsigned int line)
+{
+  fprintf (stderr, "CHECK failed at %s:%u\n", file, line);
+  exit (1);
+}
+
+long double
+get_clock (void)
+{
+  return ((long double) clock ()) / CLOCKS_PER_SEC;
+}
+
+static int
+intcmp (const void *px, const void *py)
+{
+  const int x = *(const int *) px;
+  const int y = *(const int *) py;
+  return ((x < y) ? -1 : ((y < x) ? 1 : 0));
+}
+
+static int
+intcmp_r (const void *px, const void *py, void *arg)
+{
+  *(size_t *) arg += 1;
+  return intcmp (px, py);
+}
+
+#define INT_LT(x, y) (*(const int *) (x) < *(const int *) (y))
+
+/* Always the first element, so that a sorted array exhausts the
+   partitioning budget and the heap is used. */
+#define PIVOT_FIRST(BASE, NMEMB, SIZE, LT, RESULT)  \
+  do                                                \
+    {                                               \
+      RESULT = 0;                                   \
+    }                                               \
+  while (0)
+
+/* Patterns: random, random with many duplicates, sorted,
+   reverse-sorted, and constant. */
+enum { N_PATTERNS = 5 };
+
+static const char *pattern_names[N_PATTERNS] = {
+  "Random", "Few distinct", "Pre-sorted", "Reverse pre-sorted",
+  "Constant"
+};
+
+static void
+initialize (int *p, size_t n, int pattern)
+{
+  for (size_t i = 0; i != n; i += 1)
+    switch (pattern)
+      {
+      case 0:
+        p[i] = (int) mrand48 ();
+        break;
+      case 1:
+        p[i] = (int) (lrand48 () % 5);
+        break;
+      case 2:
+        p[i] = (int) i;
+        break;
+      case 3:
+        p[i] = (int) (n - i);
+        break;
+      default:
+        p[i] = 12345;
+        break;
+      }
+}
+
+/*------------------------------------------------------------------*/
+
+typedef void select_t (int *p, size_t n, size_t k);
+
+static void
+nth_element (int *p, size_t n, size_t k)
+{
+  UNSTABLE_NTH_ELEMENT (p, n, sizeof (int), k, INT_LT);
+}
+
+static void
+nth_element_typed (int *p, size_t n, size_t k)
+{
+  UNSTABLE_NTH_ELEMENT_TYPED (int, p, n, k, INT_LT);
+}
+
+static void
+nth_element_heap (int *p, size_t n, size_t k)
+{
+  UNSTABLE_NTH_ELEMENT_9ARGS
+    (p, n, sizeof (int), k, INT_LT, PIVOT_FIRST, 8,
+     QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT,
+     QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_THREE_WAY);
+}
+
+static void
+nth_element_heap_typed (int *p, size_t n, size_t k)
+{
+  UNSTABLE_NTH_ELEMENT_TYPED_9ARGS
+    (int, p, n, k, INT_LT, PIVOT_FIRST, 8,
+     QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED,
+     QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_THREE_WAY__TYPED);
+}
+
+static void
+nth_element_qsort_style (int *p, size_t n, size_t k)
+{
+  unstable_nth_element (p, n, sizeof (int), k, intcmp);
+}
+
+static void
+nth_element_r_qsort_style (int *p, size_t n, size_t k)
+{
+  size_t count = 0;
+  unstable_nth_element_r (p, n, sizeof (int), k, intcmp_r, &count);
+}
+
+static void
+partial_sort (int *p, size_t n, size_t k)
+{
+  UNSTABLE_PARTIAL_SORT (p, n, sizeof (int), k, INT_LT);
+}
+
+static void
+partial_sort_typed (int *p, size_t n, size_t k)
+{
+  UNSTABLE_PARTIAL_SORT_TYPED (int, p, n, k, INT_LT);
+}
+
+static void
+partial_sort_qsort_style (int *p, size_t n, size_t k)
+{
+  unstable_partial_sort (p, n, sizeof (int), k, intcmp);
+}
+
+static void
+partial_sort_r_qsort_style (int *p, size_t n, size_t k)
+{
+  size_t count = 0;
+  unstable_partial_sort_r (p, n, sizeof (int), k, intcmp_r, &count);
+}
+
+/*------------------------------------------------------------------*/
+
+/* p has been through the selection and p_sorted through qsort. */
+static void
+check_result (int *p, const int *p_sorted, size_t n, size_t k,
+              bool partial)
+{
+  if (partial)
+    for (size_t i = 0; i < k && i < n; i += 1)
+      CHECK (p[i] == p_sorted[i]);
+  else if (k < n)
+    {
+      CHECK (p[k] == p_sorted[k]);
+      for (size_t i = 0; i != k; i += 1)
+        CHECK (p[i] <= p[k]);
+      for (size_t i = k + 1; i < n; i += 1)
+        CHECK (p[k] <= p[i]);
+    }
+
+  /* Nothing must be lost or duplicated. */
+  qsort (p, n, sizeof (int), intcmp);
+  for (size_t i = 0; i != n; i += 1)
+    CHECK (p[i] == p_sorted[i]);
+}
+
+static void
+test_select (select_t *select, bool partial)
+{
+  int *p0 = malloc (MAX_SZ * sizeof (int));
+  int *p1 = malloc (MAX_SZ * sizeof (int));
+  int *p2 = malloc (MAX_SZ * sizeof (int));
+
+  for (int pattern = 0; pattern != N_PATTERNS; pattern += 1)
+    {
+      printf ("%s arrays:\n", pattern_names[pattern]);
+
+      /* Every k for small sizes, including k == n. */
+      for (size_t sz = 0; sz <= 150; sz += 1)
+        {
+          initialize (p0, sz, pattern);
+          memcpy (p1, p0, sz * sizeof (int));
+          qsort (p1, sz, sizeof (int), intcmp);
+          for (size_t k = 0; k <= sz; k += 1)
+            {
+              memcpy (p2, p0, sz * sizeof (int));
+              select (p2, sz, k);
+              check_result (p2, p1, sz, k, partial);
+            }
+        }
+
+      for (size_t sz = 1000; sz <= MAX_SZ; sz *= 10)
+        {
+          const size_t ks[] = { 0, 1, 100, sz / 2, sz - 1 };
+          initialize (p0, sz, pattern);
+          memcpy (p1, p0, sz * sizeof (int));
+          const long double t1 = get_clock ();
+          qsort (p1, sz, sizeof (int), intcmp);
+          const long double t2 = get_clock ();
+          for (size_t j = 0; j != sizeof ks / sizeof ks[0]; j += 1)
+            {
+              memcpy (p2, p0, sz * sizeof (int));
+              const long double t3 = get_clock ();
+              select (p2, sz, ks[j]);
+              const long double t4 = get_clock ();
+              check_result (p2, p1, sz, ks[j], partial);
+              printf ("  qsort:%Lf  ours:%Lf  %zu  k=%zu\n",
+                      t2 - t1, t4 - t3, sz, ks[j]);
+            }
+        }
+    }
+
+  free (p0);
+  free (p1);
+  free (p2);
+}
+
+int
+main (int argc, char *argv[])
+{
+  if (argc <= 1)
+    {
+      printf ("This program expects a command-line argument.\n");
+      exit (1);
+    }
+  sortkind_t sortkind = argv[1];
+
+  if (sortkind_eq (sortkind, "nth-element"))
+    test_select (nth_element, false);
+  else if (sortkind_eq (sortkind, "nth-element-typed"))
+    test_select (nth_element_typed, false);
+  else if (sortkind_eq (sortkind, "nth-element-heap"))
+    test_select (nth_element_heap, false);
+  else if (sortkind_eq (sortkind, "nth-element-heap-typed"))
+    test_select (nth_element_heap_typed, false);
+  else if (sortkind_eq (sortkind, "unstable_nth_element"))
+    test_select (nth_element_qsort_style, false);
+  else if (sortkind_eq (sortkind, "unstable_nth_element_r"))
+    test_select (nth_element_r_qsort_style, false);
+  else if (sortkind_eq (sortkind, "partial-sort"))
+    test_select (partial_sort, true);
+  else if (sortkind_eq (sortkind, "partial-sort-typed"))
+    test_select (partial_sort_typed, true);
+  else if (sortkind_eq (sortkind, "unstable_partial_sort"))
+    test_select (partial_sort_qsort_style, true);
+  else if (sortkind_eq (sortkind, "unstable_partial_sort_r"))
+    test_select (partial_sort_r_qsort_style, true);
+  else
+    {
+      printf ("Invalid command-line argument.\n");
+      exit (1);
+    }
+
+  return 0;
+}
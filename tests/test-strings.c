@@ -0,0 +1,185 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "quicksorts/unstable-sort-strings.h"
+#include "quicksorts/unstable-string-sort.h"
+
+#define MAX_SZ 1000000ULL
+
+#if __GNUC__
+#define STRCMP __builtin_strcmp
+#else
+#define STRCMP strcmp
+#endif
+
+typedef const char *sortkind_t;
+#define sortkind_eq(A, B) (STRCMP ((A), (B)) == 0)
+
+#define MAX(x, y) ((x) < (y) ? (y) : (x))
+
+#define CHECK(expr)                             \
+  if (expr)                                     \
+    {}                                          \
+  else                                          \
+    check_failed (__FILE__, __LINE__)
+
+static void
+check_failed (const char *file, unsigned int line)
+{
+  fprintf (stderr, "CHECK failed at %s:%u\n", file, line);
+  exit (1);
+}
+
+long double
+get_clock (void)
+{
+  return ((long double) clock ()) / CLOCKS_PER_SEC;
+}
+
+/* Strings that share long prefixes, like URLs and log keys: a few
+   hosts, a few paths under each, then a number. Some strings are
+   prefixes of others, and some are repeated. */
+static char *
+make_strings (size_t n, const char **strs)
+{
+  static const char *const hosts[] = {
+    "https://www.example.com/", "https://www.example.org/",
+    "https://static.example.com/assets/", ""
+  };
+  static const char *const paths[] = {
+    "", "index/", "search?q=", "logs/2022/10/17/server-",
+    "logs/2022/10/17/server-1/"
+  };
+  enum { MAX_LEN = 80 };
+  char *text = malloc (n * MAX_LEN);
+  for (size_t i = 0; i != n; i += 1)
+    {
+      char *s = text + (i * MAX_LEN);
+      const unsigned long r = (unsigned long) lrand48 ();
+      if (r % 4 == 0)
+        snprintf (s, MAX_LEN, "%s%s",
+                  hosts[r % 3], paths[(r >> 8) % 5]);
+      else
+        snprintf (s, MAX_LEN, "%s%s%lu",
+                  hosts[(r >> 4) % 4], paths[(r >> 8) % 5],
+                  (r >> 12) % (n + 1));
+      strs[i] = s;
+    }
+  return text;
+}
+
+static int
+strptrcmp (const void *px, const void *py)
+{
+  return strcmp (*(const char *const *) px, *(const char *const *) py);
+}
+
+static size_t
+common_prefix_length (const char *s, const char *t)
+{
+  size_t d = 0;
+  while (s[d] != '\0' && s[d] == t[d])
+    d += 1;
+  return d;
+}
+
+#define STRING_SORT_SMALL(BASE, NMEMB, LCP)                         \
+  UNSTABLE_STRING_SORT_6ARGS                                        \
+    ((BASE), (NMEMB), (LCP), QUICKSORTS_COMMON__PIVOT_MIDDLE, 4,    \
+     QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED)
+
+static void
+string_sort_test (bool use_function)
+{
+  const char **p1 = malloc (MAX_SZ * sizeof (const char *));
+  const char **p2 = malloc (MAX_SZ * sizeof (const char *));
+  size_t *lcp = malloc (MAX_SZ * sizeof (size_t));
+
+  printf ("Strings with shared prefixes:\n");
+  for (size_t sz = 0; sz <= MAX_SZ; sz = MAX (sz + 1, 10 * sz))
+    {
+      char *text = make_strings (sz, p1);
+      memcpy (p2, p1, sz * sizeof (const char *));
+      const long double t11 = get_clock ();
+      qsort (p1, sz, sizeof (const char *), strptrcmp);
+      const long double t12 = get_clock ();
+      if (use_function)
+        unstable_sort_strings (p2, sz, lcp);
+      else
+        UNSTABLE_STRING_SORT (p2, sz, lcp);
+      const long double t22 = get_clock ();
+      for (size_t i = 0; i != sz; i += 1)
+        {
+          CHECK (strcmp (p1[i], p2[i]) == 0);
+          CHECK (lcp[i] == ((i == 0) ? 0 :
+                            common_prefix_length (p2[i - 1], p2[i])));
+        }
+      printf ("  qsort:%Lf  ours:%Lf  %zu\n", t12 - t11, t22 - t12, sz);
+
+      /* Without the LCP array, and with tiny subarrays finished by */
+      /* insertion sort, so that the partitioning gets exercised. */
+      memcpy (p2, p1, sz * sizeof (const char *));
+      for (size_t i = sz; 1 < i; i -= 1)
+        {
+          const size_t j = (size_t) lrand48 () % i;
+          const char *tmp = p2[i - 1];
+          p2[i - 1] = p2[j];
+          p2[j] = tmp;
+        }
+      if (use_function)
+        unstable_sort_strings (p2, sz, NULL);
+      else
+        STRING_SORT_SMALL (p2, sz, NULL);
+      for (size_t i = 0; i != sz; i += 1)
+        CHECK (strcmp (p1[i], p2[i]) == 0);
+
+      free (text);
+    }
+
+  free (p1);
+  free (p2);
+  free (lcp);
+}
+
+int
+main (int argc, char *argv[])
+{
+  if (argc <= 1)
+    {
+      printf ("This program expects a command-line argument.\n");
+      exit (1);
+    }
+  sortkind_t sortkind = argv[1];
+
+  if (sortkind_eq (sortkind, "string-sort"))
+    string_sort_test (false);
+  else if (sortkind_eq (sortkind, "unstable_sort_strings"))
+    string_sort_test (true);
+  else
+    {
+      printf ("Invalid command-line argument.\n");
+      exit (1);
+    }
+
+  return 0;
+}
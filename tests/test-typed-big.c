@@ -22,6 +22,8 @@
 #include <stdint.h>
 #include <string.h>
 #include <time.h>
+#include "quicksorts/stable-quicksort.h"
+#include "quicksorts/unstable-qsort.h"
 #include "quicksorts/unstable-quicksort.h"
 
 #define MAX_SZ 100000ULL
@@ -81,6 +83,13 @@ big_t_cmp (const void *x, const void *y)
                   ((const big_t *) y)->s));
 }
 
+static int
+big_t_cmp_r (const void *x, const void *y, void *env)
+{
+  CHECK (*(int *) env == 1234);
+  return big_t_cmp (x, y);
+}
+
 static void
 initialize_array (big_t *p, size_t n)
 {
@@ -116,6 +125,15 @@ unstable_median3_insertion_typed_big (big_t *base, size_t nmemb)
      80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED);
 }
 
+static void
+unstable_adaptive_insertion_typed_big (big_t *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_TYPED_7ARGS
+    (big_t, base, nmemb, big_t_lt,
+     QUICKSORTS_COMMON__PIVOT_ADAPTIVE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED);
+}
+
 static void
 unstable_random_shell_typed_big (big_t *base, size_t nmemb)
 {
@@ -134,6 +152,55 @@ unstable_median3_shell_typed_big (big_t *base, size_t nmemb)
      350, QUICKSORTS__UNSTABLE_QUICKSORT__SHELL_SORT__TYPED);
 }
 
+static void
+unstable_median3_insertion_3way_typed_big (big_t *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_TYPED_8ARGS
+    (big_t, base, nmemb, big_t_lt,
+     QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED,
+     QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_THREE_WAY__TYPED);
+}
+
+static void
+unstable_pdq_median3_insertion_typed_big (big_t *base, size_t nmemb)
+{
+  UNSTABLE_PDQSORT_TYPED_8ARGS
+    (big_t, base, nmemb, big_t_lt,
+     QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED,
+     QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION__TYPED);
+}
+
+static void
+unstable_median3_insertion_block_typed_big (big_t *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_TYPED_8ARGS
+    (big_t, base, nmemb, big_t_lt,
+     QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED,
+     QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_BLOCK__TYPED);
+}
+
+static void
+unstable_adaptive_insertion_hole_typed_big (big_t *base, size_t nmemb)
+{
+  UNSTABLE_QUICKSORT_TYPED_8ARGS
+    (big_t, base, nmemb, big_t_lt,
+     QUICKSORTS_COMMON__PIVOT_ADAPTIVE,
+     80, QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED,
+     QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_HOLE__TYPED);
+}
+
+static void
+stable_median3_insertion_typed_big (big_t *base, size_t nmemb)
+{
+  STABLE_QUICKSORT_TYPED_7ARGS
+    (big_t, base, nmemb, big_t_lt,
+     QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE,
+     40, QUICKSORTS__STABLE_QUICKSORT__INSERTION_SORT__TYPED);
+}
+
 static void
 test_arrays (sortkind_t sortkind)
 {
@@ -192,6 +259,55 @@ test_arrays (sortkind_t sortkind)
           unstable_median3_shell_typed_big (p3, sz);
           t32 = get_clock ();
         }
+      else if (sortkind_eq (sortkind,
+                            "unstable-median3-insertion-3way-typed-big"))
+        {
+          t31 = get_clock ();
+          unstable_median3_insertion_3way_typed_big (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind,
+                            "unstable-pdq-median3-insertion-typed-big"))
+        {
+          t31 = get_clock ();
+          unstable_pdq_median3_insertion_typed_big (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind,
+                            "unstable-median3-insertion-block-typed-big"))
+        {
+          t31 = get_clock ();
+          unstable_median3_insertion_block_typed_big (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind,
+                            "unstable-adaptive-insertion-hole-typed-big"))
+        {
+          t31 = get_clock ();
+          unstable_adaptive_insertion_hole_typed_big (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "stable-median3-insertion-typed-big"))
+        {
+          t31 = get_clock ();
+          stable_median3_insertion_typed_big (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable-adaptive-insertion-typed-big"))
+        {
+          t31 = get_clock ();
+          unstable_adaptive_insertion_typed_big (p3, sz);
+          t32 = get_clock ();
+        }
+      else if (sortkind_eq (sortkind, "unstable_qsort_r-typed-big"))
+        {
+          /* Elements this big are sorted indirectly. */
+          int env_val = 1234;
+          void *env = &env_val;
+          t31 = get_clock ();
+          unstable_qsort_r (p3, sz, sizeof (big_t), big_t_cmp_r, env);
+          t32 = get_clock ();
+        }
       else
         {
           printf ("Invalid command-line argument.\n");
@@ -0,0 +1,424 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  quicksort-records: sort a file of fixed-size binary records in
+  place, by a numeric or byte-string key at a fixed offset in each
+  record.
+
+  The file is mapped into memory and sorted where it lies, so no
+  copy of it passes through buffers of ours. The top levels of
+  partitioning sweep over large ranges of the file, and are advised
+  to the kernel as sequential; each subarray small enough to be
+  sorted in one go is advised as needed soon, sorted, and then
+  written back asynchronously.
+*/
+
+#include <errno.h>
+#include <fcntl.h>
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include "quicksorts/unstable-quicksort.h"
+#include "quicksorts/unstable-radix-sort.h"
+
+#define PROGRAM_NAME "quicksort-records"
+
+/* Subarrays of at most this many bytes are, by default, sorted in
+   one go. */
+#define LEAF_BYTES ((size_t) 1 << 25)
+
+/* The key, and the order. These are the same for every comparison,
+   so they are kept here rather than passed around. */
+static size_t key_offset = 0;
+static size_t key_length = 0;   /* For byte-string keys. */
+static bool key_swap = false;   /* Whether to reverse the key bytes. */
+static bool descending = false;
+
+static size_t leaf_bytes = LEAF_BYTES;
+static size_t page_size;
+
+static void
+fail (const char *message, const char *detail)
+{
+  if (detail == NULL)
+    fprintf (stderr, "%s: %s\n", PROGRAM_NAME, message);
+  else
+    fprintf (stderr, "%s: %s: %s\n", PROGRAM_NAME, message, detail);
+  exit (1);
+}
+
+/*------------------------------------------------------------------*/
+/* Keys.                                                            */
+
+static inline uint8_t
+bswap8 (uint8_t x)
+{
+  return x;
+}
+
+static inline uint16_t
+bswap16 (uint16_t x)
+{
+  return (uint16_t) ((x >> 8) | (x << 8));
+}
+
+static inline uint32_t
+bswap32 (uint32_t x)
+{
+  return (((x & UINT32_C (0x000000FF)) << 24)
+          | ((x & UINT32_C (0x0000FF00)) << 8)
+          | ((x & UINT32_C (0x00FF0000)) >> 8)
+          | ((x & UINT32_C (0xFF000000)) >> 24));
+}
+
+static inline uint64_t
+bswap64 (uint64_t x)
+{
+  return (((uint64_t) bswap32 ((uint32_t) x) << 32)
+          | bswap32 ((uint32_t) (x >> 32)));
+}
+
+/* Load a key of type T, stored as the bits of U, and compare two by
+   ORDER of each. Floats are ordered by their radix-sort keys, a total
+   order that puts -0 before +0 and NaNs beyond the infinities of the
+   same sign, so that NaNs cannot leave the comparison inconsistent. */
+#define DEFINE_KEY(NAME, T, U, BSWAP, ORDER)                            \
+  static inline T                                                       \
+  NAME##_load (const void *p)                                           \
+  {                                                                     \
+    U bits;                                                             \
+    memcpy (&bits, (const char *) p + key_offset, sizeof bits);         \
+    if (key_swap)                                                       \
+      bits = BSWAP (bits);                                              \
+    T x;                                                                \
+    memcpy (&x, &bits, sizeof x);                                       \
+    return x;                                                           \
+  }                                                                     \
+                                                                        \
+  static inline bool                                                    \
+  NAME##_lt (const void *p, const void *q)                              \
+  {                                                                     \
+    const T x = NAME##_load (p);                                        \
+    const T y = NAME##_load (q);                                        \
+    return (descending ? (ORDER (y) < ORDER (x))                        \
+            : (ORDER (x) < ORDER (y)));                                 \
+  }
+
+#define INTEGER_ORDER(X) (X)
+
+DEFINE_KEY (i8, int8_t, uint8_t, bswap8, INTEGER_ORDER)
+DEFINE_KEY (i16, int16_t, uint16_t, bswap16, INTEGER_ORDER)
+DEFINE_KEY (i32, int32_t, uint32_t, bswap32, INTEGER_ORDER)
+DEFINE_KEY (i64, int64_t, uint64_t, bswap64, INTEGER_ORDER)
+DEFINE_KEY (u8, uint8_t, uint8_t, bswap8, INTEGER_ORDER)
+DEFINE_KEY (u16, uint16_t, uint16_t, bswap16, INTEGER_ORDER)
+DEFINE_KEY (u32, uint32_t, uint32_t, bswap32, INTEGER_ORDER)
+DEFINE_KEY (u64, uint64_t, uint64_t, bswap64, INTEGER_ORDER)
+DEFINE_KEY (f32, float, uint32_t, bswap32,
+            unstable_radix_sort_float_key)
+DEFINE_KEY (f64, double, uint64_t, bswap64,
+            unstable_radix_sort_double_key)
+
+static inline bool
+bytes_lt (const void *p, const void *q)
+{
+  const int c = memcmp ((const char *) p + key_offset,
+                        (const char *) q + key_offset, key_length);
+  return descending ? (0 < c) : (c < 0);
+}
+
+/*------------------------------------------------------------------*/
+/* Sorting.                                                         */
+
+static void
+advise (char *p, size_t len, int advice)
+{
+  /* madvise wants a page-aligned start. The advice is only advice,
+     so failures are ignored. */
+  const size_t misalignment = (size_t) (uintptr_t) p % page_size;
+  (void) madvise (p - misalignment, len + misalignment, advice);
+}
+
+static void
+written (char *p, size_t len)
+{
+  const size_t misalignment = (size_t) (uintptr_t) p % page_size;
+  (void) msync (p - misalignment, len + misalignment, MS_ASYNC);
+}
+
+/* Partition, smallest part first, down to leaves of at most
+   leaf_bytes, and sort each leaf with the quicksort. */
+#define DEFINE_SORT(NAME)                                               \
+  static void                                                           \
+  NAME##_sort (char *base, size_t nmemb, size_t size)                   \
+  {                                                                     \
+    char *sort__arr = base;                                             \
+    size_t sort__nmemb = nmemb;                                         \
+    int sort__depth;                                                    \
+    QUICKSORTS_COMMON__STK_MAKE (sort__);                               \
+    QUICKSORTS_COMMON__STK_PUSH                                         \
+      (sort__, sort__arr, sort__nmemb,                                  \
+       quicksorts_common__depth_limit (sort__nmemb));                   \
+    do                                                                  \
+      {                                                                 \
+        QUICKSORTS_COMMON__STK_POP (sort__);                            \
+        const size_t len = sort__nmemb * size;                          \
+        if (len <= leaf_bytes || sort__depth == 0)                      \
+          {                                                             \
+            advise (sort__arr, len, MADV_WILLNEED);                     \
+            UNSTABLE_QUICKSORT_8ARGS                                    \
+              (sort__arr, sort__nmemb, size, NAME##_lt,                 \
+               UNSTABLE_QUICKSORT__DEFAULT__PIVOT_SELECTION,            \
+               UNSTABLE_QUICKSORT__DEFAULT__SMALL_SIZE,                 \
+               UNSTABLE_QUICKSORT__DEFAULT__SMALL_SORT,                 \
+               QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_THREE_WAY);    \
+            written (sort__arr, len);                                   \
+          }                                                             \
+        else                                                            \
+          {                                                             \
+            char *part__arr = sort__arr;                                \
+            size_t part__nmemb = sort__nmemb;                           \
+            size_t part__elemsz = size;                                 \
+            size_t part__i_pivot;                                       \
+            size_t part__n_pivot;                                       \
+            bool part__swapped;                                         \
+            char *part__p_pivot;                                        \
+            advise (sort__arr, len, MADV_SEQUENTIAL);                   \
+            QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_THREE_WAY         \
+              (part__, NAME##_lt,                                       \
+               QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE);               \
+            (void) part__swapped;                                       \
+            (void) part__p_pivot;                                       \
+            advise (sort__arr, len, MADV_NORMAL);                       \
+            const size_t n_le = part__i_pivot;                          \
+            const size_t i_ge = part__i_pivot + part__n_pivot;          \
+            char *p_ge = sort__arr + (i_ge * size);                     \
+            const size_t n_ge = sort__nmemb - i_ge;                     \
+            /* The smaller part goes on top, to be done first. */       \
+            if (n_le < n_ge)                                            \
+              {                                                         \
+                if (2 <= n_ge)                                          \
+                  QUICKSORTS_COMMON__STK_PUSH                           \
+                    (sort__, p_ge, n_ge, sort__depth - 1);              \
+                if (2 <= n_le)                                          \
+                  QUICKSORTS_COMMON__STK_PUSH                           \
+                    (sort__, sort__arr, n_le, sort__depth - 1);         \
+              }                                                         \
+            else                                                        \
+              {                                                         \
+                if (2 <= n_le)                                          \
+                  QUICKSORTS_COMMON__STK_PUSH                           \
+                    (sort__, sort__arr, n_le, sort__depth - 1);         \
+                if (2 <= n_ge)                                          \
+                  QUICKSORTS_COMMON__STK_PUSH                           \
+                    (sort__, p_ge, n_ge, sort__depth - 1);              \
+              }                                                         \
+          }                                                             \
+      }                                                                 \
+    while (sort__stk_depth != 0);                                       \
+  }
+
+DEFINE_SORT (i8)
+DEFINE_SORT (i16)
+DEFINE_SORT (i32)
+DEFINE_SORT (i64)
+DEFINE_SORT (u8)
+DEFINE_SORT (u16)
+DEFINE_SORT (u32)
+DEFINE_SORT (u64)
+DEFINE_SORT (f32)
+DEFINE_SORT (f64)
+DEFINE_SORT (bytes)
+
+typedef void sort_t (char *base, size_t nmemb, size_t size);
+
+static const struct
+{
+  const char *name;
+  size_t size;
+  sort_t *sort;
+} key_types[] = {
+  { "i8", 1, i8_sort }, { "i16", 2, i16_sort },
+  { "i32", 4, i32_sort }, { "i64", 8, i64_sort },
+  { "u8", 1, u8_sort }, { "u16", 2, u16_sort },
+  { "u32", 4, u32_sort }, { "u64", 8, u64_sort },
+  { "f32", 4, f32_sort }, { "f64", 8, f64_sort },
+  { "bytes", 0, bytes_sort }
+};
+
+/*------------------------------------------------------------------*/
+
+static void
+usage (FILE *f)
+{
+  fprintf (f,
+           "Usage: %s -s SIZE [OPTION]... FILE\n"
+           "Sort FILE, of SIZE-byte records, in place.\n"
+           "\n"
+           "  -s, --record-size=SIZE  bytes per record\n"
+           "  -o, --key-offset=N      offset of the key in each record"
+           " (default 0)\n"
+           "  -k, --key=TYPE          the key's type (default bytes):\n"
+           "                            i8 i16 i32 i64   signed integers\n"
+           "                            u8 u16 u32 u64   unsigned"
+           " integers\n"
+           "                            f32 f64          IEEE floats,"
+           " -0 before +0\n"
+           "                                             and NaNs"
+           " beyond the\n"
+           "                                             infinities\n"
+           "                            bytes            the rest of"
+           " the record,\n"
+           "                                             compared as"
+           " by memcmp\n"
+           "                          A numeric type may end in le or"
+           " be, for\n"
+           "                          little- or big-endian; otherwise"
+           " the byte\n"
+           "                          order is the machine's.\n"
+           "  -r, --reverse           sort into descending order\n"
+           "  -L, --leaf-size=BYTES   sort parts of the file of at most"
+           " BYTES in\n"
+           "                          one go (default %zu)\n"
+           "  -h, --help              show this help\n",
+           PROGRAM_NAME, (size_t) LEAF_BYTES);
+}
+
+static size_t
+parse_size (const char *s, const char *what)
+{
+  char *end;
+  errno = 0;
+  const unsigned long long n = strtoull (s, &end, 10);
+  if (s[0] < '0' || '9' < s[0] || *end != '\0' || errno != 0
+      || SIZE_MAX < n)
+    fail ("invalid number", what);
+  return (size_t) n;
+}
+
+int
+main (int argc, char *argv[])
+{
+  static const struct option long_options[] = {
+    { "record-size", required_argument, NULL, 's' },
+    { "key-offset", required_argument, NULL, 'o' },
+    { "key", required_argument, NULL, 'k' },
+    { "reverse", no_argument, NULL, 'r' },
+    { "leaf-size", required_argument, NULL, 'L' },
+    { "help", no_argument, NULL, 'h' },
+    { NULL, 0, NULL, 0 }
+  };
+
+  size_t record_size = 0;
+  const char *key = "bytes";
+  int c;
+  while ((c = getopt_long (argc, argv, "s:o:k:rL:h", long_options, NULL))
+         != -1)
+    switch (c)
+      {
+      case 's':
+        record_size = parse_size (optarg, "record size");
+        break;
+      case 'o':
+        key_offset = parse_size (optarg, "key offset");
+        break;
+      case 'k':
+        key = optarg;
+        break;
+      case 'r':
+        descending = true;
+        break;
+      case 'L':
+        leaf_bytes = parse_size (optarg, "leaf size");
+        break;
+      case 'h':
+        usage (stdout);
+        return 0;
+      default:
+        usage (stderr);
+        return 1;
+      }
+  if (optind != argc - 1 || record_size == 0)
+    {
+      usage (stderr);
+      return 1;
+    }
+  const char *path = argv[optind];
+
+  /* The key type, and its byte order. */
+  const uint16_t one = 1;
+  const bool little_endian_host = (*(const unsigned char *) &one == 1);
+  const size_t key_len = strlen (key);
+  size_t type_len = key_len;
+  if (2 < key_len && strcmp (key, "bytes") != 0
+      && (strcmp (key + key_len - 2, "le") == 0
+          || strcmp (key + key_len - 2, "be") == 0))
+    {
+      type_len = key_len - 2;
+      key_swap = ((key[type_len] == 'l') != little_endian_host);
+    }
+  sort_t *sort = NULL;
+  size_t key_size = 0;
+  for (size_t i = 0; i != sizeof key_types / sizeof key_types[0]; i += 1)
+    if (strlen (key_types[i].name) == type_len
+        && strncmp (key_types[i].name, key, type_len) == 0)
+      {
+        sort = key_types[i].sort;
+        key_size = key_types[i].size;
+      }
+  if (sort == NULL)
+    fail ("unknown key type", key);
+  if (record_size <= key_offset || record_size - key_offset < key_size)
+    fail ("the key does not fit in the record", NULL);
+  key_length = record_size - key_offset;
+
+  const int fd = open (path, O_RDWR);
+  if (fd == -1)
+    fail (path, strerror (errno));
+  struct stat st;
+  if (fstat (fd, &st) != 0)
+    fail (path, strerror (errno));
+  const size_t file_size = (size_t) st.st_size;
+  if (file_size % record_size != 0)
+    fail (path, "the size is not a multiple of the record size");
+  const size_t nmemb = file_size / record_size;
+
+  if (2 <= nmemb)
+    {
+      const long ps = sysconf (_SC_PAGESIZE);
+      page_size = (ps < 1) ? 4096 : (size_t) ps;
+      char *base = mmap (NULL, file_size, PROT_READ | PROT_WRITE,
+                         MAP_SHARED, fd, 0);
+      if (base == MAP_FAILED)
+        fail (path, strerror (errno));
+      sort (base, nmemb, record_size);
+      if (msync (base, file_size, MS_SYNC) != 0)
+        fail (path, strerror (errno));
+      munmap (base, file_size);
+    }
+  if (close (fd) != 0)
+    fail (path, strerror (errno));
+  return 0;
+}
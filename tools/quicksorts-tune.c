@@ -0,0 +1,445 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  quicksorts-tune: time the unstable quicksort, as unstable_qsort runs
+  it, with each pivot selection, each small-subarray sort and a range
+  of small-subarray sizes, for each class of element size, and write
+  the fastest as a quicksorts/tuned-config.h.
+
+  The pivot selection and the small-subarray sort are chosen for all
+  element sizes at once, by their time summed over the classes, each
+  class weighed by its own best time. The small-subarray size is then
+  chosen for each class separately, and once more for all of them,
+  for the macros that do not know their element size.
+
+  Run with --help for the options.
+*/
+
+#include <getopt.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/utsname.h>
+#include <time.h>
+#include "quicksorts/unstable-quicksort.h"
+
+#define PROGRAM_NAME "quicksorts-tune"
+
+static int
+key_cmp (const void *p, const void *q)
+{
+  uint32_t x;
+  uint32_t y;
+  memcpy (&x, p, sizeof x);
+  memcpy (&y, q, sizeof y);
+  return (x < y) ? -1 : ((y < x) ? 1 : 0);
+}
+
+/* Called through a pointer the compiler cannot see through, as
+   unstable_qsort calls its comparison. */
+int (*tune_compar) (const void *, const void *) = key_cmp;
+
+#define TUNE_LT(p, q) (tune_compar ((p), (q)) < 0)
+
+static double
+wall_clock (void)
+{
+  struct timespec t;
+  clock_gettime (CLOCK_MONOTONIC, &t);
+  return t.tv_sec + (t.tv_nsec * 1e-9);
+}
+
+/*------------------------------------------------------------------*/
+/* The candidates.                                                  */
+
+typedef void engine_t (void *base, size_t nmemb, size_t size,
+                       size_t small_size);
+
+#define DEFINE_ENGINE(NAME, PIVOT_SELECTION, SMALL_SORT)                \
+  static void                                                           \
+  engine_##NAME (void *base, size_t nmemb, size_t size,                 \
+                 size_t small_size)                                     \
+  {                                                                     \
+    QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT_BY_SIZE                   \
+      (tune__, base, nmemb, size, TUNE_LT, PIVOT_SELECTION,             \
+       small_size, SMALL_SORT,                                          \
+       QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_THREE_WAY);            \
+  }
+
+#define DEFINE_ENGINES(PIVOT, PIVOT_SELECTION)                          \
+  DEFINE_ENGINE (PIVOT##_insertion, PIVOT_SELECTION,                    \
+                 QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT)        \
+  DEFINE_ENGINE (PIVOT##_shell, PIVOT_SELECTION,                        \
+                 QUICKSORTS__UNSTABLE_QUICKSORT__SHELL_SORT)            \
+  DEFINE_ENGINE (PIVOT##_network, PIVOT_SELECTION,                      \
+                 QUICKSORTS__UNSTABLE_QUICKSORT__NETWORK_SORT)
+
+DEFINE_ENGINES (random, QUICKSORTS_COMMON__PIVOT_RANDOM)
+DEFINE_ENGINES (middle, QUICKSORTS_COMMON__PIVOT_MIDDLE)
+DEFINE_ENGINES (median3, QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE)
+DEFINE_ENGINES (adaptive, QUICKSORTS_COMMON__PIVOT_ADAPTIVE)
+
+static const char *const pivots[] = {
+  "QUICKSORTS_COMMON__PIVOT_RANDOM",
+  "QUICKSORTS_COMMON__PIVOT_MIDDLE",
+  "QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE",
+  "QUICKSORTS_COMMON__PIVOT_ADAPTIVE"
+};
+#define N_PIVOTS (sizeof pivots / sizeof pivots[0])
+
+static const char *const small_sorts[] = {
+  "QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT",
+  "QUICKSORTS__UNSTABLE_QUICKSORT__SHELL_SORT",
+  "QUICKSORTS__UNSTABLE_QUICKSORT__NETWORK_SORT"
+};
+#define N_SMALL_SORTS (sizeof small_sorts / sizeof small_sorts[0])
+
+#define ENGINES(PIVOT)                                                  \
+  { engine_##PIVOT##_insertion, engine_##PIVOT##_shell,                 \
+    engine_##PIVOT##_network }
+
+static engine_t *const engines[N_PIVOTS][N_SMALL_SORTS] = {
+  ENGINES (random),
+  ENGINES (middle),
+  ENGINES (median3),
+  ENGINES (adaptive)
+};
+
+/* A sorting network does many more comparisons than the other small
+   sorts, and is not tried on subarrays larger than this. */
+#define NETWORK_MAX_SIZE 64
+
+static const size_t small_sizes[] = {
+  8, 12, 16, 24, 32, 48, 64, 80, 96, 128, 192, 256, 350
+};
+#define N_SMALL_SIZES (sizeof small_sizes / sizeof small_sizes[0])
+
+/* The classes of element size. The last stands for every size
+   without a class of its own, which unstable_qsort sorts bytewise. */
+static const size_t elemszs[] = { 4, 8, 16, 24, 32, 64, 12 };
+#define N_ELEMSZS (sizeof elemszs / sizeof elemszs[0])
+#define OTHER_ELEMSZ (N_ELEMSZS - 1)
+
+/*------------------------------------------------------------------*/
+
+static void
+fail (const char *message, const char *detail)
+{
+  if (detail == NULL)
+    fprintf (stderr, "%s: %s\n", PROGRAM_NAME, message);
+  else
+    fprintf (stderr, "%s: %s: %s\n", PROGRAM_NAME, message, detail);
+  exit (1);
+}
+
+/* The least time, over the repetitions, to sort a copy of
+   pristine. */
+static double
+time_sort (engine_t *sort, const char *pristine, char *work,
+           size_t nmemb, size_t elemsz, size_t small_size,
+           size_t repetitions)
+{
+  double best = 0;
+  for (size_t r = 0; r != repetitions; r += 1)
+    {
+      memcpy (work, pristine, nmemb * elemsz);
+      const double t0 = wall_clock ();
+      sort (work, nmemb, elemsz, small_size);
+      const double t = wall_clock () - t0;
+      if (r == 0 || t < best)
+        best = t;
+      for (size_t i = 1; i < nmemb; i += 1)
+        if (0 < key_cmp (work + ((i - 1) * elemsz), work + (i * elemsz)))
+          fail ("a sort left its array out of order", NULL);
+    }
+  return best;
+}
+
+/* Print a #define whose body is on the lines that follow, with the
+   backslashes lined up. */
+static void
+print_define (FILE *f, const char *head, const char *const *body,
+              size_t n_body)
+{
+  size_t width = strlen (head);
+  for (size_t i = 0; i != n_body; i += 1)
+    if (width < strlen (body[i]))
+      width = strlen (body[i]);
+  fprintf (f, "#define %-*s \\\n", (int) (width - strlen ("#define ")),
+           head + strlen ("#define "));
+  for (size_t i = 0; i != n_body; i += 1)
+    {
+      if (i + 1 == n_body)
+        fprintf (f, "%s\n", body[i]);
+      else
+        fprintf (f, "%-*s \\\n", (int) width, body[i]);
+    }
+  fprintf (f, "\n");
+}
+
+static void
+usage (FILE *f)
+{
+  fprintf (f,
+           "Usage: " PROGRAM_NAME " [OPTION]...\n"
+           "\n"
+           "  -n, --nmemb=N           elements per array"
+           " (default 50000)\n"
+           "  -r, --repetitions=N     timed runs of each candidate"
+           " (default 5)\n"
+           "  -o, --output=FILE       where to write the header"
+           " (default stdout)\n"
+           "  -v, --verbose           report every timing on"
+           " stderr\n"
+           "  -h, --help              show this help\n");
+}
+
+static const struct option long_options[] = {
+  { "nmemb", required_argument, NULL, 'n' },
+  { "repetitions", required_argument, NULL, 'r' },
+  { "output", required_argument, NULL, 'o' },
+  { "verbose", no_argument, NULL, 'v' },
+  { "help", no_argument, NULL, 'h' },
+  { NULL, 0, NULL, 0 }
+};
+
+int
+main (int argc, char *argv[])
+{
+  size_t nmemb = 50000;
+  size_t repetitions = 5;
+  const char *output = NULL;
+  bool verbose = false;
+
+  int c;
+  while ((c = getopt_long (argc, argv, "n:r:o:vh",
+                           long_options, NULL)) != -1)
+    switch (c)
+      {
+      case 'n':
+        nmemb = strtoul (optarg, NULL, 10);
+        break;
+      case 'r':
+        repetitions = strtoul (optarg, NULL, 10);
+        break;
+      case 'o':
+        output = optarg;
+        break;
+      case 'v':
+        verbose = true;
+        break;
+      case 'h':
+        usage (stdout);
+        return 0;
+      default:
+        usage (stderr);
+        return 1;
+      }
+  if (repetitions == 0)
+    repetitions = 1;
+  if (nmemb < 2)
+    nmemb = 2;
+
+  /* times[e][p][s][k]: the time for element-size class e, pivot
+     selection p, small sort s and small-subarray size k, or zero
+     if that combination is not tried. */
+  static double times[N_ELEMSZS][N_PIVOTS][N_SMALL_SORTS][N_SMALL_SIZES];
+
+  char *pristine = malloc (nmemb * 64);
+  char *work = malloc (nmemb * 64);
+  if (pristine == NULL || work == NULL)
+    fail ("out of memory", NULL);
+
+  for (size_t e = 0; e != N_ELEMSZS; e += 1)
+    {
+      const size_t elemsz = elemszs[e];
+      srand48 (12345);
+      for (size_t i = 0; i != nmemb * elemsz; i += 1)
+        pristine[i] = (char) (lrand48 () >> 7);
+
+      for (size_t p = 0; p != N_PIVOTS; p += 1)
+        for (size_t s = 0; s != N_SMALL_SORTS; s += 1)
+          for (size_t k = 0; k != N_SMALL_SIZES; k += 1)
+            {
+              if (s == 2 && NETWORK_MAX_SIZE < small_sizes[k])
+                continue;
+              times[e][p][s][k] =
+                time_sort (engines[p][s], pristine, work, nmemb, elemsz,
+                           small_sizes[k], repetitions);
+              if (verbose)
+                fprintf (stderr, "%2zu %-40s %-46s %4zu %8.2f ns\n",
+                         elemsz, pivots[p], small_sorts[s],
+                         small_sizes[k], times[e][p][s][k] * 1e9 / nmemb);
+            }
+    }
+
+  /* The best time for each class, to weigh the classes by. */
+  double best_of_class[N_ELEMSZS];
+  for (size_t e = 0; e != N_ELEMSZS; e += 1)
+    {
+      best_of_class[e] = 0;
+      for (size_t p = 0; p != N_PIVOTS; p += 1)
+        for (size_t s = 0; s != N_SMALL_SORTS; s += 1)
+          for (size_t k = 0; k != N_SMALL_SIZES; k += 1)
+            if (times[e][p][s][k] != 0
+                && (best_of_class[e] == 0
+                    || times[e][p][s][k] < best_of_class[e]))
+              best_of_class[e] = times[e][p][s][k];
+    }
+
+  /* The pivot selection and small sort, each class at its best
+     small-subarray size. */
+  size_t best_p = 0;
+  size_t best_s = 0;
+  double best_score = 0;
+  for (size_t p = 0; p != N_PIVOTS; p += 1)
+    for (size_t s = 0; s != N_SMALL_SORTS; s += 1)
+      {
+        double score = 0;
+        for (size_t e = 0; e != N_ELEMSZS; e += 1)
+          {
+            double t = 0;
+            for (size_t k = 0; k != N_SMALL_SIZES; k += 1)
+              if (times[e][p][s][k] != 0
+                  && (t == 0 || times[e][p][s][k] < t))
+                t = times[e][p][s][k];
+            score += t / best_of_class[e];
+          }
+        if ((p == 0 && s == 0) || score < best_score)
+          {
+            best_p = p;
+            best_s = s;
+            best_score = score;
+          }
+      }
+
+  /* The small-subarray size for each class, and for all of them. */
+  size_t best_k_of_class[N_ELEMSZS];
+  size_t best_k = 0;
+  double best_k_score = 0;
+  for (size_t e = 0; e != N_ELEMSZS; e += 1)
+    best_k_of_class[e] = 0;
+  for (size_t k = 0; k != N_SMALL_SIZES; k += 1)
+    if (times[0][best_p][best_s][k] != 0)
+      {
+        double score = 0;
+        for (size_t e = 0; e != N_ELEMSZS; e += 1)
+          {
+            const double t = times[e][best_p][best_s][k];
+            if (t < times[e][best_p][best_s][best_k_of_class[e]])
+              best_k_of_class[e] = k;
+            score += t / best_of_class[e];
+          }
+        if (best_k_score == 0 || score < best_k_score)
+          {
+            best_k = k;
+            best_k_score = score;
+          }
+      }
+
+  FILE *f = stdout;
+  if (output != NULL && (f = fopen (output, "w")) == NULL)
+    fail ("cannot open for writing", output);
+
+  struct utsname host;
+  if (uname (&host) != 0)
+    strcpy (host.machine, "unknown");
+
+  fprintf (f,
+           "/*\n"
+           "  Copyright © 2022 Barry Schwartz\n"
+           "\n"
+           "  This program is free software: you can redistribute it"
+           " and/or\n"
+           "  modify it under the terms of the GNU General Public"
+           " License, as\n"
+           "  published by the Free Software Foundation, either"
+           " version 3 of the\n"
+           "  License, or (at your option) any later version.\n"
+           "\n"
+           "  This program is distributed in the hope that it will be"
+           " useful, but\n"
+           "  WITHOUT ANY WARRANTY; without even the implied warranty"
+           " of\n"
+           "  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See"
+           " the GNU\n"
+           "  General Public License for more details.\n"
+           "\n"
+           "  You should have received copies of the GNU General"
+           " Public License\n"
+           "  along with this program. If not, see\n"
+           "  <https://www.gnu.org/licenses/>.\n"
+           "*/\n"
+           "\n"
+           "#ifndef QUICKSORTS__TUNED_CONFIG_H__HEADER_GUARD__\n"
+           "#define QUICKSORTS__TUNED_CONFIG_H__HEADER_GUARD__\n"
+           "\n"
+           "/*\n"
+           "  Host-tuned defaults for the unstable quicksorts.\n"
+           "\n"
+           "  Written by " PROGRAM_NAME " on a %s machine, from"
+           " arrays of %zu\n"
+           "  random elements. Times are per element, for the chosen"
+           " pivot\n"
+           "  selection and small sort:\n"
+           "\n",
+           host.machine, nmemb);
+  for (size_t e = 0; e != N_ELEMSZS; e += 1)
+    fprintf (f, "    %s %2zu bytes: small size %3zu, %7.2f ns\n",
+             (e == OTHER_ELEMSZ) ? "other, as" : "         ",
+             elemszs[e], small_sizes[best_k_of_class[e]],
+             times[e][best_p][best_s][best_k_of_class[e]] * 1e9 / nmemb);
+  fprintf (f, "*/\n\n");
+
+  char line[N_ELEMSZS + 1][128];
+  const char *body[N_ELEMSZS + 1];
+  for (size_t i = 0; i != N_ELEMSZS + 1; i += 1)
+    body[i] = line[i];
+
+  snprintf (line[0], sizeof line[0], "  %s", pivots[best_p]);
+  print_define (f, "#define QUICKSORTS_TUNED__PIVOT_SELECTION", body, 1);
+  snprintf (line[0], sizeof line[0], "  %s", small_sorts[best_s]);
+  print_define (f, "#define QUICKSORTS_TUNED__SMALL_SORT", body, 1);
+  snprintf (line[0], sizeof line[0], "  %s__TYPED", small_sorts[best_s]);
+  print_define (f, "#define QUICKSORTS_TUNED__SMALL_SORT__TYPED", body, 1);
+  fprintf (f, "#define QUICKSORTS_TUNED__SMALL_SIZE %zu\n\n",
+           small_sizes[best_k]);
+
+  fprintf (f, "/* The small-subarray size for elements of ELEMSZ"
+           " bytes. */\n");
+  for (size_t e = 0; e != OTHER_ELEMSZ; e += 1)
+    snprintf (line[e], sizeof line[e], "  %s(ELEMSZ) == %zu ? %zu :",
+              (e == 0) ? "(" : " ", elemszs[e],
+              small_sizes[best_k_of_class[e]]);
+  snprintf (line[OTHER_ELEMSZ], sizeof line[OTHER_ELEMSZ], "   %zu)",
+            small_sizes[best_k_of_class[OTHER_ELEMSZ]]);
+  print_define (f, "#define QUICKSORTS_TUNED__SMALL_SIZE_BY_ELEMSZ(ELEMSZ)",
+                body, N_ELEMSZS);
+
+  fprintf (f, "#endif /* QUICKSORTS__TUNED_CONFIG_H__HEADER_GUARD__ */\n");
+
+  if (f != stdout && fclose (f) != 0)
+    fail ("error writing", output);
+
+  free (pristine);
+  free (work);
+  return 0;
+}
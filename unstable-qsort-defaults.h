@@ -0,0 +1,68 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+/*
+  The defaults shared by the library's unstable quicksorts:
+  unstable_qsort and unstable_qsort_r, their _stats and _indirect
+  forms, and the plans. Each may be overridden with -D when the
+  library is built.
+*/
+
+#ifndef QUICKSORTS__UNSTABLE_QSORT_DEFAULTS_H__HEADER_GUARD__
+#define QUICKSORTS__UNSTABLE_QSORT_DEFAULTS_H__HEADER_GUARD__
+
+#include "quicksorts/unstable-quicksort.h"
+
+#ifndef PIVOT_SELECTION
+#define PIVOT_SELECTION QUICKSORTS_TUNED__PIVOT_SELECTION
+#endif
+
+/* The small-subarray size for elements of ELEMSZ bytes. */
+#ifndef SMALL_SIZE_BY_ELEMSZ
+#define SMALL_SIZE_BY_ELEMSZ(ELEMSZ)                    \
+  QUICKSORTS_TUNED__SMALL_SIZE_BY_ELEMSZ (ELEMSZ)
+#endif
+
+#ifndef SMALL_SORT
+#define SMALL_SORT QUICKSORTS_TUNED__SMALL_SORT
+#endif
+
+#ifndef SMALL_SORT__TYPED
+#define SMALL_SORT__TYPED QUICKSORTS_TUNED__SMALL_SORT__TYPED
+#endif
+
+#ifndef PARTITION
+#define PARTITION QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_THREE_WAY
+#endif
+
+#ifndef PARTITION__TYPED
+#define PARTITION__TYPED                                        \
+  QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_THREE_WAY__TYPED
+#endif
+
+/* For elements of HOLE_PARTITION_SIZE bytes or more. */
+
+#ifndef LARGE_PIVOT_SELECTION
+#define LARGE_PIVOT_SELECTION QUICKSORTS_COMMON__PIVOT_ADAPTIVE
+#endif
+
+#ifndef LARGE_PARTITION
+#define LARGE_PARTITION QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_HOLE
+#endif
+
+#endif /* QUICKSORTS__UNSTABLE_QSORT_DEFAULTS_H__HEADER_GUARD__ */
@@ -0,0 +1,476 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#include <errno.h>
+#include <pthread.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <string.h>
+#include <unistd.h>
+#include "quicksorts/unstable-external-sort.h"
+#include "quicksorts/unstable-qsort.h"
+
+typedef struct
+{
+  int (*compar) (const void *, const void *, void *);
+  void *arg;
+  size_t size;
+} order_t;
+
+/*------------------------------------------------------------------*/
+/* Files.                                                           */
+
+static FILE *
+make_temp (const char *tmpdir)
+{
+  if (tmpdir == NULL)
+    tmpdir = getenv ("TMPDIR");
+  if (tmpdir == NULL || tmpdir[0] == '\0')
+    tmpdir = "/tmp";
+
+  static const char name[] = "/quicksorts-XXXXXX";
+  const size_t len = strlen (tmpdir);
+  char *path = malloc (len + sizeof name);
+  if (path == NULL)
+    return NULL;
+  memcpy (path, tmpdir, len);
+  memcpy (path + len, name, sizeof name);
+
+  FILE *f = NULL;
+  const int fd = mkstemp (path);
+  if (fd != -1)
+    {
+      unlink (path);
+      f = fdopen (fd, "w+b");
+      if (f == NULL)
+        {
+          const int saved = errno;
+          close (fd);
+          errno = saved;
+        }
+    }
+  free (path);
+  return f;
+}
+
+static int
+write_records (FILE *f, const char *buf, size_t n, size_t size)
+{
+  if (n != 0 && fwrite (buf, size, n, f) != n)
+    {
+      if (errno == 0)
+        errno = EIO;
+      return -1;
+    }
+  return 0;
+}
+
+/* Read up to cap records. A trailing part of a record is an error. */
+static int
+read_records (FILE *f, char *buf, size_t cap, size_t size, size_t *n)
+{
+  const size_t nbytes = fread (buf, 1, cap * size, f);
+  *n = nbytes / size;
+  if (ferror (f))
+    {
+      if (errno == 0)
+        errno = EIO;
+      return -1;
+    }
+  if (nbytes % size != 0)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+  return 0;
+}
+
+/* A chunk read on another thread. */
+typedef struct
+{
+  FILE *in;
+  char *buf;
+  size_t cap;
+  size_t size;
+  size_t n;
+  int status;
+  int err;
+} chunk_read_t;
+
+static void *
+read_chunk (void *arg)
+{
+  chunk_read_t *rd = arg;
+  errno = 0;
+  rd->status = read_records (rd->in, rd->buf, rd->cap, rd->size, &rd->n);
+  rd->err = errno;
+  return NULL;
+}
+
+/*------------------------------------------------------------------*/
+/* Merging.                                                         */
+
+typedef struct
+{
+  FILE *f;
+  char *buf;
+  size_t n;
+  size_t i;
+} source_t;
+
+typedef struct
+{
+  const order_t *order;
+  source_t *sources;
+  size_t k;
+  size_t cap;
+
+  /* loser[t], for 0 < t < k, is the source that lost the match at
+     node t; loser[0] is the overall winner. Source i is a leaf
+     below node (i + k) / 2. */
+  size_t *loser;
+} merge_t;
+
+static int
+refill (merge_t *m, source_t *src)
+{
+  src->i = 0;
+  return read_records (src->f, src->buf, m->cap, m->order->size,
+                       &src->n);
+}
+
+/* Whether source a's record goes out before source b's. Index k is a
+   sentinel that wins every match, so that the tree can be filled in
+   one leaf at a time; exhausted sources lose every match. Ties go to
+   the lower-numbered source. */
+static bool
+beats (const merge_t *m, size_t a, size_t b)
+{
+  if (a == m->k)
+    return true;
+  if (b == m->k)
+    return false;
+  const source_t *sa = &m->sources[a];
+  const source_t *sb = &m->sources[b];
+  if (sa->i == sa->n)
+    return false;
+  if (sb->i == sb->n)
+    return true;
+  const size_t size = m->order->size;
+  const int c = m->order->compar (sa->buf + (sa->i * size),
+                                  sb->buf + (sb->i * size),
+                                  m->order->arg);
+  return (c < 0 || (c == 0 && a < b));
+}
+
+/* Replay the matches from leaf s to the root. */
+static void
+adjust (merge_t *m, size_t s)
+{
+  for (size_t t = (s + m->k) / 2; t != 0; t /= 2)
+    if (beats (m, m->loser[t], s))
+      {
+        const size_t winner = m->loser[t];
+        m->loser[t] = s;
+        s = winner;
+      }
+  m->loser[0] = s;
+}
+
+/* Merge k sorted runs into out, with the memory divided evenly among
+   k input buffers and one output buffer. */
+static int
+merge_runs (FILE **runs, size_t k, FILE *out, const order_t *order,
+            size_t memory)
+{
+  const size_t size = order->size;
+  size_t cap = memory / ((k + 1) * size);
+  if (cap == 0)
+    cap = 1;
+
+  int status = -1;
+  merge_t m;
+  m.order = order;
+  m.k = k;
+  m.cap = cap;
+  m.sources = calloc (k, sizeof (source_t));
+  m.loser = malloc (k * sizeof (size_t));
+  char *outbuf = malloc (cap * size);
+  if (m.sources == NULL || m.loser == NULL || outbuf == NULL)
+    goto done;
+
+  for (size_t i = 0; i != k; i += 1)
+    {
+      m.sources[i].f = runs[i];
+      m.sources[i].buf = malloc (cap * size);
+      if (m.sources[i].buf == NULL || fseek (runs[i], 0, SEEK_SET) != 0
+          || refill (&m, &m.sources[i]) != 0)
+        goto done;
+    }
+
+  for (size_t t = 0; t != k; t += 1)
+    m.loser[t] = k;
+  for (size_t i = k; i != 0; i -= 1)
+    adjust (&m, i - 1);
+
+  size_t n_out = 0;
+  for (;;)
+    {
+      const size_t w = m.loser[0];
+      source_t *src = &m.sources[w];
+      if (src->i == src->n)
+        break;                  /* Every source is exhausted. */
+      memcpy (outbuf + (n_out * size), src->buf + (src->i * size), size);
+      n_out += 1;
+      if (n_out == cap)
+        {
+          if (write_records (out, outbuf, n_out, size) != 0)
+            goto done;
+          n_out = 0;
+        }
+      src->i += 1;
+      if (src->i == src->n && refill (&m, src) != 0)
+        goto done;
+      adjust (&m, w);
+    }
+  if (write_records (out, outbuf, n_out, size) != 0 || fflush (out) != 0)
+    goto done;
+  status = 0;
+
+done:
+  {
+    const int saved = errno;
+    if (m.sources != NULL)
+      for (size_t i = 0; i != k; i += 1)
+        free (m.sources[i].buf);
+    free (m.sources);
+    free (m.loser);
+    free (outbuf);
+    errno = saved;
+  }
+  return status;
+}
+
+/*------------------------------------------------------------------*/
+
+typedef struct
+{
+  FILE **runs;
+  size_t n;
+  size_t allocated;
+} run_list_t;
+
+static int
+add_run (run_list_t *list, FILE *f)
+{
+  if (list->n == list->allocated)
+    {
+      const size_t allocated = (list->allocated == 0) ?
+        16 : 2 * list->allocated;
+      FILE **p = realloc (list->runs, allocated * sizeof (FILE *));
+      if (p == NULL)
+        return -1;
+      list->runs = p;
+      list->allocated = allocated;
+    }
+  list->runs[list->n] = f;
+  list->n += 1;
+  return 0;
+}
+
+static void
+close_runs (run_list_t *list)
+{
+  for (size_t i = 0; i != list->n; i += 1)
+    fclose (list->runs[i]);
+  free (list->runs);
+  list->runs = NULL;
+  list->n = 0;
+  list->allocated = 0;
+}
+
+/* Read, sort and write out the runs. If the whole input fits in one
+   chunk, it goes straight to out and no runs are made. */
+static int
+make_runs (FILE *in, FILE *out, const order_t *order, size_t memory,
+           const char *tmpdir, run_list_t *runs)
+{
+  const size_t size = order->size;
+  size_t cap = (memory / 2) / size;
+  if (cap == 0)
+    cap = 1;
+
+  int status = -1;
+  char *bufs[2];
+  bufs[0] = malloc (cap * size);
+  bufs[1] = malloc (cap * size);
+  if (bufs[0] == NULL || bufs[1] == NULL)
+    goto done;
+
+  size_t n;
+  if (read_records (in, bufs[0], cap, size, &n) != 0)
+    goto done;
+  if (n < cap)
+    {
+      unstable_qsort_r (bufs[0], n, size, order->compar, order->arg);
+      if (write_records (out, bufs[0], n, size) != 0
+          || fflush (out) != 0)
+        goto done;
+      status = 0;
+      goto done;
+    }
+
+  int cur = 0;
+  while (n != 0)
+    {
+      /* Read the next chunk while this one is sorted and written. */
+      chunk_read_t rd = {
+        .in = in, .buf = bufs[1 - cur], .cap = cap, .size = size,
+        .n = 0, .status = 0, .err = 0
+      };
+      pthread_t reader;
+      const bool threaded =
+        (n == cap
+         && pthread_create (&reader, NULL, read_chunk, &rd) == 0);
+
+      unstable_qsort_r (bufs[cur], n, size, order->compar, order->arg);
+      FILE *f = make_temp (tmpdir);
+      int run_status = (f == NULL) ? -1 : add_run (runs, f);
+      if (run_status != 0 && f != NULL)
+        {
+          const int saved = errno;
+          fclose (f);
+          errno = saved;
+        }
+      if (run_status == 0)
+        run_status = write_records (f, bufs[cur], n, size);
+      if (run_status == 0 && fflush (f) != 0)
+        run_status = -1;
+      const int run_err = errno;
+
+      if (threaded)
+        pthread_join (reader, NULL);
+      else if (n == cap)
+        read_chunk (&rd);
+      if (run_status != 0)
+        {
+          errno = run_err;
+          goto done;
+        }
+      if (rd.status != 0)
+        {
+          errno = rd.err;
+          goto done;
+        }
+      n = rd.n;
+      cur = 1 - cur;
+    }
+  status = 0;
+
+done:
+  {
+    const int saved = errno;
+    free (bufs[0]);
+    free (bufs[1]);
+    errno = saved;
+  }
+  return status;
+}
+
+int
+unstable_external_sort_r (FILE *in, FILE *out, size_t size,
+                          int (*compar) (const void *, const void *,
+                                         void *),
+                          void *arg,
+                          const struct unstable_external_sort_config
+                          *config)
+{
+  size_t memory = (config == NULL) ? 0 : config->memory;
+  if (memory == 0)
+    memory = QUICKSORTS__UNSTABLE_EXTERNAL_SORT__MEMORY;
+  size_t fan_in = (config == NULL) ? 0 : config->fan_in;
+  if (fan_in == 0)
+    fan_in = QUICKSORTS__UNSTABLE_EXTERNAL_SORT__FAN_IN;
+  const char *tmpdir = (config == NULL) ? NULL : config->tmpdir;
+
+  if (size == 0 || fan_in < 2)
+    {
+      errno = EINVAL;
+      return -1;
+    }
+
+  const order_t order = { .compar = compar, .arg = arg, .size = size };
+  run_list_t runs = { .runs = NULL, .n = 0, .allocated = 0 };
+  int status = make_runs (in, out, &order, memory, tmpdir, &runs);
+
+  /* Merge fan_in runs at a time, until there are few enough left to
+     merge into the output. */
+  while (status == 0 && fan_in < runs.n)
+    {
+      run_list_t merged = { .runs = NULL, .n = 0, .allocated = 0 };
+      for (size_t i = 0; status == 0 && i < runs.n; i += fan_in)
+        {
+          const size_t k =
+            (fan_in < runs.n - i) ? fan_in : runs.n - i;
+          FILE *f = (k == 1) ? runs.runs[i] : make_temp (tmpdir);
+          if (f == NULL)
+            status = -1;
+          else if (add_run (&merged, f) != 0)
+            {
+              if (k != 1)
+                fclose (f);
+              status = -1;
+            }
+          else if (k == 1)
+            runs.runs[i] = NULL;    /* It has moved to the new list. */
+          else
+            status = merge_runs (runs.runs + i, k, f, &order, memory);
+        }
+      const int saved = errno;
+      for (size_t i = 0; i != runs.n; i += 1)
+        if (runs.runs[i] != NULL)
+          fclose (runs.runs[i]);
+      free (runs.runs);
+      runs = merged;
+      errno = saved;
+    }
+  if (status == 0 && runs.n != 0)
+    status = merge_runs (runs.runs, runs.n, out, &order, memory);
+
+  const int saved = errno;
+  close_runs (&runs);
+  errno = saved;
+  return status;
+}
+
+static int
+call_compar (const void *x, const void *y, void *arg)
+{
+  int (*const *compar) (const void *, const void *) = arg;
+  return (*compar) (x, y);
+}
+
+int
+unstable_external_sort (FILE *in, FILE *out, size_t size,
+                        int (*compar) (const void *, const void *),
+                        const struct unstable_external_sort_config
+                        *config)
+{
+  return unstable_external_sort_r (in, out, size, call_compar, &compar,
+                                   config);
+}
@@ -0,0 +1,44 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#include "quicksorts/unstable-qsort.h"
+#include "quicksorts/unstable-sort-by-key.h"
+
+#undef KEY_FUNCTION
+#define KEY_FUNCTION(p)                         \
+  (quicksorts__unstable_quicksort__key (p))
+
+/* Without a comparison function, the keys are the whole order. */
+#undef LT_PREDICATE
+#define LT_PREDICATE(x, y)                                          \
+  ((quicksorts__unstable_quicksort__compar != NULL) ?               \
+   (quicksorts__unstable_quicksort__compar ((x), (y)) < 0) :        \
+   (KEY_FUNCTION (x) < KEY_FUNCTION (y)))
+
+void
+unstable_qsort_by_key (void *base, size_t nmemb, size_t size,
+                       uint64_t (*quicksorts__unstable_quicksort__key)
+                       (const void *),
+                       int (*quicksorts__unstable_quicksort__compar)
+                       (const void *, const void *))
+{
+  QUICKSORTS__UNSTABLE_SORT_BY_KEY__SORT
+    (quicksorts__unstable_sort_by_key__, base, nmemb, size,
+     KEY_FUNCTION, LT_PREDICATE,
+     quicksorts__unstable_quicksort__compar != NULL);
+}
@@ -0,0 +1,42 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#include "quicksorts/unstable-qsort.h"
+#include "quicksorts/unstable-quicksort.h"
+#include "unstable-qsort-defaults.h"
+
+#undef LT_PREDICATE
+#define LT_PREDICATE(x, y)                                  \
+  (quicksorts__unstable_quicksort__compar ((x), (y)) < 0)
+
+/* Compare the elements that two entries of the pointer array point
+   to. */
+#undef LT_INDIRECT
+#define LT_INDIRECT(x, y)                                       \
+  LT_PREDICATE (*(char *const *) (x), *(char *const *) (y))
+
+void
+unstable_qsort_indirect (void *base, size_t nmemb, size_t size,
+                         int (*quicksorts__unstable_quicksort__compar)
+                         (const void *, const void *))
+{
+  QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT_INDIRECT
+    (quicksorts__unstable_quicksort__, base, nmemb, size, LT_PREDICATE,
+     LT_INDIRECT, PIVOT_SELECTION,
+     SMALL_SIZE_BY_ELEMSZ (sizeof (char *)), SMALL_SORT, PARTITION);
+}
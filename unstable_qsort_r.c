@@ -18,31 +18,31 @@
 
 #include "quicksorts/unstable-qsort.h"
 #include "quicksorts/unstable-quicksort.h"
+#include "unstable-qsort-defaults.h"
 
 #undef LT_PREDICATE
 #define LT_PREDICATE(x, y)                              \
   (quicksorts__unstable_quicksort__compar               \
    ((x), (y), quicksorts__unstable_quicksort__env) < 0)
 
-#ifndef PIVOT_SELECTION
-#define PIVOT_SELECTION QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE
-#endif
-
-#ifndef SMALL_SIZE
-#define SMALL_SIZE 80
-#endif
-
-#ifndef SMALL_SORT
-#define SMALL_SORT QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT
-#endif
-
 void
 unstable_qsort_r (void *base, size_t nmemb, size_t size,
                   int (*quicksorts__unstable_quicksort__compar)
                   (const void *, const void *, void *),
                   void *quicksorts__unstable_quicksort__env)
 {
-  UNSTABLE_QUICKSORT_7ARGS (base, nmemb, size,
-                            LT_PREDICATE, PIVOT_SELECTION,
-                            SMALL_SIZE, SMALL_SORT);
+  if ((QUICKSORTS__UNSTABLE_QSORT__INDIRECT_SIZE) <= size)
+    unstable_qsort_r_indirect (base, nmemb, size,
+                               quicksorts__unstable_quicksort__compar,
+                               quicksorts__unstable_quicksort__env);
+  else if ((QUICKSORTS__UNSTABLE_QUICKSORT__HOLE_PARTITION_SIZE) <= size)
+    QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT
+      (quicksorts__unstable_quicksort__, base, nmemb, size,
+       LT_PREDICATE, LARGE_PIVOT_SELECTION, SMALL_SIZE_BY_ELEMSZ (size),
+       SMALL_SORT, LARGE_PARTITION);
+  else
+    QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT_BY_SIZE
+      (quicksorts__unstable_quicksort__, base, nmemb, size,
+       LT_PREDICATE, PIVOT_SELECTION, SMALL_SIZE_BY_ELEMSZ (size),
+       SMALL_SORT, PARTITION);
 }
@@ -0,0 +1,93 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#include "quicksorts/unstable-qsort-parallel.h"
+#include "quicksorts/unstable-quicksort.h"
+
+#undef LT_PREDICATE
+#define LT_PREDICATE(x, y)                              \
+  (quicksorts__unstable_quicksort__compar               \
+   ((x), (y), quicksorts__unstable_quicksort__env) < 0)
+
+#ifndef PIVOT_SELECTION
+#define PIVOT_SELECTION QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE
+#endif
+
+#ifndef SMALL_SIZE
+#define SMALL_SIZE 80
+#endif
+
+#ifndef SMALL_SORT
+#define SMALL_SORT QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT
+#endif
+
+#ifndef PARTITION
+#define PARTITION QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_THREE_WAY
+#endif
+
+typedef struct
+{
+  int (*compar) (const void *, const void *, void *);
+  void *arg;
+} context_t;
+
+static void
+sort (const struct quicksorts__unstable_qsort_parallel__sorter *sorter,
+      void *base, size_t nmemb)
+{
+  const context_t *context = sorter->context;
+  int (*quicksorts__unstable_quicksort__compar) (const void *,
+                                                 const void *, void *) =
+    context->compar;
+  void *quicksorts__unstable_quicksort__env = context->arg;
+  UNSTABLE_QUICKSORT_8ARGS (base, nmemb, sorter->elemsz,
+                            LT_PREDICATE, PIVOT_SELECTION,
+                            SMALL_SIZE, SMALL_SORT, PARTITION);
+}
+
+static void
+partition (const struct quicksorts__unstable_qsort_parallel__sorter
+           *sorter, void *base, size_t nmemb, size_t *n_le, size_t *i_ge)
+{
+  const context_t *context = sorter->context;
+  int (*quicksorts__unstable_quicksort__compar) (const void *,
+                                                 const void *, void *) =
+    context->compar;
+  void *quicksorts__unstable_quicksort__env = context->arg;
+  QUICKSORTS__UNSTABLE_QSORT_PARALLEL__PARTITION
+    (quicksorts__unstable_qsort_parallel__, base, nmemb, sorter->elemsz,
+     LT_PREDICATE, PIVOT_SELECTION, PARTITION, n_le, i_ge);
+}
+
+void
+unstable_qsort_r_parallel (void *base, size_t nmemb, size_t size,
+                           int (*compar) (const void *, const void *,
+                                          void *),
+                           void *arg)
+{
+  const context_t context = { .compar = compar, .arg = arg };
+  const struct quicksorts__unstable_qsort_parallel__sorter sorter = {
+    .sort = sort,
+    .partition = partition,
+    .elemsz = size,
+    .threshold = QUICKSORTS__UNSTABLE_QSORT_PARALLEL__THRESHOLD,
+    .context = &context
+  };
+  if (0 < size)
+    quicksorts__unstable_qsort_parallel__run (&sorter, base, nmemb);
+}
@@ -0,0 +1,53 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+/* Turn on the statistics hooks, before any header is included. */
+#define QUICKSORTS_STATS 1
+
+#include <string.h>
+#include "quicksorts/unstable-qsort-stats.h"
+#include "quicksorts/unstable-quicksort.h"
+#include "unstable-qsort-defaults.h"
+
+#undef LT_PREDICATE
+#define LT_PREDICATE(x, y)                                      \
+  (quicksorts_common__stats->lt_calls += 1,                     \
+   (quicksorts__unstable_quicksort__compar ((x), (y)) < 0))
+
+void
+unstable_qsort_stats (void *base, size_t nmemb, size_t size,
+                      int (*quicksorts__unstable_quicksort__compar)
+                      (const void *, const void *),
+                      struct unstable_qsort_stats *stats)
+{
+  memset (stats, 0, sizeof *stats);
+  quicksorts_common__stats = stats;
+  const uint64_t t0 = quicksorts_common__stats_ns ();
+  if ((QUICKSORTS__UNSTABLE_QUICKSORT__HOLE_PARTITION_SIZE) <= size)
+    QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT
+      (quicksorts__unstable_quicksort__, base, nmemb, size,
+       LT_PREDICATE, LARGE_PIVOT_SELECTION, SMALL_SIZE_BY_ELEMSZ (size),
+       SMALL_SORT, LARGE_PARTITION);
+  else
+    QUICKSORTS__UNSTABLE_QUICKSORT__QUICKSORT_BY_SIZE
+      (quicksorts__unstable_quicksort__, base, nmemb, size,
+       LT_PREDICATE, PIVOT_SELECTION, SMALL_SIZE_BY_ELEMSZ (size),
+       SMALL_SORT, PARTITION);
+  stats->total_ns = quicksorts_common__stats_ns () - t0;
+  quicksorts_common__stats = NULL;
+}
@@ -0,0 +1,64 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#include "quicksorts/unstable-qsort.h"
+#include "quicksorts/unstable-select.h"
+
+#undef LT_PREDICATE
+#define LT_PREDICATE(x, y)                              \
+  (quicksorts__unstable_quicksort__compar               \
+   ((x), (y), quicksorts__unstable_quicksort__env) < 0)
+
+#ifndef PIVOT_SELECTION
+#define PIVOT_SELECTION QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE
+#endif
+
+#ifndef SMALL_SIZE
+#define SMALL_SIZE 80
+#endif
+
+#ifndef SMALL_SORT
+#define SMALL_SORT QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT
+#endif
+
+#ifndef PARTITION
+#define PARTITION QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_THREE_WAY
+#endif
+
+void
+unstable_nth_element_r (void *base, size_t nmemb, size_t size, size_t k,
+                        int (*quicksorts__unstable_quicksort__compar)
+                        (const void *, const void *, void *),
+                        void *quicksorts__unstable_quicksort__env)
+{
+  UNSTABLE_NTH_ELEMENT_9ARGS (base, nmemb, size, k,
+                              LT_PREDICATE, PIVOT_SELECTION,
+                              SMALL_SIZE, SMALL_SORT, PARTITION);
+}
+
+void
+unstable_partial_sort_r (void *base, size_t nmemb, size_t size,
+                         size_t k,
+                         int (*quicksorts__unstable_quicksort__compar)
+                         (const void *, const void *, void *),
+                         void *quicksorts__unstable_quicksort__env)
+{
+  UNSTABLE_PARTIAL_SORT_9ARGS (base, nmemb, size, k,
+                               LT_PREDICATE, PIVOT_SELECTION,
+                               SMALL_SIZE, SMALL_SORT, PARTITION);
+}
@@ -0,0 +1,645 @@
+/*
+  Copyright © 2022 Barry Schwartz
+
+  This program is free software: you can redistribute it and/or
+  modify it under the terms of the GNU General Public License, as
+  published by the Free Software Foundation, either version 3 of the
+  License, or (at your option) any later version.
+
+  This program is distributed in the hope that it will be useful, but
+  WITHOUT ANY WARRANTY; without even the implied warranty of
+  MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+  General Public License for more details.
+
+  You should have received copies of the GNU General Public License
+  along with this program. If not, see
+  <https://www.gnu.org/licenses/>.
+*/
+
+#include <stdatomic.h>
+#include <string.h>
+#include "quicksorts/unstable-sort-keys.h"
+#include "quicksorts/unstable-quicksort.h"
+
+#if defined __x86_64__ && (defined __clang__ || __GNUC__ >= 5)
+#define SORT_KEYS__X86 1
+#include <immintrin.h>
+#else
+#define SORT_KEYS__X86 0
+#endif
+
+/* Subarrays this small are finished by insertion sort. This must be
+   at least twice the number of elements in the widest vector. */
+#define SORT_KEYS__SMALL_SIZE 32
+
+#define SORT_KEYS__LT_int32(x, y)                       \
+  (*(const int32_t *) (x) < *(const int32_t *) (y))
+#define SORT_KEYS__LT_uint32(x, y)                      \
+  (*(const uint32_t *) (x) < *(const uint32_t *) (y))
+#define SORT_KEYS__LT_int64(x, y)                       \
+  (*(const int64_t *) (x) < *(const int64_t *) (y))
+#define SORT_KEYS__LT_uint64(x, y)                      \
+  (*(const uint64_t *) (x) < *(const uint64_t *) (y))
+#define SORT_KEYS__LT_float(x, y)                       \
+  (*(const float *) (x) < *(const float *) (y))
+#define SORT_KEYS__LT_double(x, y)                      \
+  (*(const double *) (x) < *(const double *) (y))
+
+/* Which elements go to the left side of a partition. Everything is
+   first split into elements less than the pivot and the rest. If no
+   element is less than the pivot, the elements equal to it are split
+   off instead. */
+#define SORT_KEYS__PRED_LT(x, pivot) ((x) < (pivot))
+#define SORT_KEYS__PRED_LE(x, pivot) (!((pivot) < (x)))
+
+/*------------------------------------------------------------------*/
+/* The scalar fallback.                                             */
+
+#define SORT_KEYS__DEFINE_SCALAR(NAME, T)                               \
+  static void                                                           \
+  sort_keys__scalar_##NAME (T *base, size_t nmemb)                      \
+  {                                                                     \
+    UNSTABLE_PDQSORT_TYPED_8ARGS                                        \
+      (T, base, nmemb, SORT_KEYS__LT_##NAME,                            \
+       QUICKSORTS_COMMON__PIVOT_MEDIAN_OF_THREE,                        \
+       SORT_KEYS__SMALL_SIZE,                                           \
+       QUICKSORTS__UNSTABLE_QUICKSORT__INSERTION_SORT__TYPED,           \
+       QUICKSORTS__UNSTABLE_QUICKSORT__PARTITION_BLOCK__TYPED);         \
+  }
+
+SORT_KEYS__DEFINE_SCALAR (int32, int32_t)
+SORT_KEYS__DEFINE_SCALAR (uint32, uint32_t)
+SORT_KEYS__DEFINE_SCALAR (int64, int64_t)
+SORT_KEYS__DEFINE_SCALAR (uint64, uint64_t)
+SORT_KEYS__DEFINE_SCALAR (float, float)
+SORT_KEYS__DEFINE_SCALAR (double, double)
+
+#if SORT_KEYS__X86
+
+/*------------------------------------------------------------------*/
+/* Pivot selection for the vectorized sorts: the median of three
+   elements, or, for larger subarrays, the median of three such
+   medians. The pivot is returned by value. */
+
+#define SORT_KEYS__DEFINE_PIVOT(NAME, T)                                \
+  static inline T                                                       \
+  sort_keys__median3_##NAME (T a, T b, T c)                             \
+  {                                                                     \
+    if (b < a)                                                          \
+      {                                                                 \
+        const T tmp = a;                                                \
+        a = b;                                                          \
+        b = tmp;                                                        \
+      }                                                                 \
+    if (c < b)                                                          \
+      b = (c < a) ? a : c;                                              \
+    return b;                                                           \
+  }                                                                     \
+                                                                        \
+  static inline T                                                       \
+  sort_keys__pivot_##NAME (const T *arr, size_t nmemb)                  \
+  {                                                                     \
+    T pivot;                                                            \
+    if (nmemb < 128)                                                    \
+      pivot = sort_keys__median3_##NAME                                 \
+        (arr[0], arr[nmemb >> 1], arr[nmemb - 1]);                      \
+    else                                                                \
+      {                                                                 \
+        const size_t step = (nmemb - 1) >> 3;                           \
+        pivot = sort_keys__median3_##NAME                               \
+          (sort_keys__median3_##NAME (arr[0], arr[step],                \
+                                      arr[2 * step]),                   \
+           sort_keys__median3_##NAME (arr[3 * step], arr[4 * step],     \
+                                      arr[5 * step]),                   \
+           sort_keys__median3_##NAME (arr[6 * step], arr[7 * step],     \
+                                      arr[nmemb - 1]));                 \
+      }                                                                 \
+    return pivot;                                                       \
+  }
+
+SORT_KEYS__DEFINE_PIVOT (int32, int32_t)
+SORT_KEYS__DEFINE_PIVOT (uint32, uint32_t)
+SORT_KEYS__DEFINE_PIVOT (int64, int64_t)
+SORT_KEYS__DEFINE_PIVOT (uint64, uint64_t)
+SORT_KEYS__DEFINE_PIVOT (float, float)
+SORT_KEYS__DEFINE_PIVOT (double, double)
+
+/*------------------------------------------------------------------*/
+/*
+  In-place vectorized partitioning, after Mark Blacher, Joachim
+  Giesen, Peter Sanders and Jan Wassenberg, "Vectorized and
+  performance-portable quicksort", Software: Practice and Experience,
+  52(12), 2022. https://doi.org/10.1002/spe.3142
+
+  The first and last vectors are held in registers, leaving one
+  vector's worth of free space at each end. Each further vector is
+  read from whichever end has less free space, and its two parts are
+  stored at the two write positions. The leftovers are placed one at
+  a time, and the two held vectors last of all. The number of
+  elements that went to the left is returned.
+
+  MASK gives a bit for each lane that goes to the left; STORE writes
+  a vector's left lanes at arr[write_l] and its other lanes just
+  below arr[write_r], and moves the write positions.
+*/
+#define SORT_KEYS__DEFINE_PARTITION(FN, TARGET, T, W, VEC, LOAD,       \
+                                    SPLAT, MASK, STORE, PRED)           \
+  static __attribute__ ((__target__ (TARGET))) size_t                   \
+  FN (T *arr, size_t nmemb, T pivot)                                    \
+  {                                                                     \
+    const VEC pv = SPLAT (pivot);                                       \
+    const VEC v_first = LOAD (arr);                                     \
+    const VEC v_last = LOAD (arr + (nmemb - (W)));                      \
+    size_t read_l = (W);                                                \
+    size_t read_r = nmemb - (W);                                        \
+    size_t write_l = 0;                                                 \
+    size_t write_r = nmemb;                                             \
+                                                                        \
+    while ((W) <= read_r - read_l)                                      \
+      {                                                                 \
+        VEC v;                                                          \
+        if (read_l - write_l <= write_r - read_r)                       \
+          {                                                             \
+            v = LOAD (arr + read_l);                                    \
+            read_l += (W);                                              \
+          }                                                             \
+        else                                                            \
+          {                                                             \
+            read_r -= (W);                                              \
+            v = LOAD (arr + read_r);                                    \
+          }                                                             \
+        STORE (arr, write_l, write_r, v, MASK (v, pv));                 \
+      }                                                                 \
+                                                                        \
+    T tail[(W)];                                                        \
+    const size_t n_tail = read_r - read_l;                              \
+    QUICKSORTS_COMMON__MEMCPY (tail, arr + read_l, n_tail * sizeof (T)); \
+    for (size_t i = 0; i != n_tail; i += 1)                             \
+      if (PRED (tail[i], pivot))                                        \
+        {                                                               \
+          arr[write_l] = tail[i];                                       \
+          write_l += 1;                                                 \
+        }                                                               \
+      else                                                              \
+        {                                                               \
+          write_r -= 1;                                                 \
+          arr[write_r] = tail[i];                                       \
+        }                                                               \
+                                                                        \
+    STORE (arr, write_l, write_r, v_first, MASK (v_first, pv));         \
+    STORE (arr, write_l, write_r, v_last, MASK (v_last, pv));           \
+    return write_l;                                                     \
+  }
+
+/* For the leaves, a straight insertion sort of values beats the
+   library's binary insertion sort, which is made for elements that
+   are costly to compare. */
+#define SORT_KEYS__STRAIGHT_INSERTION_SORT(T, ARR, NMEMB)               \
+  do                                                                    \
+    {                                                                   \
+      for (size_t sort_keys__i = 1; sort_keys__i < (NMEMB);             \
+           sort_keys__i += 1)                                           \
+        {                                                               \
+          const T sort_keys__x = (ARR)[sort_keys__i];                   \
+          size_t sort_keys__j = sort_keys__i;                           \
+          while (sort_keys__j != 0                                      \
+                 && sort_keys__x < (ARR)[sort_keys__j - 1])             \
+            {                                                           \
+              (ARR)[sort_keys__j] = (ARR)[sort_keys__j - 1];            \
+              sort_keys__j -= 1;                                        \
+            }                                                           \
+          (ARR)[sort_keys__j] = sort_keys__x;                           \
+        }                                                               \
+    }                                                                   \
+  while (0)
+
+/*
+  The quicksort proper. The smaller side of each partition is sorted
+  recursively, and the larger by looping. When the depth budget runs
+  out, heapsort finishes the subarray.
+*/
+#define SORT_KEYS__DEFINE_SORT(FN, TARGET, NAME, T, PARTITION_LT,      \
+                               PARTITION_LE)                            \
+  static __attribute__ ((__target__ (TARGET))) void                     \
+  FN (T *arr, size_t nmemb, int depth)                                  \
+  {                                                                     \
+    for (;;)                                                            \
+      {                                                                 \
+        if (nmemb <= SORT_KEYS__SMALL_SIZE)                             \
+          {                                                             \
+            SORT_KEYS__STRAIGHT_INSERTION_SORT (T, arr, nmemb);         \
+            return;                                                     \
+          }                                                             \
+        if (depth == 0)                                                 \
+          {                                                             \
+            QUICKSORTS__UNSTABLE_QUICKSORT__HEAP_SORT__TYPED            \
+              (sort_keys__, T, arr, nmemb, SORT_KEYS__LT_##NAME,        \
+               SORT_KEYS__SMALL_SIZE);                                  \
+            return;                                                     \
+          }                                                             \
+        depth -= 1;                                                     \
+                                                                        \
+        const T pivot = sort_keys__pivot_##NAME (arr, nmemb);           \
+        const size_t n_lt = PARTITION_LT (arr, nmemb, pivot);           \
+        if (n_lt == 0)                                                  \
+          {                                                             \
+            /* The pivot is the least element. Set aside all */         \
+            /* of its copies at once.                        */         \
+            const size_t n_le = PARTITION_LE (arr, nmemb, pivot);       \
+            arr += n_le;                                                \
+            nmemb -= n_le;                                              \
+          }                                                             \
+        else if (n_lt < nmemb - n_lt)                                   \
+          {                                                             \
+            FN (arr, n_lt, depth);                                      \
+            arr += n_lt;                                                \
+            nmemb -= n_lt;                                              \
+          }                                                             \
+        else                                                            \
+          {                                                             \
+            FN (arr + n_lt, nmemb - n_lt, depth);                       \
+            nmemb = n_lt;                                               \
+          }                                                             \
+      }                                                                 \
+  }
+
+/*------------------------------------------------------------------*/
+/* AVX2. A vector's lanes are put in order with a permutation looked
+   up by the comparison mask: the left lanes first, the others after.
+   Each table entry packs eight 32-bit lane indices into nibbles. The
+   64-bit table moves lanes in pairs of 32-bit halves. */
+
+static const uint32_t sort_keys__perm32[256] = {
+  0x76543210, 0x76543210, 0x76543201, 0x76543210,
+  0x76543102, 0x76543120, 0x76543021, 0x76543210,
+  0x76542103, 0x76542130, 0x76542031, 0x76542310,
+  0x76541032, 0x76541320, 0x76540321, 0x76543210,
+  0x76532104, 0x76532140, 0x76532041, 0x76532410,
+  0x76531042, 0x76531420, 0x76530421, 0x76534210,
+  0x76521043, 0x76521430, 0x76520431, 0x76524310,
+  0x76510432, 0x76514320, 0x76504321, 0x76543210,
+  0x76432105, 0x76432150, 0x76432051, 0x76432510,
+  0x76431052, 0x76431520, 0x76430521, 0x76435210,
+  0x76421053, 0x76421530, 0x76420531, 0x76425310,
+  0x76410532, 0x76415320, 0x76405321, 0x76453210,
+  0x76321054, 0x76321540, 0x76320541, 0x76325410,
+  0x76310542, 0x76315420, 0x76305421, 0x76354210,
+  0x76210543, 0x76215430, 0x76205431, 0x76254310,
+  0x76105432, 0x76154320, 0x76054321, 0x76543210,
+  0x75432106, 0x75432160, 0x75432061, 0x75432610,
+  0x75431062, 0x75431620, 0x75430621, 0x75436210,
+  0x75421063, 0x75421630, 0x75420631, 0x75426310,
+  0x75410632, 0x75416320, 0x75406321, 0x75463210,
+  0x75321064, 0x75321640, 0x75320641, 0x75326410,
+  0x75310642, 0x75316420, 0x75306421, 0x75364210,
+  0x75210643, 0x75216430, 0x75206431, 0x75264310,
+  0x75106432, 0x75164320, 0x75064321, 0x75643210,
+  0x74321065, 0x74321650, 0x74320651, 0x74326510,
+  0x74310652, 0x74316520, 0x74306521, 0x74365210,
+  0x74210653, 0x74216530, 0x74206531, 0x74265310,
+  0x74106532, 0x74165320, 0x74065321, 0x74653210,
+  0x73210654, 0x73216540, 0x73206541, 0x73265410,
+  0x73106542, 0x73165420, 0x73065421, 0x73654210,
+  0x72106543, 0x72165430, 0x72065431, 0x72654310,
+  0x71065432, 0x71654320, 0x70654321, 0x76543210,
+  0x65432107, 0x65432170, 0x65432071, 0x65432710,
+  0x65431072, 0x65431720, 0x65430721, 0x65437210,
+  0x65421073, 0x65421730, 0x65420731, 0x65427310,
+  0x65410732, 0x65417320, 0x65407321, 0x65473210,
+  0x65321074, 0x65321740, 0x65320741, 0x65327410,
+  0x65310742, 0x65317420, 0x65307421, 0x65374210,
+  0x65210743, 0x65217430, 0x65207431, 0x65274310,
+  0x65107432, 0x65174320, 0x65074321, 0x65743210,
+  0x64321075, 0x64321750, 0x64320751, 0x64327510,
+  0x64310752, 0x64317520, 0x64307521, 0x64375210,
+  0x64210753, 0x64217530, 0x64207531, 0x64275310,
+  0x64107532, 0x64175320, 0x64075321, 0x64753210,
+  0x63210754, 0x63217540, 0x63207541, 0x63275410,
+  0x63107542, 0x63175420, 0x63075421, 0x63754210,
+  0x62107543, 0x62175430, 0x62075431, 0x62754310,
+  0x61075432, 0x61754320, 0x60754321, 0x67543210,
+  0x54321076, 0x54321760, 0x54320761, 0x54327610,
+  0x54310762, 0x54317620, 0x54307621, 0x54376210,
+  0x54210763, 0x54217630, 0x54207631, 0x54276310,
+  0x54107632, 0x54176320, 0x54076321, 0x54763210,
+  0x53210764, 0x53217640, 0x53207641, 0x53276410,
+  0x53107642, 0x53176420, 0x53076421, 0x53764210,
+  0x52107643, 0x52176430, 0x52076431, 0x52764310,
+  0x51076432, 0x51764320, 0x50764321, 0x57643210,
+  0x43210765, 0x43217650, 0x43207651, 0x43276510,
+  0x43107652, 0x43176520, 0x43076521, 0x43765210,
+  0x42107653, 0x42176530, 0x42076531, 0x42765310,
+  0x41076532, 0x41765320, 0x40765321, 0x47653210,
+  0x32107654, 0x32176540, 0x32076541, 0x32765410,
+  0x31076542, 0x31765420, 0x30765421, 0x37654210,
+  0x21076543, 0x21765430, 0x20765431, 0x27654310,
+  0x10765432, 0x17654320, 0x07654321, 0x76543210
+};
+
+static const uint32_t sort_keys__perm64[16] = {
+  0x76543210, 0x76543210, 0x76541032, 0x76543210,
+  0x76321054, 0x76325410, 0x76105432, 0x76543210,
+  0x54321076, 0x54327610, 0x54107632, 0x54763210,
+  0x32107654, 0x32765410, 0x10765432, 0x76543210
+};
+
+#define SORT_KEYS__AVX2_LOAD(P) _mm256_loadu_si256 ((const __m256i *) (P))
+
+#define SORT_KEYS__AVX2_STORE(TABLE, W, ARR, WRITE_L, WRITE_R, V,      \
+                              MASK)                                     \
+  do                                                                    \
+    {                                                                   \
+      const unsigned int sort_keys__m = (MASK);                         \
+      const __m256i sort_keys__perm =                                   \
+        _mm256_srlv_epi32 (_mm256_set1_epi32                            \
+                           ((int) TABLE[sort_keys__m]),                 \
+                           _mm256_setr_epi32 (0, 4, 8, 12,              \
+                                              16, 20, 24, 28));         \
+      const __m256i sort_keys__v =                                      \
+        _mm256_permutevar8x32_epi32 ((V), sort_keys__perm);             \
+      const size_t sort_keys__c =                                       \
+        (size_t) __builtin_popcount (sort_keys__m);                     \
+      _mm256_storeu_si256 ((__m256i *) ((ARR) + (WRITE_L)),             \
+                           sort_keys__v);                               \
+      _mm256_storeu_si256 ((__m256i *) ((ARR) + (WRITE_R) - (W)),       \
+                           sort_keys__v);                               \
+      (WRITE_L) += sort_keys__c;                                        \
+      (WRITE_R) -= (W) - sort_keys__c;                                  \
+    }                                                                   \
+  while (0)
+
+#define SORT_KEYS__AVX2_STORE32(ARR, WRITE_L, WRITE_R, V, MASK)         \
+  SORT_KEYS__AVX2_STORE (sort_keys__perm32, 8, ARR, WRITE_L, WRITE_R,   \
+                         V, MASK)
+#define SORT_KEYS__AVX2_STORE64(ARR, WRITE_L, WRITE_R, V, MASK)         \
+  SORT_KEYS__AVX2_STORE (sort_keys__perm64, 4, ARR, WRITE_L, WRITE_R,   \
+                         V, MASK)
+
+#define SORT_KEYS__AVX2_MOVEMASK32(V)                           \
+  ((unsigned int) _mm256_movemask_ps (_mm256_castsi256_ps (V)))
+#define SORT_KEYS__AVX2_MOVEMASK64(V)                           \
+  ((unsigned int) _mm256_movemask_pd (_mm256_castsi256_pd (V)))
+
+/* Unsigned keys are compared as signed after flipping the sign
+   bit. */
+#define SORT_KEYS__AVX2_BIAS32(V)                               \
+  _mm256_xor_si256 ((V), _mm256_set1_epi32 (INT32_MIN))
+#define SORT_KEYS__AVX2_BIAS64(V)                               \
+  _mm256_xor_si256 ((V), _mm256_set1_epi64x (INT64_MIN))
+
+#define SORT_KEYS__AVX2_SPLAT_int32(X) _mm256_set1_epi32 (X)
+#define SORT_KEYS__AVX2_SPLAT_uint32(X) _mm256_set1_epi32 ((int32_t) (X))
+#define SORT_KEYS__AVX2_SPLAT_int64(X) _mm256_set1_epi64x (X)
+#define SORT_KEYS__AVX2_SPLAT_uint64(X)         \
+  _mm256_set1_epi64x ((int64_t) (X))
+#define SORT_KEYS__AVX2_SPLAT_float(X)          \
+  _mm256_castps_si256 (_mm256_set1_ps (X))
+#define SORT_KEYS__AVX2_SPLAT_double(X)         \
+  _mm256_castpd_si256 (_mm256_set1_pd (X))
+
+#define SORT_KEYS__AVX2_LT_int32(V, PV)                                 \
+  SORT_KEYS__AVX2_MOVEMASK32 (_mm256_cmpgt_epi32 ((PV), (V)))
+#define SORT_KEYS__AVX2_LE_int32(V, PV)                                 \
+  (~SORT_KEYS__AVX2_MOVEMASK32 (_mm256_cmpgt_epi32 ((V), (PV))) & 0xFFu)
+#define SORT_KEYS__AVX2_LT_uint32(V, PV)                                \
+  SORT_KEYS__AVX2_MOVEMASK32 (_mm256_cmpgt_epi32                        \
+                              (SORT_KEYS__AVX2_BIAS32 (PV),             \
+                               SORT_KEYS__AVX2_BIAS32 (V)))
+#define SORT_KEYS__AVX2_LE_uint32(V, PV)                                \
+  (~SORT_KEYS__AVX2_MOVEMASK32 (_mm256_cmpgt_epi32                      \
+                                (SORT_KEYS__AVX2_BIAS32 (V),            \
+                                 SORT_KEYS__AVX2_BIAS32 (PV))) & 0xFFu)
+#define SORT_KEYS__AVX2_LT_int64(V, PV)                                 \
+  SORT_KEYS__AVX2_MOVEMASK64 (_mm256_cmpgt_epi64 ((PV), (V)))
+#define SORT_KEYS__AVX2_LE_int64(V, PV)                                 \
+  (~SORT_KEYS__AVX2_MOVEMASK64 (_mm256_cmpgt_epi64 ((V), (PV))) & 0xFu)
+#define SORT_KEYS__AVX2_LT_uint64(V, PV)                                \
+  SORT_KEYS__AVX2_MOVEMASK64 (_mm256_cmpgt_epi64                        \
+                              (SORT_KEYS__AVX2_BIAS64 (PV),             \
+                               SORT_KEYS__AVX2_BIAS64 (V)))
+#define SORT_KEYS__AVX2_LE_uint64(V, PV)                                \
+  (~SORT_KEYS__AVX2_MOVEMASK64 (_mm256_cmpgt_epi64                      \
+                                (SORT_KEYS__AVX2_BIAS64 (V),            \
+                                 SORT_KEYS__AVX2_BIAS64 (PV))) & 0xFu)
+#define SORT_KEYS__AVX2_LT_float(V, PV)                                 \
+  ((unsigned int) _mm256_movemask_ps                                    \
+   (_mm256_cmp_ps (_mm256_castsi256_ps (V), _mm256_castsi256_ps (PV),   \
+                   _CMP_LT_OQ)))
+#define SORT_KEYS__AVX2_LE_float(V, PV)                                 \
+  ((unsigned int) _mm256_movemask_ps                                    \
+   (_mm256_cmp_ps (_mm256_castsi256_ps (PV), _mm256_castsi256_ps (V),   \
+                   _CMP_NLT_UQ)))
+#define SORT_KEYS__AVX2_LT_double(V, PV)                                \
+  ((unsigned int) _mm256_movemask_pd                                    \
+   (_mm256_cmp_pd (_mm256_castsi256_pd (V), _mm256_castsi256_pd (PV),   \
+                   _CMP_LT_OQ)))
+#define SORT_KEYS__AVX2_LE_double(V, PV)                                \
+  ((unsigned int) _mm256_movemask_pd                                    \
+   (_mm256_cmp_pd (_mm256_castsi256_pd (PV), _mm256_castsi256_pd (V),   \
+                   _CMP_NLT_UQ)))
+
+#define SORT_KEYS__DEFINE_AVX2(NAME, T, W, STORE)                       \
+  SORT_KEYS__DEFINE_PARTITION                                           \
+  (sort_keys__avx2_partition_lt_##NAME, "avx2", T, W, __m256i,          \
+   SORT_KEYS__AVX2_LOAD, SORT_KEYS__AVX2_SPLAT_##NAME,                  \
+   SORT_KEYS__AVX2_LT_##NAME, STORE, SORT_KEYS__PRED_LT)                \
+  SORT_KEYS__DEFINE_PARTITION                                           \
+  (sort_keys__avx2_partition_le_##NAME, "avx2", T, W, __m256i,          \
+   SORT_KEYS__AVX2_LOAD, SORT_KEYS__AVX2_SPLAT_##NAME,                  \
+   SORT_KEYS__AVX2_LE_##NAME, STORE, SORT_KEYS__PRED_LE)                \
+  SORT_KEYS__DEFINE_SORT                                                \
+  (sort_keys__avx2_##NAME, "avx2", NAME, T,                             \
+   sort_keys__avx2_partition_lt_##NAME,                                 \
+   sort_keys__avx2_partition_le_##NAME)
+
+SORT_KEYS__DEFINE_AVX2 (int32, int32_t, 8, SORT_KEYS__AVX2_STORE32)
+SORT_KEYS__DEFINE_AVX2 (uint32, uint32_t, 8, SORT_KEYS__AVX2_STORE32)
+SORT_KEYS__DEFINE_AVX2 (float, float, 8, SORT_KEYS__AVX2_STORE32)
+SORT_KEYS__DEFINE_AVX2 (int64, int64_t, 4, SORT_KEYS__AVX2_STORE64)
+SORT_KEYS__DEFINE_AVX2 (uint64, uint64_t, 4, SORT_KEYS__AVX2_STORE64)
+SORT_KEYS__DEFINE_AVX2 (double, double, 4, SORT_KEYS__AVX2_STORE64)
+
+/*------------------------------------------------------------------*/
+/* AVX-512. The left lanes are compressed to the bottom of a vector,
+   and the other lanes expanded above them; that vector is stored at
+   both ends, as with AVX2. (Compressing straight to memory is much
+   slower on some processors.) Only AVX-512F instructions are used. */
+
+#define SORT_KEYS__AVX512_LOAD(P) _mm512_loadu_si512 ((const void *) (P))
+
+#define SORT_KEYS__AVX512_STORE(MASK_T, W, ARRANGE, ARR, WRITE_L,       \
+                                WRITE_R, V, MASK)                       \
+  do                                                                    \
+    {                                                                   \
+      const MASK_T sort_keys__m = (MASK);                               \
+      const unsigned int sort_keys__c =                                 \
+        (unsigned int) __builtin_popcount ((unsigned int) sort_keys__m); \
+      const __m512i sort_keys__v =                                      \
+        ARRANGE (sort_keys__m, (V), sort_keys__c);                      \
+      _mm512_storeu_si512 ((void *) ((ARR) + (WRITE_L)), sort_keys__v); \
+      _mm512_storeu_si512 ((void *) ((ARR) + (WRITE_R) - (W)),          \
+                           sort_keys__v);                               \
+      (WRITE_L) += sort_keys__c;                                        \
+      (WRITE_R) -= (W) - sort_keys__c;                                  \
+    }                                                                   \
+  while (0)
+
+#define SORT_KEYS__AVX512_ARRANGE32(M, V, C)                            \
+  _mm512_mask_expand_epi32                                              \
+  (_mm512_maskz_compress_epi32 ((M), (V)),                              \
+   (__mmask16) (0xFFFFu << (C)),                                        \
+   _mm512_maskz_compress_epi32 ((__mmask16) ~(M), (V)))
+#define SORT_KEYS__AVX512_ARRANGE64(M, V, C)                            \
+  _mm512_mask_expand_epi64                                              \
+  (_mm512_maskz_compress_epi64 ((M), (V)),                              \
+   (__mmask8) (0xFFu << (C)),                                           \
+   _mm512_maskz_compress_epi64 ((__mmask8) ~(M), (V)))
+
+#define SORT_KEYS__AVX512_STORE32(ARR, WRITE_L, WRITE_R, V, MASK)       \
+  SORT_KEYS__AVX512_STORE (__mmask16, 16, SORT_KEYS__AVX512_ARRANGE32,  \
+                           ARR, WRITE_L, WRITE_R, V, MASK)
+#define SORT_KEYS__AVX512_STORE64(ARR, WRITE_L, WRITE_R, V, MASK)       \
+  SORT_KEYS__AVX512_STORE (__mmask8, 8, SORT_KEYS__AVX512_ARRANGE64,    \
+                           ARR, WRITE_L, WRITE_R, V, MASK)
+
+#define SORT_KEYS__AVX512_SPLAT_int32(X) _mm512_set1_epi32 (X)
+#define SORT_KEYS__AVX512_SPLAT_uint32(X) _mm512_set1_epi32 ((int32_t) (X))
+#define SORT_KEYS__AVX512_SPLAT_int64(X) _mm512_set1_epi64 (X)
+#define SORT_KEYS__AVX512_SPLAT_uint64(X)       \
+  _mm512_set1_epi64 ((int64_t) (X))
+#define SORT_KEYS__AVX512_SPLAT_float(X)        \
+  _mm512_castps_si512 (_mm512_set1_ps (X))
+#define SORT_KEYS__AVX512_SPLAT_double(X)       \
+  _mm512_castpd_si512 (_mm512_set1_pd (X))
+
+#define SORT_KEYS__AVX512_LT_int32(V, PV) _mm512_cmplt_epi32_mask ((V), (PV))
+#define SORT_KEYS__AVX512_LE_int32(V, PV) _mm512_cmple_epi32_mask ((V), (PV))
+#define SORT_KEYS__AVX512_LT_uint32(V, PV) _mm512_cmplt_epu32_mask ((V), (PV))
+#define SORT_KEYS__AVX512_LE_uint32(V, PV) _mm512_cmple_epu32_mask ((V), (PV))
+#define SORT_KEYS__AVX512_LT_int64(V, PV) _mm512_cmplt_epi64_mask ((V), (PV))
+#define SORT_KEYS__AVX512_LE_int64(V, PV) _mm512_cmple_epi64_mask ((V), (PV))
+#define SORT_KEYS__AVX512_LT_uint64(V, PV) _mm512_cmplt_epu64_mask ((V), (PV))
+#define SORT_KEYS__AVX512_LE_uint64(V, PV) _mm512_cmple_epu64_mask ((V), (PV))
+#define SORT_KEYS__AVX512_LT_float(V, PV)                               \
+  _mm512_cmp_ps_mask (_mm512_castsi512_ps (V), _mm512_castsi512_ps (PV), \
+                      _CMP_LT_OQ)
+#define SORT_KEYS__AVX512_LE_float(V, PV)                               \
+  _mm512_cmp_ps_mask (_mm512_castsi512_ps (PV), _mm512_castsi512_ps (V), \
+                      _CMP_NLT_UQ)
+#define SORT_KEYS__AVX512_LT_double(V, PV)                              \
+  _mm512_cmp_pd_mask (_mm512_castsi512_pd (V), _mm512_castsi512_pd (PV), \
+                      _CMP_LT_OQ)
+#define SORT_KEYS__AVX512_LE_double(V, PV)                              \
+  _mm512_cmp_pd_mask (_mm512_castsi512_pd (PV), _mm512_castsi512_pd (V), \
+                      _CMP_NLT_UQ)
+
+#define SORT_KEYS__DEFINE_AVX512(NAME, T, W, STORE)                     \
+  SORT_KEYS__DEFINE_PARTITION                                           \
+  (sort_keys__avx512_partition_lt_##NAME, "avx512f", T, W, __m512i,     \
+   SORT_KEYS__AVX512_LOAD, SORT_KEYS__AVX512_SPLAT_##NAME,              \
+   SORT_KEYS__AVX512_LT_##NAME, STORE, SORT_KEYS__PRED_LT)              \
+  SORT_KEYS__DEFINE_PARTITION                                           \
+  (sort_keys__avx512_partition_le_##NAME, "avx512f", T, W, __m512i,     \
+   SORT_KEYS__AVX512_LOAD, SORT_KEYS__AVX512_SPLAT_##NAME,              \
+   SORT_KEYS__AVX512_LE_##NAME, STORE, SORT_KEYS__PRED_LE)              \
+  SORT_KEYS__DEFINE_SORT                                                \
+  (sort_keys__avx512_##NAME, "avx512f", NAME, T,                        \
+   sort_keys__avx512_partition_lt_##NAME,                               \
+   sort_keys__avx512_partition_le_##NAME)
+
+SORT_KEYS__DEFINE_AVX512 (int32, int32_t, 16, SORT_KEYS__AVX512_STORE32)
+SORT_KEYS__DEFINE_AVX512 (uint32, uint32_t, 16, SORT_KEYS__AVX512_STORE32)
+SORT_KEYS__DEFINE_AVX512 (float, float, 16, SORT_KEYS__AVX512_STORE32)
+SORT_KEYS__DEFINE_AVX512 (int64, int64_t, 8, SORT_KEYS__AVX512_STORE64)
+SORT_KEYS__DEFINE_AVX512 (uint64, uint64_t, 8, SORT_KEYS__AVX512_STORE64)
+SORT_KEYS__DEFINE_AVX512 (double, double, 8, SORT_KEYS__AVX512_STORE64)
+
+#endif /* SORT_KEYS__X86 */
+
+/*------------------------------------------------------------------*/
+/* Runtime dispatch.                                                */
+
+enum
+{
+  SORT_KEYS__SCALAR,
+  SORT_KEYS__AVX2,
+  SORT_KEYS__AVX512
+};
+
+static atomic_int sort_keys__engine_cache = -1;
+
+static int
+sort_keys__detect_engine (void)
+{
+  int engine = SORT_KEYS__SCALAR;
+
+#if SORT_KEYS__X86
+  __builtin_cpu_init ();
+  if (__builtin_cpu_supports ("avx2"))
+    engine = SORT_KEYS__AVX2;
+  if (__builtin_cpu_supports ("avx512f"))
+    engine = SORT_KEYS__AVX512;
+#endif
+
+  const char *limit = getenv ("QUICKSORTS_SIMD");
+  if (limit != NULL)
+    {
+      if (strcmp (limit, "none") == 0)
+        engine = SORT_KEYS__SCALAR;
+      else if (strcmp (limit, "avx2") == 0 && SORT_KEYS__AVX2 < engine)
+        engine = SORT_KEYS__AVX2;
+    }
+
+  return engine;
+}
+
+static int
+sort_keys__engine (void)
+{
+  int engine = atomic_load_explicit (&sort_keys__engine_cache,
+                                     memory_order_relaxed);
+  if (engine < 0)
+    {
+      engine = sort_keys__detect_engine ();
+      atomic_store_explicit (&sort_keys__engine_cache, engine,
+                             memory_order_relaxed);
+    }
+  return engine;
+}
+
+#if SORT_KEYS__X86
+#define SORT_KEYS__DEFINE_ENTRY(NAME, T)                                \
+  void                                                                  \
+  unstable_sort_##NAME (T *base, size_t nmemb)                          \
+  {                                                                     \
+    switch (sort_keys__engine ())                                       \
+      {                                                                 \
+      case SORT_KEYS__AVX512:                                           \
+        sort_keys__avx512_##NAME                                        \
+          (base, nmemb, quicksorts_common__depth_limit (nmemb));        \
+        break;                                                          \
+      case SORT_KEYS__AVX2:                                             \
+        sort_keys__avx2_##NAME                                          \
+          (base, nmemb, quicksorts_common__depth_limit (nmemb));        \
+        break;                                                          \
+      default:                                                          \
+        sort_keys__scalar_##NAME (base, nmemb);                         \
+        break;                                                          \
+      }                                                                 \
+  }
+#else
+#define SORT_KEYS__DEFINE_ENTRY(NAME, T)                                \
+  void                                                                  \
+  unstable_sort_##NAME (T *base, size_t nmemb)                          \
+  {                                                                     \
+    (void) sort_keys__engine ();                                        \
+    sort_keys__scalar_##NAME (base, nmemb);                             \
+  }
+#endif
+
+SORT_KEYS__DEFINE_ENTRY (int32, int32_t)
+SORT_KEYS__DEFINE_ENTRY (uint32, uint32_t)
+SORT_KEYS__DEFINE_ENTRY (int64, int64_t)
+SORT_KEYS__DEFINE_ENTRY (uint64, uint64_t)
+SORT_KEYS__DEFINE_ENTRY (float, float)
+SORT_KEYS__DEFINE_ENTRY (double, double)